@@ -0,0 +1,160 @@
+// "我的活动" 接口（/club/activity/all_by_user）的延迟基准。
+//
+// 为一个新用户逐步加入 1、5、10、20、40 个社团（每个社团若干活动，
+// 其中一半已报名），每一档测量接口延迟。接口是单条集合查询，
+// 延迟应基本不随社团数增长。
+//
+// 用法：
+//   activity_feed_bench [server_url] [db_conn_info] [iterations]
+// 默认：
+//   http://127.0.0.1:5555
+//   "host=127.0.0.1 port=3306 dbname=club_management_system user=root"
+//   200
+//
+// 运行前需先启动 club_backend。测试数据以 bench_feed_<时间戳> 为前缀写入库中。
+
+#include <drogon/HttpClient.h>
+#include <drogon/orm/DbClient.h>
+#include <trantor/net/EventLoopThread.h>
+#include <trantor/utils/Date.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace drogon;
+
+namespace {
+
+constexpr int kActivitiesPerClub = 8;
+const std::vector<int> kMembershipSteps{1, 5, 10, 20, 40};
+
+double percentile(std::vector<double> samples, double p) {
+  if (samples.empty()) {
+    return 0;
+  }
+  std::sort(samples.begin(), samples.end());
+  auto idx = static_cast<size_t>(p * (samples.size() - 1));
+  return samples[idx];
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::string serverUrl = argc > 1 ? argv[1] : "http://127.0.0.1:5555";
+  std::string connInfo =
+      argc > 2 ? argv[2]
+               : "host=127.0.0.1 port=3306 dbname=club_management_system "
+                 "user=root";
+  int iterations = argc > 3 ? std::stoi(argv[3]) : 200;
+
+  auto db = orm::DbClient::newMysqlClient(connInfo, 1);
+  std::string prefix =
+      "bench_feed_" +
+      std::to_string(trantor::Date::now().microSecondsSinceEpoch());
+  std::string username = prefix + "_user";
+  std::string password = "bench_password";
+
+  // 准备测试用户、社团和活动
+  int userId = 0;
+  std::vector<int> clubIds;
+  try {
+    auto userResult = db->execSqlSync(
+        "INSERT INTO user (username, password, user_type) VALUES (?, ?, '社员')",
+        username, password);
+    userId = static_cast<int>(userResult.insertId());
+
+    for (int i = 0; i < kMembershipSteps.back(); ++i) {
+      auto clubResult = db->execSqlSync(
+          "INSERT INTO club (club_name, club_introduction, founder_id) "
+          "VALUES (?, '', ?)",
+          prefix + "_club_" + std::to_string(i), userId);
+      int clubId = static_cast<int>(clubResult.insertId());
+      clubIds.push_back(clubId);
+
+      for (int j = 0; j < kActivitiesPerClub; ++j) {
+        auto activityResult = db->execSqlSync(
+            "INSERT INTO club_activity (club_id, activity_title, "
+            "activity_time, activity_location, activity_description, "
+            "publish_time) VALUES (?, ?, NOW(), '', '', NOW())",
+            clubId, prefix + "_activity_" + std::to_string(j));
+        if (j % 2 == 0) {
+          db->execSqlSync("INSERT INTO activity_registration (user_id, "
+                          "activity_id, registration_date, "
+                          "registration_status) VALUES (?, ?, NOW(), "
+                          "'pending')",
+                          userId,
+                          static_cast<int>(activityResult.insertId()));
+        }
+      }
+    }
+  } catch (const orm::DrogonDbException &e) {
+    std::cerr << "seed failed: " << e.base().what() << std::endl;
+    return 1;
+  }
+
+  trantor::EventLoopThread loopThread;
+  loopThread.run();
+  auto client = HttpClient::newHttpClient(serverUrl, loopThread.getLoop());
+  client->enableCookies();
+
+  Json::Value credentials;
+  credentials["username"] = username;
+  credentials["password"] = password;
+  auto loginReq = HttpRequest::newHttpJsonRequest(credentials);
+  loginReq->setMethod(Post);
+  loginReq->setPath("/user/login");
+  auto [loginResult, loginResp] = client->sendRequest(loginReq);
+  if (loginResult != ReqResult::Ok || loginResp->statusCode() != k200OK) {
+    std::cerr << "login failed" << std::endl;
+    return 1;
+  }
+
+  std::printf("%8s %10s %10s %10s %10s\n", "clubs", "activities", "mean_ms",
+              "p50_ms", "p95_ms");
+
+  size_t joined = 0;
+  for (int step : kMembershipSteps) {
+    for (; joined < static_cast<size_t>(step); ++joined) {
+      db->execSqlSync("INSERT INTO club_member (user_id, club_id, join_date, "
+                      "member_role) VALUES (?, ?, NOW(), '社员')",
+                      userId, clubIds[joined]);
+    }
+
+    std::vector<double> samples;
+    samples.reserve(iterations);
+    Json::ArrayIndex activityCount = 0;
+    for (int i = 0; i < iterations; ++i) {
+      auto req = HttpRequest::newHttpRequest();
+      req->setMethod(Get);
+      req->setPath("/club/activity/all_by_user");
+
+      auto start = std::chrono::steady_clock::now();
+      auto [result, resp] = client->sendRequest(req);
+      auto elapsed = std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+      if (result != ReqResult::Ok || resp->statusCode() != k200OK) {
+        std::cerr << "request failed at step " << step << std::endl;
+        return 1;
+      }
+      samples.push_back(elapsed);
+      if (i == 0 && resp->getJsonObject()) {
+        activityCount = (*resp->getJsonObject())["activities"].size();
+      }
+    }
+
+    double mean = 0;
+    for (double s : samples) {
+      mean += s;
+    }
+    mean /= samples.size();
+    std::printf("%8d %10u %10.3f %10.3f %10.3f\n", step, activityCount, mean,
+                percentile(samples, 0.50), percentile(samples, 0.95));
+  }
+
+  return 0;
+}
@@ -0,0 +1,454 @@
+// HTTP 压测：按流量组合对运行中的服务发请求，报告各接口吞吐与延迟分位数。
+//
+// 组合：
+//   login_storm  全部为登录，模拟开放报名前的集中登录
+//   event_day    活动当天：签到为主，夹杂活动列表和社团详情
+//   browse       日常浏览：社团列表、社团详情、活动列表、我的活动
+//
+// 用法：
+//   load_mix_bench <mix> [server_url] [db_conn_info] [duration_s]
+//                  [concurrency] [output_json] [activities]
+// 默认：
+//   http://127.0.0.1:5555
+//   "host=127.0.0.1 port=3306 dbname=club_management_system user=root"
+//   30
+//   32
+//   load_mix_<mix>.json
+//   2000
+//
+// 运行前需先启动 club_backend。测试数据以 bench_mix_<时间戳> 为前缀：
+// concurrency 个用户，一个社团，activities 个活动，
+// 每个用户都是社员并已报名（accepted）全部活动。
+// 社团与活动经 /club/create、/activity/create 创建，服务端的社团目录、
+// 搜索索引与活动日历随之更新；用户、成员与报名直接写库，
+// 这些数据只在签到时按需加载，测量的接口不依赖启动时的快照。
+// 每个并发连接是一个独立用户，持有自己的 Cookie，按顺序签到各个活动，
+// 每次签到都是新记录；活动用完后该连接不再签到，并在结果中计数，
+// 此时应加大 activities。
+// 输出 JSON 中每个接口给出请求数、每秒请求数、2xx 响应的 p50 / p95 / p99（毫秒），
+// 以及 2xx、4xx、503（降级）和其他失败的次数，便于在不同构建之间对比。
+
+#include <drogon/HttpClient.h>
+#include <drogon/orm/DbClient.h>
+#include <json/json.h>
+#include <trantor/net/EventLoopThreadPool.h>
+#include <trantor/utils/Date.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace drogon;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kDefaultActivities = 2000;
+constexpr const char *kPassword = "bench_password";
+
+enum class Route { Login, Checkin, ClubList, ClubDetail, ActivityList, MyActivities };
+
+// 输出中使用路由模板作为接口名，路径参数不展开
+constexpr const char *kRouteNames[] = {
+    "POST /user/login",        "POST /activity/checkin",
+    "GET /club/list",          "GET /club/detail/{1}",
+    "GET /activity/list/{1}",  "GET /club/activity/all_by_user",
+};
+constexpr size_t kRouteCount = std::size(kRouteNames);
+
+struct Mix {
+  const char *name;
+  std::vector<std::pair<Route, int>> weights;
+};
+
+const std::vector<Mix> kMixes{
+    {"login_storm", {{Route::Login, 1}}},
+    {"event_day",
+     {{Route::Checkin, 70}, {Route::ActivityList, 20}, {Route::ClubDetail, 10}}},
+    {"browse",
+     {{Route::ClubList, 40},
+      {Route::ClubDetail, 30},
+      {Route::ActivityList, 20},
+      {Route::MyActivities, 10}}},
+};
+
+struct Seed {
+  std::vector<std::string> usernames;
+  int clubId = 0;
+  std::vector<int> activityIds;
+};
+
+struct RouteStats {
+  std::vector<double> samples; // 只记 2xx 的耗时
+  size_t ok = 0;
+  size_t clientErrors = 0;
+  size_t shed = 0;
+  size_t failures = 0;
+};
+
+double percentile(std::vector<double> &samples, double p) {
+  if (samples.empty()) {
+    return 0;
+  }
+  auto idx = static_cast<size_t>(p * (samples.size() - 1));
+  std::nth_element(samples.begin(), samples.begin() + idx, samples.end());
+  return samples[idx];
+}
+
+HttpRequestPtr loginRequest(const std::string &username) {
+  Json::Value credentials;
+  credentials["username"] = username;
+  credentials["password"] = kPassword;
+  auto req = HttpRequest::newHttpJsonRequest(credentials);
+  req->setMethod(Post);
+  req->setPath("/user/login");
+  return req;
+}
+
+// 发送一个 JSON 请求，失败或响应带 error 时抛出 std::runtime_error
+void post(const HttpClientPtr &client, const std::string &path,
+          const Json::Value &body) {
+  auto req = HttpRequest::newHttpJsonRequest(body);
+  req->setMethod(Post);
+  req->setPath(path);
+  auto [result, resp] = client->sendRequest(req);
+  if (result != ReqResult::Ok) {
+    throw std::runtime_error(path + ": request failed");
+  }
+  auto json = resp->getJsonObject();
+  if (resp->statusCode() != k200OK || !json || json->isMember("error")) {
+    throw std::runtime_error(path + ": " + std::string(resp->body()));
+  }
+}
+
+Seed seed(const orm::DbClientPtr &db, const HttpClientPtr &client,
+          const std::string &prefix, int users, int activities) {
+  Seed out;
+  for (int i = 0; i < users; ++i) {
+    out.usernames.push_back(prefix + "_user_" + std::to_string(i));
+    db->execSqlSync(
+        "INSERT INTO user (username, password, user_type) VALUES (?, ?, '社员')",
+        out.usernames.back(), std::string(kPassword));
+  }
+  auto founder = db->execSqlSync(
+      "SELECT user_id FROM user WHERE username = ?", out.usernames.front());
+
+  // 社团和活动经接口创建，服务端的内存快照与直接写库时不同，会包含它们
+  Json::Value club;
+  club["club_name"] = prefix + "_club";
+  club["founder_id"] = founder[0]["user_id"].as<int>();
+  post(client, "/club/create", club);
+  auto clubRow = db->execSqlSync("SELECT club_id FROM club WHERE club_name = ?",
+                                 prefix + "_club");
+  out.clubId = clubRow[0]["club_id"].as<int>();
+
+  auto [result, resp] = client->sendRequest(loginRequest(out.usernames.front()));
+  if (result != ReqResult::Ok || resp->statusCode() != k200OK) {
+    throw std::runtime_error("founder login failed");
+  }
+  auto now = trantor::Date::now().roundSecond().toDbStringLocal();
+  for (int i = 0; i < activities; ++i) {
+    Json::Value activity;
+    activity["club_id"] = out.clubId;
+    activity["activity_title"] = prefix + "_activity_" + std::to_string(i);
+    activity["activity_time"] = now;
+    post(client, "/activity/create", activity);
+  }
+  auto activityRows = db->execSqlSync(
+      "SELECT activity_id FROM club_activity WHERE club_id = ? "
+      "ORDER BY activity_id",
+      out.clubId);
+  for (const auto &row : activityRows) {
+    out.activityIds.push_back(row["activity_id"].as<int>());
+  }
+
+  std::string pattern = prefix + "\\_user\\_%";
+  db->execSqlSync("INSERT INTO club_member (user_id, club_id, join_date, "
+                  "member_role) SELECT user_id, ?, NOW(), '社员' FROM user "
+                  "WHERE username LIKE ?",
+                  out.clubId, pattern);
+  db->execSqlSync("INSERT INTO activity_registration (user_id, activity_id, "
+                  "registration_date, registration_status) "
+                  "SELECT u.user_id, a.activity_id, NOW(), 'accepted' "
+                  "FROM user u JOIN club_activity a ON a.club_id = ? "
+                  "WHERE u.username LIKE ?",
+                  out.clubId, pattern);
+  return out;
+}
+
+// 一个并发连接：固定一个用户，按权重随机选择接口，直到截止时间
+class Worker {
+public:
+  Worker(const std::string &serverUrl, trantor::EventLoop *loop,
+         const Seed &seed, const std::string &username, const Mix &mix,
+         unsigned rngSeed)
+      : client_(HttpClient::newHttpClient(serverUrl, loop)), seed_(seed),
+        username_(username), mix_(mix), rng_(rngSeed),
+        stats_(kRouteCount) {
+    client_->enableCookies();
+    for (const auto &[route, weight] : mix.weights) {
+      totalWeight_ += weight;
+    }
+  }
+
+  bool login() {
+    auto [result, resp] = client_->sendRequest(loginRequest(username_));
+    return result == ReqResult::Ok && resp->statusCode() == k200OK;
+  }
+
+  void run(Clock::time_point deadline) {
+    while (Clock::now() < deadline) {
+      auto route = pick();
+      if (route == Route::Checkin &&
+          nextActivity_ == seed_.activityIds.size()) {
+        ++checkinsExhausted_;
+        continue;
+      }
+      auto req = build(route);
+      auto start = Clock::now();
+      auto [result, resp] = client_->sendRequest(req);
+      double elapsed =
+          std::chrono::duration<double, std::milli>(Clock::now() - start)
+              .count();
+
+      auto &stats = stats_[static_cast<size_t>(route)];
+      if (result != ReqResult::Ok) {
+        ++stats.failures;
+        continue;
+      }
+      // 错误响应走的是另一条路径，不计入延迟分位数
+      auto status = static_cast<int>(resp->statusCode());
+      if (status == k503ServiceUnavailable) {
+        ++stats.shed;
+      } else if (status >= 200 && status < 300) {
+        ++stats.ok;
+        stats.samples.push_back(elapsed);
+      } else if (status >= 400 && status < 500) {
+        ++stats.clientErrors;
+      } else {
+        ++stats.failures;
+      }
+    }
+  }
+
+  const std::vector<RouteStats> &stats() const { return stats_; }
+  // 活动用完后未发出的签到次数
+  size_t checkinsExhausted() const { return checkinsExhausted_; }
+
+private:
+  Route pick() {
+    int roll = std::uniform_int_distribution<int>(0, totalWeight_ - 1)(rng_);
+    for (const auto &[route, weight] : mix_.weights) {
+      if (roll < weight) {
+        return route;
+      }
+      roll -= weight;
+    }
+    return mix_.weights.back().first;
+  }
+
+  HttpRequestPtr build(Route route) {
+    if (route == Route::Login) {
+      return loginRequest(username_);
+    }
+    if (route == Route::Checkin) {
+      Json::Value body;
+      body["activity_id"] = seed_.activityIds[nextActivity_++];
+      auto req = HttpRequest::newHttpJsonRequest(body);
+      req->setMethod(Post);
+      req->setPath("/activity/checkin");
+      return req;
+    }
+
+    auto req = HttpRequest::newHttpRequest();
+    req->setMethod(Get);
+    switch (route) {
+    case Route::ClubList:
+      req->setPath("/club/list");
+      break;
+    case Route::ClubDetail:
+      req->setPath("/club/detail/" + std::to_string(seed_.clubId));
+      break;
+    case Route::ActivityList:
+      req->setPath("/activity/list/" + std::to_string(seed_.clubId));
+      break;
+    default:
+      req->setPath("/club/activity/all_by_user");
+      break;
+    }
+    return req;
+  }
+
+  HttpClientPtr client_;
+  const Seed &seed_;
+  std::string username_;
+  const Mix &mix_;
+  std::mt19937 rng_;
+  int totalWeight_ = 0;
+  size_t nextActivity_ = 0;
+  size_t checkinsExhausted_ = 0;
+  std::vector<RouteStats> stats_;
+};
+
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "usage: load_mix_bench <login_storm|event_day|browse> "
+                 "[server_url] [db_conn_info] [duration_s] [concurrency] "
+                 "[output_json] [activities]"
+              << std::endl;
+    return 1;
+  }
+  std::string mixName = argv[1];
+  auto mix = std::find_if(kMixes.begin(), kMixes.end(),
+                          [&](const Mix &m) { return mixName == m.name; });
+  if (mix == kMixes.end()) {
+    std::cerr << "unknown mix: " << mixName << std::endl;
+    return 1;
+  }
+  std::string serverUrl = argc > 2 ? argv[2] : "http://127.0.0.1:5555";
+  std::string connInfo =
+      argc > 3 ? argv[3]
+               : "host=127.0.0.1 port=3306 dbname=club_management_system "
+                 "user=root";
+  double duration = argc > 4 ? std::stod(argv[4]) : 30;
+  int concurrency = argc > 5 ? std::stoi(argv[5]) : 32;
+  std::string outputPath =
+      argc > 6 ? argv[6] : "load_mix_" + mixName + ".json";
+  int activities = argc > 7 ? std::stoi(argv[7]) : kDefaultActivities;
+
+  trantor::EventLoopThreadPool loops(
+      std::max(1u, std::min(std::thread::hardware_concurrency(), 8u)));
+  loops.start();
+
+  auto db = orm::DbClient::newMysqlClient(connInfo, 1);
+  std::string prefix =
+      "bench_mix_" +
+      std::to_string(trantor::Date::now().microSecondsSinceEpoch());
+  Seed data;
+  try {
+    auto client = HttpClient::newHttpClient(serverUrl, loops.getNextLoop());
+    client->enableCookies();
+    data = seed(db, client, prefix, concurrency, activities);
+  } catch (const orm::DrogonDbException &e) {
+    std::cerr << "seed failed: " << e.base().what() << std::endl;
+    return 1;
+  } catch (const std::runtime_error &e) {
+    std::cerr << "seed failed: " << e.what() << std::endl;
+    return 1;
+  }
+
+  std::vector<std::unique_ptr<Worker>> workers;
+  for (int i = 0; i < concurrency; ++i) {
+    workers.push_back(std::make_unique<Worker>(
+        serverUrl, loops.getNextLoop(), data,
+        data.usernames[i], *mix,
+        static_cast<unsigned>(i + 1)));
+    // 登录组合本身就在测登录，其余组合先登录再开始计时
+    if (mix->weights.front().first != Route::Login && !workers.back()->login()) {
+      std::cerr << "login failed for worker " << i << std::endl;
+      return 1;
+    }
+  }
+
+  auto start = Clock::now();
+  auto deadline =
+      start + std::chrono::duration_cast<Clock::duration>(
+                  std::chrono::duration<double>(duration));
+  std::vector<std::thread> threads;
+  for (auto &worker : workers) {
+    threads.emplace_back([&worker, deadline]() { worker->run(deadline); });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  double elapsed =
+      std::chrono::duration<double>(Clock::now() - start).count();
+
+  // 合并各连接的统计
+  std::vector<RouteStats> merged(kRouteCount);
+  size_t exhausted = 0;
+  for (const auto &worker : workers) {
+    exhausted += worker->checkinsExhausted();
+    for (size_t r = 0; r < kRouteCount; ++r) {
+      const auto &from = worker->stats()[r];
+      auto &to = merged[r];
+      to.samples.insert(to.samples.end(), from.samples.begin(),
+                        from.samples.end());
+      to.ok += from.ok;
+      to.clientErrors += from.clientErrors;
+      to.shed += from.shed;
+      to.failures += from.failures;
+    }
+  }
+
+  Json::Value report;
+  report["mix"] = mixName;
+  report["server"] = serverUrl;
+  report["duration_s"] = elapsed;
+  report["concurrency"] = concurrency;
+  report["activities"] = activities;
+  report["checkins_exhausted"] = static_cast<Json::UInt64>(exhausted);
+  Json::UInt64 total = 0;
+
+  std::printf("%-34s %8s %9s %9s %9s %9s %6s %6s\n", "route", "requests",
+              "rps", "p50_ms", "p95_ms", "p99_ms", "4xx", "503");
+  for (size_t r = 0; r < kRouteCount; ++r) {
+    auto &stats = merged[r];
+    auto requests =
+        stats.ok + stats.clientErrors + stats.shed + stats.failures;
+    if (requests == 0) {
+      continue;
+    }
+    total += requests;
+    Json::Value route;
+    route["requests"] = static_cast<Json::UInt64>(requests);
+    route["rps"] = requests / elapsed;
+    route["p50_ms"] = percentile(stats.samples, 0.50);
+    route["p95_ms"] = percentile(stats.samples, 0.95);
+    route["p99_ms"] = percentile(stats.samples, 0.99);
+    route["ok"] = static_cast<Json::UInt64>(stats.ok);
+    route["client_errors"] = static_cast<Json::UInt64>(stats.clientErrors);
+    route["shed"] = static_cast<Json::UInt64>(stats.shed);
+    route["failures"] = static_cast<Json::UInt64>(stats.failures);
+    report["routes"][kRouteNames[r]] = route;
+
+    std::printf("%-34s %8zu %9.1f %9.3f %9.3f %9.3f %6zu %6zu\n",
+                kRouteNames[r], static_cast<size_t>(requests),
+                route["rps"].asDouble(), route["p50_ms"].asDouble(),
+                route["p95_ms"].asDouble(), route["p99_ms"].asDouble(),
+                stats.clientErrors, stats.shed);
+  }
+  report["total_requests"] = total;
+  report["throughput_rps"] = total / elapsed;
+  std::printf("total %llu requests, %.1f rps\n",
+              static_cast<unsigned long long>(total), total / elapsed);
+  if (exhausted > 0) {
+    std::printf("warning: %zu check-ins skipped after all %d activities were "
+                "used, rerun with more activities\n",
+                exhausted, activities);
+  }
+
+  std::ofstream out(outputPath);
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "  ";
+  builder["emitUTF8"] = true;
+  out << Json::writeString(builder, report) << std::endl;
+  if (!out) {
+    std::cerr << "failed to write " << outputPath << std::endl;
+    return 1;
+  }
+  std::printf("report written to %s\n", outputPath.c_str());
+  return 0;
+}
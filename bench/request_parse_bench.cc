@@ -0,0 +1,183 @@
+// 请求体解析的微基准：common::parseRequest 对比 getJsonObject + isMember。
+//
+// 不需要数据库和服务。每次解析都新建一个 HttpRequest，
+// 因为 getJsonObject() 会把解析结果缓存在请求对象上。
+// 旧写法一侧与 fromRequest 原来的逐字段解析相同（复制在下方）。
+//
+// 用法：
+//   request_parse_bench [iterations] [batch]
+// 默认：
+//   200
+//   1000
+// 每轮解析 batch 次，报告每次解析耗时（纳秒）的 p50 / p95。
+
+#include "controllers/ClubActivityController.h"
+#include "controllers/UserController.h"
+#include <drogon/HttpRequest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace drogon;
+
+namespace {
+
+const char *kUserBody =
+    R"({"username":"zhangsan","password":"secret123",)"
+    R"("email":"zhangsan@example.com","phone":"13800000000",)"
+    R"("user_type":"社员"})";
+
+const char *kActivityBody =
+    R"({"activity_title":"春季读书分享会","activity_time":"2024-04-20 14:00:00",)"
+    R"("activity_location":"图书馆二楼报告厅","registration_method":"线上报名",)"
+    R"("activity_description":"每位参与者推荐一本近期读过的书，并分享读书心得。)"
+    R"(活动结束后有茶歇。","club_id":12})";
+
+HttpRequestPtr newJsonRequest(const char *body) {
+  auto req = HttpRequest::newHttpRequest();
+  req->setMethod(Post);
+  req->setContentTypeCode(CT_APPLICATION_JSON);
+  req->setBody(body);
+  return req;
+}
+
+// ---- 旧写法：先构建 Json::Value，再逐字段 isMember / asString ----
+
+User legacyUser(const HttpRequest &req) {
+  auto json = req.getJsonObject();
+  User value;
+  if (json == nullptr) {
+    throw std::runtime_error("请求体格式错误，请使用 JSON");
+  }
+  if (json->isMember("username")) {
+    const auto &temp = (*json)["username"].asString();
+    if (temp.size() < 3) {
+      throw std::runtime_error("用户名长度过短");
+    }
+    value.username = temp;
+  } else {
+    throw std::runtime_error("缺少必备字段: username");
+  }
+  if (json->isMember("password")) {
+    const auto &temp = (*json)["password"].asString();
+    if (temp.size() < 6) {
+      throw std::runtime_error("密码长度过短");
+    }
+    value.password = temp;
+  } else {
+    throw std::runtime_error("缺少必备字段: password");
+  }
+  value.email = json->isMember("email") ? (*json)["email"].asString() : "";
+  value.phone = json->isMember("phone") ? (*json)["phone"].asString() : "";
+  if (json->isMember("user_type")) {
+    const auto &temp = (*json)["user_type"].asString();
+    if (temp != "社员" && temp != "社长" && temp != "管理员") {
+      throw std::runtime_error("用户类型无效");
+    }
+    value.user_type = temp;
+  } else {
+    value.user_type = "社员";
+  }
+  return value;
+}
+
+ClubActivity legacyActivity(const HttpRequest &req) {
+  auto json = req.getJsonObject();
+  ClubActivity value;
+  if (json == nullptr) {
+    throw std::runtime_error("请求体格式错误，请使用 JSON");
+  }
+  if (json->isMember("activity_title")) {
+    const auto &temp = (*json)["activity_title"].asString();
+    if (temp.empty()) {
+      throw std::runtime_error("活动标题不能为空");
+    }
+    value.activity_title = temp;
+  } else {
+    throw std::runtime_error("缺少必备字段: activity_title");
+  }
+  if (json->isMember("activity_time")) {
+    const auto &temp = (*json)["activity_time"].asString();
+    if (temp.empty()) {
+      throw std::runtime_error("活动时间不能为空");
+    }
+    value.activity_time = trantor::Date::fromDbStringLocal(temp);
+  } else {
+    throw std::runtime_error("缺少必备字段: activity_time");
+  }
+  value.activity_location = json->get("activity_location", "").asString();
+  value.registration_method = json->get("registration_method", "").asString();
+  value.activity_description = json->get("activity_description", "").asString();
+  if (json->isMember("club_id")) {
+    value.club_id = (*json)["club_id"].asInt();
+  } else {
+    throw std::runtime_error("缺少必备字段: club_id");
+  }
+  return value;
+}
+
+// ------------------------------------------------------------------
+
+double percentile(std::vector<double> samples, double p) {
+  std::sort(samples.begin(), samples.end());
+  return samples[static_cast<size_t>(p * (samples.size() - 1))];
+}
+
+// 运行 iterations 轮，每轮解析 batch 次，打印每次解析耗时的 p50 / p95
+void run(const char *name, int iterations, int batch, const char *body,
+         const std::function<size_t(const HttpRequest &)> &parse) {
+  std::vector<HttpRequestPtr> requests(batch);
+  std::vector<double> samples;
+  samples.reserve(iterations);
+  size_t checksum = 0;
+  for (int i = 0; i < iterations; ++i) {
+    // 请求对象在计时外创建，只比较解析本身
+    for (auto &req : requests) {
+      req = newJsonRequest(body);
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &req : requests) {
+      checksum += parse(*req);
+    }
+    samples.push_back(std::chrono::duration<double, std::nano>(
+                          std::chrono::steady_clock::now() - start)
+                          .count() /
+                      batch);
+  }
+  std::printf("%-28s %12.1f %12.1f %12zu\n", name, percentile(samples, 0.50),
+              percentile(samples, 0.95), checksum);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  int iterations = argc > 1 ? std::stoi(argv[1]) : 200;
+  int batch = argc > 2 ? std::stoi(argv[2]) : 1000;
+
+  std::printf("iterations=%d batch=%d\n", iterations, batch);
+  std::printf("%-28s %12s %12s %12s\n", "case", "p50_ns", "p95_ns",
+              "checksum");
+
+  run("user/jsoncpp", iterations, batch, kUserBody,
+      [](const HttpRequest &req) { return legacyUser(req).username.size(); });
+  run("user/parseRequest", iterations, batch, kUserBody,
+      [](const HttpRequest &req) {
+        return common::parseRequest<User>(req).username.size();
+      });
+
+  run("activity/jsoncpp", iterations, batch, kActivityBody,
+      [](const HttpRequest &req) {
+        return legacyActivity(req).activity_description.size();
+      });
+  run("activity/parseRequest", iterations, batch, kActivityBody,
+      [](const HttpRequest &req) {
+        return common::parseRequest<ClubActivity>(req)
+            .activity_description.size();
+      });
+
+  return 0;
+}
@@ -0,0 +1,151 @@
+// 行序列化的微基准：common::RowSerializer 对比 Json::Value + jsoncpp。
+//
+// 用递归 CTE 在 MySQL 中生成成员行和签到行（不写入任何表），
+// 然后在进程内反复序列化同一个结果集，比较两种方式每轮的耗时与输出大小。
+// jsoncpp 一侧与处理函数原来的写法相同：逐字段 as<T>() 构建 Json::Value，
+// 再用 StreamWriterBuilder 输出（非 ASCII 字符会被转义，输出字节数更大）。
+//
+// 用法：
+//   row_json_bench [db_conn_info] [rows] [iterations]
+// 默认：
+//   "host=127.0.0.1 port=3306 dbname=club_management_system user=root"
+//   1000
+//   200
+
+#include "common/RowJson.h"
+#include <drogon/orm/DbClient.h>
+#include <json/writer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace drogon;
+
+namespace {
+
+const char *kMemberRowsSql =
+    "WITH RECURSIVE seq(n) AS (SELECT 1 UNION ALL SELECT n + 1 FROM seq "
+    "WHERE n < ?) "
+    "SELECT n AS member_id, n + 100000 AS user_id, "
+    "CONCAT('社员_', n) AS username, "
+    "IF(n % 3 = 0, NULL, CONCAT('user', n, '@example.com')) AS email, "
+    "CONCAT('138', LPAD(n, 8, '0')) AS phone, "
+    "IF(n % 20 = 0, '社长', '社员') AS member_role FROM seq";
+
+const char *kCheckinRowsSql =
+    "WITH RECURSIVE seq(n) AS (SELECT 1 UNION ALL SELECT n + 1 FROM seq "
+    "WHERE n < ?) "
+    "SELECT n AS checkin_id, n + 100000 AS user_id, "
+    "NOW() - INTERVAL n MINUTE AS checkin_time FROM seq";
+
+double percentile(std::vector<double> samples, double p) {
+  std::sort(samples.begin(), samples.end());
+  return samples[static_cast<size_t>(p * (samples.size() - 1))];
+}
+
+// 运行 iterations 轮，打印每轮耗时的 p50 / p95 以及输出字节数
+void run(const char *name, int iterations,
+         const std::function<size_t()> &serialize) {
+  std::vector<double> samples;
+  samples.reserve(iterations);
+  size_t bytes = 0;
+  for (int i = 0; i < iterations; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    bytes = serialize();
+    samples.push_back(std::chrono::duration<double, std::micro>(
+                          std::chrono::steady_clock::now() - start)
+                          .count());
+  }
+  std::printf("%-28s %12.1f %12.1f %12zu\n", name, percentile(samples, 0.50),
+              percentile(samples, 0.95), bytes);
+}
+
+std::string writeJson(const Json::Value &value) {
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "";
+  return Json::writeString(builder, value);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::string connInfo =
+      argc > 1 ? argv[1]
+               : "host=127.0.0.1 port=3306 dbname=club_management_system "
+                 "user=root";
+  int rows = argc > 2 ? std::stoi(argv[2]) : 1000;
+  int iterations = argc > 3 ? std::stoi(argv[3]) : 200;
+
+  auto db = orm::DbClient::newMysqlClient(connInfo, 1);
+  orm::Result members{nullptr};
+  orm::Result checkins{nullptr};
+  try {
+    db->execSqlSync("SET SESSION cte_max_recursion_depth = ?", rows + 1);
+    members = db->execSqlSync(kMemberRowsSql, rows);
+    checkins = db->execSqlSync(kCheckinRowsSql, rows);
+  } catch (const orm::DrogonDbException &e) {
+    std::cerr << "query failed: " << e.base().what() << std::endl;
+    return 1;
+  }
+
+  std::printf("rows=%d iterations=%d\n", rows, iterations);
+  std::printf("%-28s %12s %12s %12s\n", "case", "p50_us", "p95_us", "bytes");
+
+  run("members/jsoncpp", iterations, [&]() {
+    Json::Value list(Json::arrayValue);
+    for (const auto &row : members) {
+      Json::Value member;
+      member["member_id"] = row["member_id"].as<int>();
+      member["user_id"] = row["user_id"].as<int>();
+      member["username"] = row["username"].as<std::string>();
+      member["email"] =
+          row["email"].isNull() ? "" : row["email"].as<std::string>();
+      member["phone"] =
+          row["phone"].isNull() ? "" : row["phone"].as<std::string>();
+      member["member_role"] = row["member_role"].as<std::string>();
+      list.append(member);
+    }
+    Json::Value response;
+    response["members"] = list;
+    return writeJson(response).size();
+  });
+
+  run("members/RowSerializer", iterations, [&]() {
+    auto &body = common::jsonBuffer();
+    body += "{\"members\":";
+    common::RowSerializer<common::MemberRow>(members).writeArray(
+        members, members.size(), body);
+    body += '}';
+    return body.size();
+  });
+
+  run("checkins/jsoncpp", iterations, [&]() {
+    Json::Value list(Json::arrayValue);
+    for (const auto &row : checkins) {
+      Json::Value checkin;
+      checkin["checkin_id"] = row["checkin_id"].as<int>();
+      checkin["user_id"] = row["user_id"].as<int>();
+      checkin["checkin_time"] = row["checkin_time"].as<std::string>();
+      list.append(checkin);
+    }
+    Json::Value response;
+    response["checkins"] = list;
+    return writeJson(response).size();
+  });
+
+  run("checkins/RowSerializer", iterations, [&]() {
+    auto &body = common::jsonBuffer();
+    body += "{\"checkins\":";
+    common::RowSerializer<common::CheckinRow>(checkins).writeArray(
+        checkins, checkins.size(), body);
+    body += '}';
+    return body.size();
+  });
+
+  return 0;
+}
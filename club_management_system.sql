@@ -28,7 +28,7 @@ CREATE TABLE `activity_checkin` (
   `checkin_time` datetime DEFAULT NULL,
   PRIMARY KEY (`checkin_id`),
   KEY `user_id` (`user_id`),
-  KEY `activity_id` (`activity_id`),
+  KEY `activity_user` (`activity_id`,`user_id`),
   CONSTRAINT `activity_checkin_ibfk_1` FOREIGN KEY (`user_id`) REFERENCES `user` (`user_id`),
   CONSTRAINT `activity_checkin_ibfk_2` FOREIGN KEY (`activity_id`) REFERENCES `club_activity` (`activity_id`)
 ) ENGINE=InnoDB AUTO_INCREMENT=7 DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_0900_ai_ci;
@@ -43,9 +43,9 @@ CREATE TABLE `activity_registration` (
   `activity_id` int NOT NULL,
   `registration_date` datetime DEFAULT NULL,
   `payment_status` enum('未缴费','已缴费') NOT NULL DEFAULT '未缴费',
-  `registration_status` enum('pending','accepted','rejected','cancel') CHARACTER SET utf8mb4 COLLATE utf8mb4_0900_ai_ci NOT NULL DEFAULT 'pending',
+  `registration_status` enum('pending','accepted','rejected','cancel','waitlist') CHARACTER SET utf8mb4 COLLATE utf8mb4_0900_ai_ci NOT NULL DEFAULT 'pending',
   PRIMARY KEY (`registration_id`),
-  KEY `user_id` (`user_id`),
+  KEY `user_activity` (`user_id`,`activity_id`),
   KEY `activity_id` (`activity_id`),
   CONSTRAINT `activity_registration_ibfk_1` FOREIGN KEY (`user_id`) REFERENCES `user` (`user_id`),
   CONSTRAINT `activity_registration_ibfk_2` FOREIGN KEY (`activity_id`) REFERENCES `club_activity` (`activity_id`)
@@ -81,6 +81,8 @@ CREATE TABLE `club_activity` (
   `activity_description` text,
   `publish_time` datetime DEFAULT NULL,
   `registration_status` enum('pending''accepted''rejected') DEFAULT NULL,
+  `capacity` int DEFAULT NULL,
+  `waitlist_capacity` int NOT NULL DEFAULT '0',
   PRIMARY KEY (`activity_id`),
   KEY `club_id` (`club_id`),
   CONSTRAINT `club_activity_ibfk_1` FOREIGN KEY (`club_id`) REFERENCES `club` (`club_id`)
@@ -116,7 +118,7 @@ CREATE TABLE `club_member` (
   `join_date` datetime NOT NULL,
   `member_role` enum('社长','社员') CHARACTER SET utf8mb4 COLLATE utf8mb4_0900_ai_ci DEFAULT '社员',
   PRIMARY KEY (`member_id`),
-  KEY `user_id` (`user_id`),
+  UNIQUE KEY `user_club` (`user_id`,`club_id`),
   KEY `club_id` (`club_id`),
   CONSTRAINT `club_member_ibfk_1` FOREIGN KEY (`user_id`) REFERENCES `user` (`user_id`),
   CONSTRAINT `club_member_ibfk_2` FOREIGN KEY (`club_id`) REFERENCES `club` (`club_id`)
@@ -0,0 +1,273 @@
+#include "JsonScanner.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace common {
+
+namespace {
+// 与 config.json 中的 json_parser_stack_limit 一致
+constexpr int kMaxDepth = 1000;
+} // namespace
+
+void JsonScanner::fail() const {
+  throw std::runtime_error("请求体格式错误，请使用 JSON");
+}
+
+void JsonScanner::skipSpace() {
+  while (pos_ < text_.size()) {
+    char c = text_[pos_];
+    if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+      return;
+    }
+    ++pos_;
+  }
+}
+
+JsonScanner::Type JsonScanner::peek() {
+  skipSpace();
+  if (pos_ >= text_.size()) {
+    fail();
+  }
+  switch (text_[pos_]) {
+  case '{':
+    return Type::Object;
+  case '[':
+    return Type::Array;
+  case '"':
+    return Type::String;
+  case 't':
+    return Type::True;
+  case 'f':
+    return Type::False;
+  case 'n':
+    return Type::Null;
+  default:
+    return Type::Number;
+  }
+}
+
+bool JsonScanner::consume(char c) {
+  skipSpace();
+  if (pos_ < text_.size() && text_[pos_] == c) {
+    ++pos_;
+    return true;
+  }
+  return false;
+}
+
+void JsonScanner::expect(char c) {
+  if (!consume(c)) {
+    fail();
+  }
+}
+
+void JsonScanner::readString(std::string &out) {
+  expect('"');
+  out.clear();
+  while (true) {
+    // 整段复制到下一个引号或反斜杠；memchr 由 libc 向量化
+    const char *begin = text_.data() + pos_;
+    size_t remaining = text_.size() - pos_;
+    auto *quote =
+        static_cast<const char *>(std::memchr(begin, '"', remaining));
+    if (quote == nullptr) {
+      fail();
+    }
+    auto *slash = static_cast<const char *>(
+        std::memchr(begin, '\\', static_cast<size_t>(quote - begin)));
+    const char *stop = slash != nullptr ? slash : quote;
+    out.append(begin, stop);
+    pos_ += static_cast<size_t>(stop - begin) + 1;
+    if (slash == nullptr) {
+      return;
+    }
+
+    if (pos_ >= text_.size()) {
+      fail();
+    }
+    char escaped = text_[pos_++];
+    switch (escaped) {
+    case '"':
+    case '\\':
+    case '/':
+      out += escaped;
+      break;
+    case 'b':
+      out += '\b';
+      break;
+    case 'f':
+      out += '\f';
+      break;
+    case 'n':
+      out += '\n';
+      break;
+    case 'r':
+      out += '\r';
+      break;
+    case 't':
+      out += '\t';
+      break;
+    case 'u': {
+      unsigned codePoint = readHex4();
+      if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+        // 代理对
+        if (pos_ + 2 > text_.size() || text_[pos_] != '\\' ||
+            text_[pos_ + 1] != 'u') {
+          fail();
+        }
+        pos_ += 2;
+        unsigned low = readHex4();
+        if (low < 0xDC00 || low > 0xDFFF) {
+          fail();
+        }
+        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+      } else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) {
+        fail();
+      }
+      appendUtf8(out, codePoint);
+      break;
+    }
+    default:
+      fail();
+    }
+  }
+}
+
+unsigned JsonScanner::readHex4() {
+  if (pos_ + 4 > text_.size()) {
+    fail();
+  }
+  unsigned value = 0;
+  for (int i = 0; i < 4; ++i) {
+    char c = text_[pos_++];
+    value <<= 4;
+    if (c >= '0' && c <= '9') {
+      value |= static_cast<unsigned>(c - '0');
+    } else if (c >= 'a' && c <= 'f') {
+      value |= static_cast<unsigned>(c - 'a' + 10);
+    } else if (c >= 'A' && c <= 'F') {
+      value |= static_cast<unsigned>(c - 'A' + 10);
+    } else {
+      fail();
+    }
+  }
+  return value;
+}
+
+void JsonScanner::appendUtf8(std::string &out, unsigned codePoint) {
+  if (codePoint < 0x80) {
+    out += static_cast<char>(codePoint);
+  } else if (codePoint < 0x800) {
+    out += static_cast<char>(0xC0 | (codePoint >> 6));
+    out += static_cast<char>(0x80 | (codePoint & 0x3F));
+  } else if (codePoint < 0x10000) {
+    out += static_cast<char>(0xE0 | (codePoint >> 12));
+    out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (codePoint & 0x3F));
+  } else {
+    out += static_cast<char>(0xF0 | (codePoint >> 18));
+    out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+    out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (codePoint & 0x3F));
+  }
+}
+
+std::string_view JsonScanner::readNumber() {
+  skipSpace();
+  size_t start = pos_;
+  if (pos_ < text_.size() && text_[pos_] == '-') {
+    ++pos_;
+  }
+  auto digits = [this]() {
+    size_t from = pos_;
+    while (pos_ < text_.size() && text_[pos_] >= '0' && text_[pos_] <= '9') {
+      ++pos_;
+    }
+    return pos_ - from;
+  };
+  if (digits() == 0) {
+    fail();
+  }
+  if (pos_ < text_.size() && text_[pos_] == '.') {
+    ++pos_;
+    if (digits() == 0) {
+      fail();
+    }
+  }
+  if (pos_ < text_.size() && (text_[pos_] == 'e' || text_[pos_] == 'E')) {
+    ++pos_;
+    if (pos_ < text_.size() && (text_[pos_] == '+' || text_[pos_] == '-')) {
+      ++pos_;
+    }
+    if (digits() == 0) {
+      fail();
+    }
+  }
+  return text_.substr(start, pos_ - start);
+}
+
+void JsonScanner::readLiteral(std::string_view literal) {
+  skipSpace();
+  if (text_.substr(pos_, literal.size()) != literal) {
+    fail();
+  }
+  pos_ += literal.size();
+}
+
+void JsonScanner::skipValue() {
+  std::string scratch;
+  switch (peek()) {
+  case Type::Object:
+    if (++depth_ > kMaxDepth) {
+      fail();
+    }
+    expect('{');
+    if (!consume('}')) {
+      do {
+        readString(scratch);
+        expect(':');
+        skipValue();
+      } while (consume(','));
+      expect('}');
+    }
+    --depth_;
+    break;
+  case Type::Array:
+    if (++depth_ > kMaxDepth) {
+      fail();
+    }
+    expect('[');
+    if (!consume(']')) {
+      do {
+        skipValue();
+      } while (consume(','));
+      expect(']');
+    }
+    --depth_;
+    break;
+  case Type::String:
+    readString(scratch);
+    break;
+  case Type::True:
+    readLiteral("true");
+    break;
+  case Type::False:
+    readLiteral("false");
+    break;
+  case Type::Null:
+    readLiteral("null");
+    break;
+  case Type::Number:
+    readNumber();
+    break;
+  }
+}
+
+void JsonScanner::finish() {
+  skipSpace();
+  if (pos_ != text_.size()) {
+    fail();
+  }
+}
+
+} // namespace common
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// 单遍扫描 JSON 文本的游标，不构建 DOM。
+// 供 RequestSchema 把请求体直接解码进结构体。
+// 格式错误时抛出 std::runtime_error。
+
+namespace common {
+
+class JsonScanner {
+public:
+  enum class Type { Object, Array, String, Number, True, False, Null };
+
+  explicit JsonScanner(std::string_view text) : text_(text) {}
+
+  // 跳过空白后查看下一个值的类型
+  Type peek();
+
+  // 跳过空白，若下一个字符是 c 则消费并返回 true
+  bool consume(char c);
+  // 跳过空白，下一个字符必须是 c
+  void expect(char c);
+
+  // 读取字符串值（含引号），解码转义后写入 out
+  void readString(std::string &out);
+  // 读取数字的原始文本
+  std::string_view readNumber();
+  // 读取 true / false / null 字面量
+  void readLiteral(std::string_view literal);
+  // 跳过任意值，包括嵌套的对象和数组
+  void skipValue();
+
+  // 之后只允许空白
+  void finish();
+
+private:
+  void skipSpace();
+  [[noreturn]] void fail() const;
+  void appendUtf8(std::string &out, unsigned codePoint);
+  unsigned readHex4();
+
+  std::string_view text_;
+  size_t pos_ = 0;
+  int depth_ = 0;
+};
+
+} // namespace common
@@ -0,0 +1,99 @@
+#include "JsonStream.h"
+#include <drogon/orm/Exception.h>
+#include <drogon/utils/coroutine.h>
+#include <cstdio>
+#include <memory>
+
+namespace common {
+
+bool wantsStream(const drogon::HttpRequestPtr &req) {
+  const auto &param = req->getParameter("stream");
+  return param == "1" || param == "true";
+}
+
+drogon::HttpResponsePtr newJsonPageStreamResponse(drogon::orm::Result first,
+                                                  PageQuery query, int limit,
+                                                  const char *idColumn,
+                                                  std::string head,
+                                                  PageWriter writePage,
+                                                  std::string tail) {
+  return drogon::HttpResponse::newAsyncStreamResponse(
+      [first = std::move(first), query = std::move(query), limit, idColumn,
+       head = std::move(head), writePage = std::move(writePage),
+       tail = std::move(tail)](drogon::ResponseStreamPtr stream) mutable {
+        std::shared_ptr<drogon::ResponseStream> out(std::move(stream));
+        drogon::async_run(
+            [out, page = std::move(first), query = std::move(query), limit,
+             idColumn, chunk = std::move(head),
+             writePage = std::move(writePage),
+             tail = std::move(tail)]() mutable -> drogon::Task<> {
+              bool wroteRows = false;
+              while (true) {
+                if (!page.empty()) {
+                  if (wroteRows) {
+                    chunk += ',';
+                  }
+                  writePage(page, chunk);
+                  wroteRows = true;
+                }
+                // 客户端已断开
+                if (!out->send(chunk)) {
+                  co_return;
+                }
+                chunk.clear();
+                if (page.size() < static_cast<size_t>(limit)) {
+                  break;
+                }
+                int afterId = page[page.size() - 1][idColumn].as<int>();
+                try {
+                  page = co_await query(afterId, limit);
+                } catch (const drogon::orm::DrogonDbException &e) {
+                  LOG_ERROR << "流式输出查询失败: " << e.base().what();
+                  out->close();
+                  co_return;
+                }
+              }
+              out->send(tail);
+              out->close();
+            });
+      });
+}
+
+void appendJsonString(std::string &out, std::string_view value) {
+  out += '"';
+  for (char c : value) {
+    switch (c) {
+    case '"':
+      out += "\\\"";
+      break;
+    case '\\':
+      out += "\\\\";
+      break;
+    case '\n':
+      out += "\\n";
+      break;
+    case '\r':
+      out += "\\r";
+      break;
+    case '\t':
+      out += "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        char escaped[8];
+        std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+        out += escaped;
+      } else {
+        out += c;
+      }
+    }
+  }
+  out += '"';
+}
+
+void appendJsonKey(std::string &out, std::string_view key) {
+  appendJsonString(out, key);
+  out += ':';
+}
+
+} // namespace common
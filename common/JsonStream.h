@@ -0,0 +1,47 @@
+#pragma once
+
+#include <drogon/HttpRequest.h>
+#include <drogon/HttpResponse.h>
+#include <drogon/orm/Result.h>
+#include <drogon/utils/coroutine.h>
+#include <functional>
+#include <string>
+#include <string_view>
+
+// 大结果集的流式 JSON 响应。
+// 按翻页键分页查询，每页序列化后写入连接再查下一页，以 chunked 编码输出；
+// 不构建 Json::Value 树，内存中同时只有一页结果。
+// ResponseStream 没有发送缓冲区排空的通知，客户端读得慢时
+// 已写出的页面会积压在连接的发送缓冲区中。
+
+namespace common {
+
+// 取 afterId 之后的最多 limit 行，按翻页键升序
+using PageQuery =
+    std::function<drogon::Task<drogon::orm::Result>(int afterId, int limit)>;
+
+// 把一页结果写成逗号分隔的 JSON 对象，追加到 out
+using PageWriter =
+    std::function<void(const drogon::orm::Result &page, std::string &out)>;
+
+// 请求是否要求流式输出（?stream=1）
+bool wantsStream(const drogon::HttpRequestPtr &req);
+
+// 输出 head + 各页的行 + tail；head 形如 {"message":"...","items":[ ，tail 形如 ]}。
+// first 是调用方已查出的第一页，不足 limit 行时不再查询；
+// 之后以上一页最后一行的 idColumn 作为 afterId 调用 query。
+// 响应头发出后的查询失败只能记录日志并截断输出，客户端得到不完整的 JSON
+drogon::HttpResponsePtr newJsonPageStreamResponse(drogon::orm::Result first,
+                                                  PageQuery query, int limit,
+                                                  const char *idColumn,
+                                                  std::string head,
+                                                  PageWriter writePage,
+                                                  std::string tail);
+
+// 追加带引号并转义的 JSON 字符串
+void appendJsonString(std::string &out, std::string_view value);
+
+// 追加 "key":
+void appendJsonKey(std::string &out, std::string_view key);
+
+} // namespace common
@@ -0,0 +1,181 @@
+#include "MemberImport.h"
+#include "JsonScanner.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <stdexcept>
+
+namespace common {
+
+namespace {
+
+std::string_view trim(std::string_view text) {
+  while (!text.empty() &&
+         std::isspace(static_cast<unsigned char>(text.front()))) {
+    text.remove_prefix(1);
+  }
+  while (!text.empty() &&
+         std::isspace(static_cast<unsigned char>(text.back()))) {
+    text.remove_suffix(1);
+  }
+  return text;
+}
+
+bool parseId(std::string_view text, int &value) {
+  const char *last = text.data() + text.size();
+  auto [end, ec] = std::from_chars(text.data(), last, value);
+  return ec == std::errc() && end == last && value > 0;
+}
+
+// 按行切分，兼容 \r\n；回调参数为行号与去掉首尾空白的内容，空行跳过
+template <typename OnLine>
+void forEachLine(std::string_view body, OnLine &&onLine) {
+  size_t line = 0;
+  while (!body.empty()) {
+    ++line;
+    auto end = body.find('\n');
+    auto text = trim(body.substr(0, end));
+    body.remove_prefix(end == std::string_view::npos ? body.size() : end + 1);
+    if (!text.empty()) {
+      onLine(line, text);
+    }
+  }
+}
+
+// 切分一行 CSV，支持双引号包围的字段及其中的 "" 转义
+std::vector<std::string> splitCsv(std::string_view line) {
+  std::vector<std::string> fields(1);
+  bool quoted = false;
+  for (size_t i = 0; i < line.size(); ++i) {
+    char c = line[i];
+    if (quoted) {
+      if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+        fields.back() += '"';
+        ++i;
+      } else if (c == '"') {
+        quoted = false;
+      } else {
+        fields.back() += c;
+      }
+    } else if (c == '"') {
+      quoted = true;
+    } else if (c == ',') {
+      fields.emplace_back();
+    } else {
+      fields.back() += c;
+    }
+  }
+  for (auto &field : fields) {
+    field = std::string(trim(field));
+  }
+  return fields;
+}
+
+} // namespace
+
+bool parseCsv(std::string_view body, std::vector<ImportRow> &rows) {
+  std::optional<size_t> idColumn;
+  std::optional<size_t> nameColumn;
+  bool header = true;
+  bool ok = true;
+  forEachLine(body, [&](size_t line, std::string_view text) {
+    auto fields = splitCsv(text);
+    if (header) {
+      header = false;
+      for (size_t i = 0; i < fields.size(); ++i) {
+        std::string name = fields[i];
+        std::transform(name.begin(), name.end(), name.begin(),
+                       [](unsigned char c) {
+                         return static_cast<char>(std::tolower(c));
+                       });
+        if (name == "user_id") {
+          idColumn = i;
+        } else if (name == "username") {
+          nameColumn = i;
+        }
+      }
+      ok = idColumn || nameColumn;
+      return;
+    }
+
+    ImportRow row;
+    row.line = line;
+    const std::string empty;
+    const auto &id =
+        idColumn && *idColumn < fields.size() ? fields[*idColumn] : empty;
+    const auto &name =
+        nameColumn && *nameColumn < fields.size() ? fields[*nameColumn] : empty;
+    int value = 0;
+    if (!id.empty()) {
+      if (parseId(id, value)) {
+        row.userId = value;
+      } else {
+        row.status = "invalid";
+        row.error = "user_id 不是有效的正整数";
+      }
+    } else if (!name.empty()) {
+      row.username = name;
+    } else {
+      row.status = "invalid";
+      row.error = "缺少 user_id 或 username";
+    }
+    rows.push_back(std::move(row));
+  });
+  return ok;
+}
+
+void parseNdjson(std::string_view body, std::vector<ImportRow> &rows) {
+  forEachLine(body, [&](size_t line, std::string_view text) {
+    ImportRow row;
+    row.line = line;
+    try {
+      JsonScanner scanner(text);
+      scanner.expect('{');
+      if (!scanner.consume('}')) {
+        do {
+          std::string key;
+          scanner.readString(key);
+          scanner.expect(':');
+          auto type = scanner.peek();
+          if (key == "user_id" && type == JsonScanner::Type::Number) {
+            int value = 0;
+            if (parseId(scanner.readNumber(), value)) {
+              row.userId = value;
+            } else {
+              row.status = "invalid";
+              row.error = "user_id 不是有效的正整数";
+            }
+          } else if (key == "username" && type == JsonScanner::Type::String) {
+            scanner.readString(row.username);
+          } else {
+            scanner.skipValue();
+          }
+        } while (scanner.consume(','));
+        scanner.expect('}');
+      }
+      scanner.finish();
+    } catch (const std::runtime_error &) {
+      row.status = "invalid";
+      row.error = "不是有效的 JSON 对象";
+    }
+    if (row.status.empty() && !row.userId && row.username.empty()) {
+      row.status = "invalid";
+      row.error = "缺少 user_id 或 username";
+    }
+    rows.push_back(std::move(row));
+  });
+}
+
+bool isNdjson(std::string_view contentType, std::string_view body) {
+  if (contentType.find("csv") != std::string_view::npos) {
+    return false;
+  }
+  if (contentType.find("ndjson") != std::string_view::npos ||
+      contentType.find("jsonl") != std::string_view::npos) {
+    return true;
+  }
+  body = trim(body);
+  return !body.empty() && body.front() == '{';
+}
+
+} // namespace common
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 批量导入社员的文件解析。
+// 支持 CSV（首行为表头）与 NDJSON（每行一个 JSON 对象），
+// 每个非空行产生一条 ImportRow，格式错误的行标记为 invalid 而不中断解析。
+
+namespace common {
+
+// 导入文件中的一行
+struct ImportRow {
+  size_t line = 0;            // 源文件中的行号，从 1 开始
+  std::optional<int> userId;  // 按 user_id 导入
+  std::string username;       // 按 username 导入
+  int resolvedId = 0;         // 解析得到的 user_id
+  std::string status;         // 处理结果，空表示尚未确定
+  std::string error;
+};
+
+// 首行为表头，须包含 user_id 或 username 列；两列都有值时以 user_id 为准。
+// 表头缺少这两列时返回 false
+bool parseCsv(std::string_view body, std::vector<ImportRow> &rows);
+
+// 每行一个 JSON 对象：{"user_id": 1} 或 {"username": "..."}
+void parseNdjson(std::string_view body, std::vector<ImportRow> &rows);
+
+// Content-Type 为 text/csv 时按 CSV 解析，含 ndjson / jsonl 时按 NDJSON 解析；
+// 其余情况看首个非空白字符是否为 {
+bool isNdjson(std::string_view contentType, std::string_view body);
+
+} // namespace common
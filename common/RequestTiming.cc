@@ -0,0 +1,65 @@
+#include "RequestTiming.h"
+#include <cstdio>
+#include <memory>
+
+namespace common {
+
+namespace {
+constexpr const char *kTimingKey = "timing";
+} // namespace
+
+void RequestTiming::add(std::string_view phase, double ms) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto &entry : phases_) {
+    if (entry.name == phase) {
+      entry.ms += ms;
+      ++entry.count;
+      return;
+    }
+  }
+  phases_.push_back({std::string(phase), ms, 1});
+}
+
+double RequestTiming::total(std::string_view phase) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto &entry : phases_) {
+    if (entry.name == phase) {
+      return entry.ms;
+    }
+  }
+  return 0;
+}
+
+std::string RequestTiming::serverTiming() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string out;
+  char dur[32];
+  for (const auto &entry : phases_) {
+    if (!out.empty()) {
+      out += ", ";
+    }
+    out += entry.name;
+    std::snprintf(dur, sizeof(dur), ";dur=%.3f", entry.ms);
+    out += dur;
+    if (entry.count > 1) {
+      out += ";desc=\"";
+      out += std::to_string(entry.count);
+      out += '"';
+    }
+  }
+  return out;
+}
+
+RequestTiming *requestTiming(const drogon::HttpRequest &req) {
+  const auto &attributes = req.attributes();
+  if (!attributes->find(kTimingKey)) {
+    return nullptr;
+  }
+  return attributes->get<std::shared_ptr<RequestTiming>>(kTimingKey).get();
+}
+
+void attachRequestTiming(const drogon::HttpRequestPtr &req) {
+  req->attributes()->insert(kTimingKey, std::make_shared<RequestTiming>());
+}
+
+} // namespace common
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <drogon/HttpRequest.h>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 请求内的分阶段计时。
+// RequestTracer 在路由后为请求挂上一个 RequestTiming，
+// 各处用 PhaseTimer 或 add() 记下阶段耗时；请求结束时输出为
+// Server-Timing 头，并按采样率写入追踪日志。
+// 未挂计时的请求（插件未启用）上 PhaseTimer 什么也不做。
+
+namespace common {
+
+class RequestTiming {
+public:
+  // 累加一个阶段的耗时，同名阶段合并并计次
+  void add(std::string_view phase, double ms);
+
+  // 该阶段累计耗时，没有记录时为 0
+  double total(std::string_view phase) const;
+
+  // 形如 auth;dur=0.051, db;dur=3.104;desc="2"，desc 为次数（大于 1 时）
+  std::string serverTiming() const;
+
+  // 进入处理函数时调用；两者均以毫秒计
+  void markHandler() { handlerStartedAt_ = std::chrono::steady_clock::now(); }
+  double sinceStart() const { return millisSince(startedAt_); }
+  double sinceHandler() const { return millisSince(handlerStartedAt_); }
+
+private:
+  static double millisSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+  }
+
+  struct Phase {
+    std::string name;
+    double ms = 0;
+    int count = 0;
+  };
+
+  std::chrono::steady_clock::time_point startedAt_ =
+      std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point handlerStartedAt_ = startedAt_;
+  mutable std::mutex mutex_; // 协程可能在数据库线程上恢复
+  std::vector<Phase> phases_;
+};
+
+// 请求上的计时；未挂计时时返回 nullptr
+RequestTiming *requestTiming(const drogon::HttpRequest &req);
+void attachRequestTiming(const drogon::HttpRequestPtr &req);
+
+// 作用域计时：构造到析构的耗时记入请求的指定阶段
+class PhaseTimer {
+public:
+  PhaseTimer(const drogon::HttpRequest &req, const char *phase)
+      : timing_(requestTiming(req)), phase_(phase) {
+    if (timing_ != nullptr) {
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+  PhaseTimer(const PhaseTimer &) = delete;
+  PhaseTimer &operator=(const PhaseTimer &) = delete;
+  ~PhaseTimer() {
+    if (timing_ != nullptr) {
+      timing_->add(phase_, std::chrono::duration<double, std::milli>(
+                               std::chrono::steady_clock::now() - start_)
+                               .count());
+    }
+  }
+
+private:
+  RequestTiming *timing_;
+  const char *phase_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace common
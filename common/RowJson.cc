@@ -0,0 +1,45 @@
+#include "RowJson.h"
+
+namespace common {
+
+namespace {
+constexpr size_t kInitialBufferSize = 16 * 1024;
+} // namespace
+
+std::string &jsonBuffer() {
+  thread_local std::string buffer = [] {
+    std::string init;
+    init.reserve(kInitialBufferSize);
+    return init;
+  }();
+  buffer.clear();
+  return buffer;
+}
+
+void appendJsonScalar(std::string &out, const Json::Value &value) {
+  switch (value.type()) {
+  case Json::stringValue:
+    appendJsonString(out, value.asString());
+    break;
+  case Json::intValue:
+    out += std::to_string(value.asInt64());
+    break;
+  case Json::uintValue:
+    out += std::to_string(value.asUInt64());
+    break;
+  case Json::booleanValue:
+    out += value.asBool() ? "true" : "false";
+    break;
+  default:
+    out += "null";
+  }
+}
+
+drogon::HttpResponsePtr newJsonBodyResponse(const std::string &body) {
+  auto resp = drogon::HttpResponse::newHttpResponse();
+  resp->setContentTypeCode(drogon::CT_APPLICATION_JSON);
+  resp->setBody(body);
+  return resp;
+}
+
+} // namespace common
@@ -0,0 +1,176 @@
+#pragma once
+
+#include "common/JsonStream.h"
+#include <drogon/HttpResponse.h>
+#include <drogon/orm/Result.h>
+#include <drogon/orm/Row.h>
+#include <json/value.h>
+#include <array>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+// 按行形状直接把结果集写成 JSON。
+// 每种形状在编译期列出输出字段，列号在绑定结果集时解析一次；
+// 写行时直接从结果集缓冲区取 string_view 追加到输出，
+// 不经过 Json::Value，也不为每个字段分配 std::string。
+
+namespace common {
+
+// NULL 的输出与 Field::as<int>()、as<std::string>() 的结果一致
+enum class JsonType {
+  Int,    // 数字列，原样输出（MySQL 以文本返回），NULL 输出 0
+  String, // 字符串列，NULL 输出 ""
+};
+
+struct JsonField {
+  const char *column; // 结果集列名
+  const char *key;    // 输出键名，不含需要转义的字符
+  JsonType type;
+};
+
+// ----------------------------- 行形状 -----------------------------
+// 与 dao/Statements.h 中对应语句的列保持一致
+
+// club：kClubList
+struct ClubRow {
+  static constexpr JsonField fields[] = {
+      {"club_id", "club_id", JsonType::Int},
+      {"club_name", "club_name", JsonType::String},
+      {"club_introduction", "club_introduction", JsonType::String},
+  };
+};
+
+// club 详情：kClubCatalog、kClubFindById
+struct ClubDetailRow {
+  static constexpr JsonField fields[] = {
+      {"club_id", "club_id", JsonType::Int},
+      {"club_name", "club_name", JsonType::String},
+      {"club_introduction", "club_introduction", JsonType::String},
+      {"contact_info", "contact_info", JsonType::String},
+      {"activity_venue", "activity_venue", JsonType::String},
+      {"founder_id", "founder_id", JsonType::Int},
+  };
+};
+
+// club_activity：kActivityListByClub
+struct ClubActivityRow {
+  static constexpr JsonField fields[] = {
+      {"activity_id", "activity_id", JsonType::Int},
+      {"activity_title", "activity_title", JsonType::String},
+      {"activity_time", "activity_time", JsonType::String},
+  };
+};
+
+// club_member：kMemberListByClub
+struct MemberRow {
+  static constexpr JsonField fields[] = {
+      {"member_id", "member_id", JsonType::Int},
+      {"user_id", "user_id", JsonType::Int},
+      {"username", "username", JsonType::String},
+      {"email", "email", JsonType::String},
+      {"phone", "phone", JsonType::String},
+      {"member_role", "member_role", JsonType::String},
+  };
+};
+
+// activity_registration：kRegistrationDetailsByClub
+struct RegistrationRow {
+  static constexpr JsonField fields[] = {
+      {"registration_id", "registration_id", JsonType::Int},
+      {"user_id", "user_id", JsonType::Int},
+      {"username", "user_name", JsonType::String},
+      {"activity_id", "activity_id", JsonType::Int},
+      {"activity_title", "activity_title", JsonType::String},
+      {"registration_date", "registration_date", JsonType::String},
+      {"payment_status", "payment_status", JsonType::String},
+      {"registration_status", "registration_status", JsonType::String},
+  };
+};
+
+// activity_checkin：kCheckinListByActivity
+struct CheckinRow {
+  static constexpr JsonField fields[] = {
+      {"checkin_id", "checkin_id", JsonType::Int},
+      {"user_id", "user_id", JsonType::Int},
+      {"checkin_time", "checkin_time", JsonType::String},
+  };
+};
+
+// --------------------------- 序列化 ---------------------------
+
+template <typename Shape> class RowSerializer {
+public:
+  static constexpr size_t kFieldCount = std::size(Shape::fields);
+
+  // 解析各字段的列号；列不存在时抛出 drogon::orm::RangeError
+  explicit RowSerializer(const drogon::orm::Result &result) {
+    for (size_t i = 0; i < kFieldCount; ++i) {
+      columns_[i] = result.columnNumber(Shape::fields[i].column);
+    }
+  }
+
+  // 把一行写成 JSON 对象
+  void operator()(const drogon::orm::Row &row, std::string &out) const {
+    out += '{';
+    for (size_t i = 0; i < kFieldCount; ++i) {
+      const auto &spec = Shape::fields[i];
+      if (i > 0) {
+        out += ',';
+      }
+      out += '"';
+      out += spec.key;
+      out += "\":";
+
+      auto field = row[columns_[i]];
+      if (field.isNull()) {
+        out += spec.type == JsonType::Int ? "0" : "\"\"";
+      } else if (spec.type == JsonType::Int) {
+        out += field.as<std::string_view>();
+      } else {
+        appendJsonString(out, field.as<std::string_view>());
+      }
+    }
+    out += '}';
+  }
+
+  // 把结果集前 count 行写成 JSON 数组
+  void writeArray(const drogon::orm::Result &result, size_t count,
+                  std::string &out) const {
+    out += '[';
+    for (size_t i = 0; i < count; ++i) {
+      if (i > 0) {
+        out += ',';
+      }
+      (*this)(result[i], out);
+    }
+    out += ']';
+  }
+
+private:
+  std::array<drogon::orm::Row::SizeType, kFieldCount> columns_;
+};
+
+// 流式输出的 PageWriter：每页重新解析列号，行之间以逗号分隔
+template <typename Shape>
+void writeRows(const drogon::orm::Result &page, std::string &out) {
+  RowSerializer<Shape> writeRow(page);
+  for (size_t i = 0; i < page.size(); ++i) {
+    if (i > 0) {
+      out += ',';
+    }
+    writeRow(page[i], out);
+  }
+}
+
+// 当前线程复用的输出缓冲区，返回时已清空。
+// 只能在两次 co_await 之间使用：协程恢复后可能处在另一个线程上。
+std::string &jsonBuffer();
+
+// 追加 null、字符串、整数或布尔值
+void appendJsonScalar(std::string &out, const Json::Value &value);
+
+// 以已序列化好的 JSON 创建响应
+drogon::HttpResponsePtr newJsonBodyResponse(const std::string &body);
+
+} // namespace common
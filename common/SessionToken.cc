@@ -0,0 +1,107 @@
+#include "SessionToken.h"
+#include <drogon/utils/Utilities.h>
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <vector>
+
+namespace common {
+
+namespace {
+
+std::string base64Url(const unsigned char *data, size_t len) {
+  return drogon::utils::base64Encode(data, static_cast<unsigned int>(len),
+                                     true);
+}
+
+std::string hmacSha256(std::string_view data, const std::string &secret) {
+  unsigned char mac[EVP_MAX_MD_SIZE];
+  unsigned int macLen = 0;
+  HMAC(EVP_sha256(), secret.data(), static_cast<int>(secret.size()),
+       reinterpret_cast<const unsigned char *>(data.data()), data.size(), mac,
+       &macLen);
+  return std::string(reinterpret_cast<const char *>(mac), macLen);
+}
+
+// 按 '|' 切分载荷
+std::vector<std::string_view> splitPayload(std::string_view payload) {
+  std::vector<std::string_view> parts;
+  size_t start = 0;
+  while (true) {
+    auto pos = payload.find('|', start);
+    if (pos == std::string_view::npos) {
+      parts.push_back(payload.substr(start));
+      return parts;
+    }
+    parts.push_back(payload.substr(start, pos - start));
+    start = pos + 1;
+  }
+}
+
+template <typename T> bool parseNumber(std::string_view text, T &value) {
+  if (text.empty()) {
+    return false;
+  }
+  T result = 0;
+  for (char c : text) {
+    if (c < '0' || c > '9') {
+      return false;
+    }
+    result = result * 10 + (c - '0');
+  }
+  value = result;
+  return true;
+}
+
+} // namespace
+
+std::string signSessionToken(const SessionClaims &claims,
+                             const std::string &secret) {
+  auto payload = std::to_string(claims.userId) + "|" + claims.userType + "|" +
+                 std::to_string(claims.issuedAt) + "|" +
+                 std::to_string(claims.expiresAt) + "|" +
+                 std::to_string(claims.tokenId);
+  auto encoded = base64Url(
+      reinterpret_cast<const unsigned char *>(payload.data()), payload.size());
+  auto mac = hmacSha256(encoded, secret);
+  return encoded + "." +
+         base64Url(reinterpret_cast<const unsigned char *>(mac.data()),
+                   mac.size());
+}
+
+bool verifySessionToken(std::string_view token, const std::string &secret,
+                        SessionClaims &claims) {
+  auto dot = token.find('.');
+  if (dot == std::string_view::npos || dot == 0) {
+    return false;
+  }
+  auto encoded = token.substr(0, dot);
+
+  // 签名按常量时间比较
+  auto expected = hmacSha256(encoded, secret);
+  auto actual = drogon::utils::base64Decode(std::string(token.substr(dot + 1)));
+  if (actual.size() != expected.size() ||
+      CRYPTO_memcmp(actual.data(), expected.data(), expected.size()) != 0) {
+    return false;
+  }
+
+  auto payload = drogon::utils::base64Decode(std::string(encoded));
+  auto parts = splitPayload(payload);
+  SessionClaims parsed;
+  if (parts.size() != 5 || parts[1].empty() ||
+      !parseNumber(parts[0], parsed.userId) ||
+      !parseNumber(parts[2], parsed.issuedAt) ||
+      !parseNumber(parts[3], parsed.expiresAt) ||
+      !parseNumber(parts[4], parsed.tokenId)) {
+    return false;
+  }
+  parsed.userType = std::string(parts[1]);
+  claims = std::move(parsed);
+  return true;
+}
+
+const SessionClaims &currentSession(const drogon::HttpRequestPtr &req) {
+  return req->attributes()->get<SessionClaims>("session");
+}
+
+} // namespace common
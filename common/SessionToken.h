@@ -0,0 +1,34 @@
+#pragma once
+
+#include <drogon/HttpRequest.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// 无状态会话令牌。
+// 格式为 base64url(载荷) "." base64url(HMAC-SHA256(载荷))，
+// 载荷为 "user_id|user_type|issued_at|expires_at|token_id"。
+// 角色随令牌下发，权限判断不再查询 user 表。
+
+namespace common {
+
+struct SessionClaims {
+  int userId = 0;
+  std::string userType;  // 社员、社长、管理员
+  int64_t issuedAt = 0;  // 签发时间，微秒
+  int64_t expiresAt = 0; // 过期时间，微秒
+  uint64_t tokenId = 0;  // 撤销单个令牌时使用
+};
+
+// 签名并编码令牌
+std::string signSessionToken(const SessionClaims &claims,
+                             const std::string &secret);
+
+// 校验格式与签名并解出载荷，不检查是否过期或已撤销
+bool verifySessionToken(std::string_view token, const std::string &secret,
+                        SessionClaims &claims);
+
+// SessionFilter 校验通过后写入请求的会话信息
+const SessionClaims &currentSession(const drogon::HttpRequestPtr &req);
+
+} // namespace common
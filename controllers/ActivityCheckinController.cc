@@ -1,24 +1,31 @@
 #include "ActivityCheckinController.h"
+#include "common/SessionToken.h"
+#include "dao/Db.h"
+#include "common/JsonStream.h"
+#include "common/RowJson.h"
+#include "dao/Pagination.h"
+#include "plugins/CheckinPipeline.h"
+#include "plugins/ClubStats.h"
+#include "plugins/DbRouter.h"
+#include "plugins/LiveCounters.h"
 #include <drogon/HttpResponse.h>
 #include <drogon/orm/Exception.h>
+#include <algorithm>
+#include <optional>
+#include <vector>
 
-void ActivityCheckinController::checkin(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback) const {
-    auto dbClient = drogon::app().getDbClient();
-    Json::Value response;
+namespace {
+// activity_ids 过滤的个数上限，每个 id 占一个占位符
+constexpr size_t kMaxActivityIds = 1000;
+} // namespace
 
-    // 从 Cookie 中获取当前登录用户的 user_id
-    auto userIdCookie = req->getCookie("user_id");
-    if (userIdCookie.empty()) {
-        response["error"] = "未登录";
-        auto resp = HttpResponse::newHttpJsonResponse(response);
-        resp->setStatusCode(k401Unauthorized); // 未授权
-        callback(resp);
-        return;
-    }
+Task<> ActivityCheckinController::checkin(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback) const {
+    Json::Value response;
 
-    int user_id = std::stoi(userIdCookie);
+    // 当前登录用户，由 SessionFilter 校验令牌后写入
+    int user_id = common::currentSession(req).userId;
 
     // 获取请求体中的 activity_id
     auto json = req->getJsonObject();
@@ -27,42 +34,37 @@ void ActivityCheckinController::checkin(
         auto resp = HttpResponse::newHttpJsonResponse(response);
         resp->setStatusCode(k400BadRequest); // 错误请求
         callback(resp);
-        return;
+        co_return;
     }
 
     int activity_id = (*json)["activity_id"].asInt();
 
     try {
-        // 检查用户是否已报名该活动
-        auto registrationResult = dbClient->execSqlSync(
-            "SELECT COUNT(*) AS count FROM activity_registration WHERE user_id = ? AND activity_id = ?",
-            user_id, activity_id);
+        // 报名校验与查重在内存中完成，写入由 CheckinPipeline 批量提交
+        auto result = co_await app().getPlugin<CheckinPipeline>()->checkin(
+            activity_id, user_id, common::requestTiming(*req));
 
-        if (registrationResult[0]["count"].as<int>() == 0) {
+        if (result == CheckinPipeline::Result::NotRegistered) {
             response["error"] = "您尚未报名该活动，无法签到";
             auto resp = HttpResponse::newHttpJsonResponse(response);
             resp->setStatusCode(k403Forbidden); // 禁止访问
             callback(resp);
-            return;
+            co_return;
         }
 
-        // 检查是否已经签到
-        auto checkinResult = dbClient->execSqlSync(
-            "SELECT COUNT(*) AS count FROM activity_checkin WHERE user_id = ? AND activity_id = ?",
-            user_id, activity_id);
-
-        if (checkinResult[0]["count"].as<int>() > 0) {
+        if (result == CheckinPipeline::Result::Duplicate) {
             response["error"] = "您已签到过该活动";
             auto resp = HttpResponse::newHttpJsonResponse(response);
             resp->setStatusCode(k400BadRequest); // 错误请求
             callback(resp);
-            return;
+            co_return;
         }
 
-        // 插入签到记录
-        dbClient->execSqlSync(
-            "INSERT INTO activity_checkin (user_id, activity_id, checkin_time) VALUES (?, ?, NOW())",
-            user_id, activity_id);
+        app().getPlugin<LiveCounters>()->checkedIn(activity_id);
+        app().getPlugin<ClubStats>()->invalidateActivity(activity_id);
+
+        // 签到由管道写入主库，同样计入读己之写
+        app().getPlugin<DbRouter>()->recordWrite(req);
 
         response["message"] = "签到成功";
         auto resp = HttpResponse::newHttpJsonResponse(response);
@@ -76,30 +78,54 @@ void ActivityCheckinController::checkin(
     }
 }
 
-void ActivityCheckinController::getCheckinList(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback,
+Task<> ActivityCheckinController::getCheckinList(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback,
     int activityId) const {
-  auto dbClient = drogon::app().getDbClient();
   Json::Value response;
 
+  // 分页参数：after_id / cursor、limit
+  dao::IdPage page;
+  if (!dao::parseIdPage(req, page)) {
+    response["error"] = "无效的分页参数: after_id、cursor 或 limit";
+    auto resp = HttpResponse::newHttpJsonResponse(response);
+    resp->setStatusCode(k400BadRequest);
+    callback(resp);
+    co_return;
+  }
+
   try {
-    // 查询签到记录
-    auto result =
-        dbClient->execSqlSync("SELECT checkin_id, user_id, checkin_time FROM "
-                              "activity_checkin WHERE activity_id = ?",
-                              activityId);
-
-    Json::Value checkins(Json::arrayValue);
-    for (const auto &row : result) {
-      Json::Value checkin;
-      checkin["checkin_id"] = row["checkin_id"].as<int>();
-      checkin["user_id"] = row["user_id"].as<int>();
-      checkin["checkin_time"] = row["checkin_time"].as<std::string>();
-      checkins.append(checkin);
+    // ?stream=1 时按 limit 分页流式输出 after_id 之后的全部签到记录
+    if (common::wantsStream(req)) {
+      auto result = co_await dao::exec(req, dao::sql::kCheckinListByActivity,
+                                       activityId, page.afterId, page.limit);
+      callback(common::newJsonPageStreamResponse(
+          std::move(result),
+          [req, activityId](int afterId,
+                            int limit) -> Task<drogon::orm::Result> {
+            co_return co_await dao::exec(req, dao::sql::kCheckinListByActivity,
+                                         activityId, afterId, limit);
+          },
+          page.limit, "checkin_id", "{\"checkins\":[",
+          common::writeRows<common::CheckinRow>, "]}"));
+      co_return;
     }
 
-    response["checkins"] = checkins;
+    // 按 checkin_id 分页查询签到记录，多取一行判断是否还有下一页
+    auto result = co_await dao::exec(req, dao::sql::kCheckinListByActivity,
+                                     activityId, page.afterId, page.limit + 1);
+
+    // 行直接写入输出缓冲区，不经过 Json::Value
+    auto &body = common::jsonBuffer();
+    body += "{\"checkins\":";
+    common::RowSerializer<common::CheckinRow>(result).writeArray(
+        result, dao::pageSize(result, page), body);
+    body += ",\"next_cursor\":";
+    common::appendJsonScalar(body,
+                             dao::nextIdCursor(result, page, "checkin_id"));
+    body += '}';
+    callback(common::newJsonBodyResponse(body));
+    co_return;
   } catch (const drogon::orm::DrogonDbException &e) {
     response["error"] = "数据库错误，无法获取签到记录";
   }
@@ -109,10 +135,9 @@ void ActivityCheckinController::getCheckinList(
   callback(resp);
 }
 
-void ActivityCheckinController::getRegisteredActivitiesByUser(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback) const {
-    auto dbClient = drogon::app().getDbClient();
+Task<> ActivityCheckinController::getRegisteredActivitiesByUser(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback) const {
     Json::Value response;
 
     // 从请求体中获取 user_id
@@ -122,51 +147,98 @@ void ActivityCheckinController::getRegisteredActivitiesByUser(
         auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
         resp->setStatusCode(k400BadRequest); // 错误请求
         callback(resp);
-        return;
+        co_return;
     }
 
     int userId = (*json)["user_id"].asInt();
 
+    // 可选的 activity_ids 过滤，客户端只刷新当前展示的活动
+    bool filtered = json->isMember("activity_ids");
+    std::vector<int> activityIds;
+    if (filtered) {
+        const auto &ids = (*json)["activity_ids"];
+        if (!ids.isArray()) {
+            response["error"] = "activity_ids 必须是整数数组";
+            auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
+            resp->setStatusCode(k400BadRequest); // 错误请求
+            callback(resp);
+            co_return;
+        }
+        for (const auto &id : ids) {
+            if (!id.isInt()) {
+                response["error"] = "activity_ids 必须是整数数组";
+                auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
+                resp->setStatusCode(k400BadRequest); // 错误请求
+                callback(resp);
+                co_return;
+            }
+            activityIds.push_back(id.asInt());
+        }
+        if (activityIds.size() > kMaxActivityIds) {
+            response["error"] = "activity_ids 最多 " +
+                                std::to_string(kMaxActivityIds) + " 个";
+            auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
+            resp->setStatusCode(k400BadRequest); // 错误请求
+            callback(resp);
+            co_return;
+        }
+        std::sort(activityIds.begin(), activityIds.end());
+        activityIds.erase(std::unique(activityIds.begin(), activityIds.end()),
+                          activityIds.end());
+        // 空列表不查库，直接返回空结果，而不是按“未报名”返回 404
+        if (activityIds.empty()) {
+            response["registered_activities"] = Json::Value(Json::arrayValue);
+            response["message"] = "报名活动列表获取成功";
+            auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
+            resp->setStatusCode(k200OK); // 成功返回 200 OK
+            callback(resp);
+            co_return;
+        }
+    }
+
     try {
-        // 查询用户报名的所有活动，且报名状态为 accepted
-        auto result = dbClient->execSqlSync(
-            "SELECT r.registration_id, a.activity_id, a.activity_title, a.activity_time, "
-            "a.activity_location, a.activity_description, r.payment_status "
-            "FROM activity_registration r "
-            "JOIN club_activity a ON r.activity_id = a.activity_id "
-            "WHERE r.user_id = ? AND r.registration_status = 'accepted'",
-            userId);
-
-        if (result.empty()) {
+        // 查询用户报名且状态为 accepted 的活动，签到状态一并取回；
+        // 指定了活动时每个 activity_id 绑定为 IN 列表中的一个占位符
+        std::optional<drogon::orm::Result> result;
+        if (filtered) {
+            std::string sql = dao::sql::kRegistrationAcceptedWithCheckinIn.sql;
+            sql += dao::placeholders(activityIds.size());
+            result = co_await dao::execBound(
+                app().getDbClient(), common::requestTiming(*req),
+                dao::sql::kRegistrationAcceptedWithCheckinIn, std::move(sql),
+                activityIds.size() + 1, [userId, &activityIds](auto &binder) {
+                    binder << userId;
+                    for (int id : activityIds) {
+                        binder << id;
+                    }
+                });
+        } else {
+            result = co_await dao::exec(
+                req, dao::sql::kRegistrationAcceptedWithCheckin, userId);
+        }
+
+        if (result->empty()) {
             response["error"] = "未报名任何活动/活动报名审核中";
             auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
             resp->setStatusCode(k404NotFound); // 未找到
             callback(resp);
-            return;
+            co_return;
         }
 
         Json::Value registeredActivities(Json::arrayValue);
 
         // 遍历查询结果
-        for (const auto &row : result) {
+        for (const auto &row : *result) {
             Json::Value activity;
-            int activityId = row["activity_id"].as<int>();
-
             activity["registration_id"] = row["registration_id"].as<int>();
-            activity["activity_id"] = activityId;
+            activity["activity_id"] = row["activity_id"].as<int>();
             activity["activity_title"] = row["activity_title"].as<std::string>();
             activity["activity_time"] = row["activity_time"].as<std::string>();
             activity["activity_location"] = row["activity_location"].as<std::string>();
             activity["activity_description"] = row["activity_description"].as<std::string>();
             activity["payment_status"] = row["payment_status"].as<std::string>();
-
-            // 查询签到表，检查是否有签到记录
-            auto checkinResult = dbClient->execSqlSync(
-                "SELECT COUNT(*) AS count FROM activity_checkin WHERE activity_id = ? AND user_id = ?",
-                activityId, userId);
-
             // 如果有签到记录，设置 checkin_status 为 true，否则为 false
-            activity["checkin_status"] = checkinResult[0]["count"].as<int>() > 0;
+            activity["checkin_status"] = row["checked_in"].as<int>() > 0;
 
             registeredActivities.append(activity);
         }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <drogon/HttpController.h>
+#include <drogon/utils/coroutine.h>
 
 using namespace drogon;
 
@@ -8,13 +9,13 @@ class ActivityCheckinController : public drogon::HttpController<ActivityCheckinC
 {
   public:
     METHOD_LIST_BEGIN
-    ADD_METHOD_TO(ActivityCheckinController::checkin, "/activity/checkin", Post);
+    ADD_METHOD_TO(ActivityCheckinController::checkin, "/activity/checkin", Post, "SessionFilter");
     ADD_METHOD_TO(ActivityCheckinController::getCheckinList, "/activity/checkin/list/{activity_id}", Get);
     ADD_METHOD_TO(ActivityCheckinController::getRegisteredActivitiesByUser, "/activity/registration/user", Post);
 
     METHOD_LIST_END
 
-    void checkin(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
-    void getCheckinList(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, int activityId) const;
-    void getRegisteredActivitiesByUser(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+    Task<> checkin(HttpRequestPtr req, std::function<void(const HttpResponsePtr &)> callback) const;
+    Task<> getCheckinList(HttpRequestPtr req, std::function<void(const HttpResponsePtr &)> callback, int activityId) const;
+    Task<> getRegisteredActivitiesByUser(HttpRequestPtr req, std::function<void(const HttpResponsePtr &)> callback) const;
 };
\ No newline at end of file
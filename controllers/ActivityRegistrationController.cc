@@ -1,24 +1,29 @@
 #include "ActivityRegistrationController.h"
+#include "common/SessionToken.h"
+#include "dao/Db.h"
+#include "dao/Pagination.h"
+#include "plugins/ClubStats.h"
+#include "plugins/LiveCounters.h"
+#include "plugins/PermissionIndex.h"
+#include "plugins/SeatLedger.h"
 #include <drogon/HttpResponse.h>
 #include <drogon/orm/Exception.h>
+#include <algorithm>
 
-void ActivityRegistrationController::registerActivity(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback) const {
-  auto dbClient = drogon::app().getDbClient();
-  Json::Value response;
+namespace {
+// 占用名额的报名状态
+bool holdsSeat(const std::string &status) {
+  return status == "pending" || status == "accepted";
+}
+} // namespace
 
-  // 从 Cookie 中获取当前登录用户的 user_id
-  auto userIdCookie = req->getCookie("user_id");
-  if (userIdCookie.empty()) {
-    response["error"] = "未登录";
-    auto resp = HttpResponse::newHttpJsonResponse(response);
-    resp->setStatusCode(k401Unauthorized);
-    callback(resp);
-    return;
-  }
+Task<> ActivityRegistrationController::registerActivity(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback) const {
+  Json::Value response;
 
-  int user_id = std::stoi(userIdCookie);
+  // 当前登录用户，由 SessionFilter 校验令牌后写入
+  int user_id = common::currentSession(req).userId;
 
   // 获取请求体中的 activity_id
   auto json = req->getJsonObject();
@@ -27,55 +32,95 @@ void ActivityRegistrationController::registerActivity(
     auto resp = HttpResponse::newHttpJsonResponse(response);
     resp->setStatusCode(k400BadRequest);
     callback(resp);
-    return;
+    co_return;
   }
 
   int activity_id = (*json)["activity_id"].asInt();
 
+  std::shared_ptr<SeatLedger::Counters> seats;
+  bool claimed = false;
+  auto placement = SeatLedger::Placement::Full;
   try {
-    // 查询是否已有报名记录
-    auto result = dbClient->execSqlSync(
-        "SELECT registration_status FROM activity_registration WHERE user_id = "
-        "? AND activity_id = ?",
-        user_id, activity_id);
+    seats = co_await app().getPlugin<SeatLedger>()->counters(
+        activity_id, common::requestTiming(*req));
+    if (!seats) {
+      response["error"] = "活动不存在";
+      auto resp = HttpResponse::newHttpJsonResponse(response);
+      resp->setStatusCode(k404NotFound);
+      callback(resp);
+      co_return;
+    }
 
-    if (!result.empty()) {
-      std::string registration_status =
-          result[0]["registration_status"].as<std::string>();
+    // 最近一次报名状态在内存中查询并占位，重复报名不访问数据库；
+    // 先看已有报名再占名额，名额满时已报名的用户仍得到自己的状态而不是 409
+    auto existing = seats->claim(user_id);
+    if (existing) {
+      const std::string &registration_status = *existing;
 
       if (registration_status == "rejected") {
         response["error"] = "您的报名已被拒绝，无法再次报名";
         auto resp = HttpResponse::newHttpJsonResponse(response);
         resp->setStatusCode(k400BadRequest);
         callback(resp);
-        return;
+        co_return;
       } else if (registration_status == "accepted") {
         response["message"] = "您已报名成功，无需再次报名";
         auto resp = HttpResponse::newHttpJsonResponse(response);
         resp->setStatusCode(k200OK);
         callback(resp);
-        return;
+        co_return;
       } else if (registration_status == "pending") {
         response["message"] = "您的报名已在审核中，无需重复报名";
         auto resp = HttpResponse::newHttpJsonResponse(response);
         resp->setStatusCode(k200OK);
         callback(resp);
-        return;
-      } 
+        co_return;
+      } else {
+        response["message"] = "您已在候补名单中，无需重复报名";
+        auto resp = HttpResponse::newHttpJsonResponse(response);
+        resp->setStatusCode(k200OK);
+        callback(resp);
+        co_return;
+      }
     }
+    claimed = true;
 
-    // 如果没有记录，插入新报名记录，状态为 pending
-    dbClient->execSqlSync(
-        "INSERT INTO activity_registration (user_id, activity_id, "
-        "registration_date, registration_status) VALUES (?, ?, NOW(), "
-        "'pending')",
-        user_id, activity_id);
+    // 在内存中占位：有名额时状态为 pending，名额满时进入候补
+    placement = seats->place();
+    if (placement == SeatLedger::Placement::Full) {
+      seats->unclaim(user_id);
+      response["error"] = "活动名额已满，候补名单也已满";
+      auto resp = HttpResponse::newHttpJsonResponse(response);
+      resp->setStatusCode(k409Conflict);
+      callback(resp);
+      co_return;
+    }
 
-    response["message"] = "报名成功，等待审核";
+    bool waitlisted = placement == SeatLedger::Placement::Waitlist;
+    std::string status = waitlisted ? "waitlist" : "pending";
+    co_await dao::exec(req, dao::sql::kRegistrationInsert, user_id, activity_id,
+                       status);
+    seats->setStatus(user_id, status);
+    app().getPlugin<LiveCounters>()->registrationMoved(activity_id, {},
+                                                       status);
+    app().getPlugin<ClubStats>()->invalidateActivity(activity_id);
+
+    response["message"] =
+        waitlisted ? "活动名额已满，已加入候补名单" : "报名成功，等待审核";
+    response["waitlisted"] = waitlisted;
     auto resp = HttpResponse::newHttpJsonResponse(response);
     resp->setStatusCode(k200OK);
     callback(resp);
   } catch (const drogon::orm::DrogonDbException &e) {
+    // 写入失败，归还占用的位置与报名占位
+    if (placement == SeatLedger::Placement::Seat) {
+      seats->releaseSeat();
+    } else if (placement == SeatLedger::Placement::Waitlist) {
+      seats->leaveWaitlist();
+    }
+    if (claimed) {
+      seats->unclaim(user_id);
+    }
     response["error"] = "数据库错误，无法报名";
     auto resp = HttpResponse::newHttpJsonResponse(response);
     resp->setStatusCode(k500InternalServerError);
@@ -83,23 +128,13 @@ void ActivityRegistrationController::registerActivity(
   }
 }
 
-void ActivityRegistrationController::cancelRegistration(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback) const {
-  auto dbClient = drogon::app().getDbClient();
+Task<> ActivityRegistrationController::cancelRegistration(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback) const {
   Json::Value response;
 
-  // 从 Cookie 中获取当前登录用户的 user_id
-  auto userIdCookie = req->getCookie("user_id");
-  if (userIdCookie.empty()) {
-    response["error"] = "未登录";
-    auto resp = HttpResponse::newHttpJsonResponse(response);
-    resp->setStatusCode(k401Unauthorized);
-    callback(resp);
-    return;
-  }
-
-  int user_id = std::stoi(userIdCookie);
+  // 当前登录用户，由 SessionFilter 校验令牌后写入
+  int user_id = common::currentSession(req).userId;
 
   // 获取请求体中的 activity_id
   auto json = req->getJsonObject();
@@ -108,36 +143,64 @@ void ActivityRegistrationController::cancelRegistration(
     auto resp = HttpResponse::newHttpJsonResponse(response);
     resp->setStatusCode(k400BadRequest);
     callback(resp);
-    return;
+    co_return;
   }
 
   int activity_id = (*json)["activity_id"].asInt();
 
   try {
     // 查询报名记录
-    auto result = dbClient->execSqlSync(
-        "SELECT registration_status FROM activity_registration WHERE user_id = "
-        "? AND activity_id = ?",
-        user_id, activity_id);
+    auto result = co_await dao::exec(req, dao::sql::kRegistrationStatus, user_id,
+                                     activity_id);
 
     if (result.empty()) {
       response["error"] = "未找到报名记录";
       auto resp = HttpResponse::newHttpJsonResponse(response);
       resp->setStatusCode(k404NotFound);
       callback(resp);
-      return;
+      co_return;
     }
 
     std::string registration_status =
         result[0]["registration_status"].as<std::string>();
 
     // 检查报名状态
-    if (registration_status == "pending" || registration_status == "accepted") {
-      // 更新报名状态为 cancel
-      auto updateResult = dbClient->execSqlSync(
-          "UPDATE activity_registration SET registration_status = 'cancel' "
-          "WHERE user_id = ? AND activity_id = ?",
-          user_id, activity_id);
+    if (holdsSeat(registration_status) || registration_status == "waitlist") {
+      // 更新报名状态为 cancel，条件更新避免与并发的审核、递补重复计数
+      auto updateResult = co_await dao::exec(req, dao::sql::kRegistrationCancel,
+                                             user_id, activity_id,
+                                             registration_status);
+
+      int released = static_cast<int>(updateResult.affectedRows());
+      if (released > 0) {
+        app().getPlugin<LiveCounters>()->registrationMoved(
+            activity_id, registration_status, "cancel", released);
+        auto ledger = app().getPlugin<SeatLedger>();
+        auto *timing = common::requestTiming(*req);
+        auto seats = co_await ledger->counters(activity_id, timing);
+        // 取消后可以重新报名
+        if (seats) {
+          seats->setStatus(user_id, "cancel");
+        }
+        if (seats && registration_status == "waitlist") {
+          seats->leaveWaitlist(released);
+        } else if (seats) {
+          // 空出的名额交给候补名单中最早报名的用户
+          seats->releaseSeat(released);
+          try {
+            auto promoted = co_await ledger->promote(activity_id, timing);
+            for (int promotedUser : promoted) {
+              LOG_INFO << "活动 " << activity_id << " 候补用户 "
+                       << promotedUser << " 已递补";
+            }
+          } catch (const drogon::orm::DrogonDbException &e) {
+            // 取消已生效；递补留待下一次取消或名额调整
+            LOG_ERROR << "候补递补失败: " << e.base().what();
+          }
+        }
+      }
+
+      app().getPlugin<ClubStats>()->invalidateActivity(activity_id);
 
       response["message"] = "报名已取消";
       auto resp = HttpResponse::newHttpJsonResponse(response);
@@ -158,75 +221,69 @@ void ActivityRegistrationController::cancelRegistration(
   }
 }
 
-void ActivityRegistrationController::getRegistrationList(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback) const {
-  auto dbClient = drogon::app().getDbClient();
+Task<> ActivityRegistrationController::getRegistrationList(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback) const {
   Json::Value response;
 
-  // 从 Cookie 中获取当前登录用户的 user_id
-  auto userIdCookie = req->getCookie("user_id");
-  if (userIdCookie.empty()) {
-    response["error"] = "未登录";
+  // 当前登录用户，由 SessionFilter 校验令牌后写入
+  int user_id = common::currentSession(req).userId;
+
+  // 可选的状态过滤与分页参数
+  auto status = req->getParameter("status");
+  if (!status.empty() && status != "pending" && status != "accepted" &&
+      status != "rejected" && status != "cancel" && status != "waitlist") {
+    response["error"] = "无效的 status，必须是 pending、accepted、rejected、"
+                        "cancel 或 waitlist";
     auto resp = HttpResponse::newHttpJsonResponse(response);
-    resp->setStatusCode(k401Unauthorized); // 未授权
+    resp->setStatusCode(k400BadRequest);
     callback(resp);
-    return;
+    co_return;
   }
 
-  int user_id = std::stoi(userIdCookie);
+  int limit = dao::pageLimit(req);
+  auto cursor = dao::firstDateCursor();
+  const auto &cursorParam = req->getParameter("cursor");
+  if (limit < 0 ||
+      (!cursorParam.empty() && !dao::decodeDateCursor(cursorParam, cursor))) {
+    response["error"] = "无效的分页参数: limit 或 cursor";
+    auto resp = HttpResponse::newHttpJsonResponse(response);
+    resp->setStatusCode(k400BadRequest);
+    callback(resp);
+    co_return;
+  }
 
   try {
-    // 查询用户是否是社长
-    auto clubResult = dbClient->execSqlSync(
-        "SELECT c.club_id FROM club c WHERE c.founder_id = ?", user_id);
+    // 社长取其所有社团的报名记录，普通社员只取自己的报名记录，
+    // 一次查询完成，多取一行判断是否还有下一页
+    auto result = co_await dao::exec(req, dao::sql::kRegistrationInbox, user_id,
+                                     user_id, user_id, status, status,
+                                     cursor.date, cursor.id, limit + 1);
 
     Json::Value registrations(Json::arrayValue);
+    size_t count = std::min(result.size(), static_cast<size_t>(limit));
+    for (size_t i = 0; i < count; ++i) {
+      const auto &row = result[i];
+      Json::Value registration;
+      registration["registration_id"] = row["registration_id"].as<int>();
+      registration["user_id"] = row["user_id"].as<int>();
+      registration["activity_id"] = row["activity_id"].as<int>();
+      registration["registration_date"] =
+          row["registration_date"].as<std::string>();
+      registration["payment_status"] = row["payment_status"].as<std::string>();
+      registration["registration_status"] =
+          row["registration_status"].as<std::string>();
+      registrations.append(registration);
+    }
 
-    if (!clubResult.empty()) {
-      // 当前用户是社长，查询其所有社团的报名记录
-      for (const auto &clubRow : clubResult) {
-        int club_id = clubRow["club_id"].as<int>();
-
-        auto result = dbClient->execSqlSync(
-            "SELECT r.registration_id, r.user_id, r.activity_id, "
-            "r.registration_date, r.payment_status "
-            "FROM activity_registration r "
-            "JOIN club_activity a ON r.activity_id = a.activity_id "
-            "WHERE a.club_id = ?",
-            club_id);
-
-        for (const auto &row : result) {
-          Json::Value registration;
-          registration["registration_id"] = row["registration_id"].as<int>();
-          registration["user_id"] = row["user_id"].as<int>();
-          registration["activity_id"] = row["activity_id"].as<int>();
-          registration["registration_date"] =
-              row["registration_date"].as<std::string>();
-          registration["payment_status"] =
-              row["payment_status"].as<std::string>();
-          registrations.append(registration);
-        }
-      }
+    // 还有下一页时返回游标，否则为 null
+    if (result.size() > count) {
+      const auto &last = result[count - 1];
+      response["next_cursor"] =
+          dao::encodeDateCursor(last["registration_date"].as<std::string>(),
+                                last["registration_id"].as<int>());
     } else {
-      // 当前用户是普通社员，只查询自己的报名记录
-      auto result =
-          dbClient->execSqlSync("SELECT registration_id, user_id, activity_id, "
-                                "registration_date, payment_status "
-                                "FROM activity_registration WHERE user_id = ?",
-                                user_id);
-
-      for (const auto &row : result) {
-        Json::Value registration;
-        registration["registration_id"] = row["registration_id"].as<int>();
-        registration["user_id"] = row["user_id"].as<int>();
-        registration["activity_id"] = row["activity_id"].as<int>();
-        registration["registration_date"] =
-            row["registration_date"].as<std::string>();
-        registration["payment_status"] =
-            row["payment_status"].as<std::string>();
-        registrations.append(registration);
-      }
+      response["next_cursor"] = Json::Value();
     }
 
     response["registrations"] = registrations;
@@ -243,24 +300,23 @@ void ActivityRegistrationController::getRegistrationList(
 }
 
 
-void ActivityRegistrationController::reviewRegistration(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback) const {
-    auto dbClient = drogon::app().getDbClient();
+Task<> ActivityRegistrationController::reviewRegistration(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback) const {
     Json::Value response;
 
-    // 从 Cookie 中获取当前登录用户的 user_id
-    auto userIdCookie = req->getCookie("user_id");
-    if (userIdCookie.empty()) {
-        response["error"] = "未登录";
+    // 当前登录用户，由 SessionFilter 校验令牌后写入
+    const auto &session = common::currentSession(req);
+
+    // 只有社长和管理员可以审核报名，角色取自会话令牌
+    if (session.userType != "社长" && session.userType != "管理员") {
+        response["error"] = "无权限操作，只有社长或管理员可以审核报名";
         auto resp = HttpResponse::newHttpJsonResponse(response);
-        resp->setStatusCode(k401Unauthorized); // 未授权
+        resp->setStatusCode(k403Forbidden);
         callback(resp);
-        return;
+        co_return;
     }
 
-    int user_id = std::stoi(userIdCookie);
-
     // 获取请求体中的 registration_id 和 registration_status
     auto json = req->getJsonObject();
     if (!json || !json->isMember("registration_id") || !json->isMember("registration_status")) {
@@ -268,7 +324,7 @@ void ActivityRegistrationController::reviewRegistration(
         auto resp = HttpResponse::newHttpJsonResponse(response);
         resp->setStatusCode(k400BadRequest); // 错误请求
         callback(resp);
-        return;
+        co_return;
     }
 
     int registration_id = (*json)["registration_id"].asInt();
@@ -280,29 +336,110 @@ void ActivityRegistrationController::reviewRegistration(
         auto resp = HttpResponse::newHttpJsonResponse(response);
         resp->setStatusCode(k400BadRequest); // 错误请求
         callback(resp);
-        return;
+        co_return;
     }
 
+    auto *timing = common::requestTiming(*req);
+    std::shared_ptr<SeatLedger::Counters> seats;
+    bool seatTaken = false;
     try {
-        // 更新报名状态
-        auto result = dbClient->execSqlSync(
-            "UPDATE activity_registration SET registration_status = ? WHERE registration_id = ?",
-            registration_status, registration_id);
-
-        if (result.affectedRows() == 0) {
+        // 报名所属活动与当前状态
+        auto regResult = co_await dao::exec(
+            req, dao::sql::kRegistrationActivityById, registration_id);
+        if (regResult.empty()) {
             response["error"] = "未找到对应的报名记录";
             auto resp = HttpResponse::newHttpJsonResponse(response);
             resp->setStatusCode(k404NotFound); // 未找到
             callback(resp);
-            return;
+            co_return;
+        }
+        int activity_id = regResult[0]["activity_id"].as<int>();
+        int user_id = regResult[0]["user_id"].as<int>();
+        std::string previous_status =
+            regResult[0]["registration_status"].as<std::string>();
+
+        // 管理员可以审核任意报名，社长只能审核自己社团活动的报名
+        if (session.userType != "管理员") {
+            auto founder = co_await app().getPlugin<PermissionIndex>()->activityFounder(
+                activity_id, timing);
+            if (founder != session.userId) {
+                response["error"] = "无权限操作，只能审核自己社团活动的报名";
+                auto resp = HttpResponse::newHttpJsonResponse(response);
+                resp->setStatusCode(k403Forbidden);
+                callback(resp);
+                co_return;
+            }
         }
 
+        if (previous_status == registration_status) {
+            response["message"] = "报名状态更新成功";
+            auto resp = HttpResponse::newHttpJsonResponse(response);
+            resp->setStatusCode(k200OK); // 成功
+            callback(resp);
+            co_return;
+        }
+
+        // 从不占名额的状态（候补、已拒绝、已取消）改为通过时需要一个空名额
+        auto ledger = app().getPlugin<SeatLedger>();
+        seats = co_await ledger->counters(activity_id, timing);
+        bool hadSeat = holdsSeat(previous_status);
+        bool needsSeat = holdsSeat(registration_status);
+        if (seats && needsSeat && !hadSeat) {
+            if (!seats->takeSeat()) {
+                response["error"] = "活动名额已满，无法通过该报名";
+                auto resp = HttpResponse::newHttpJsonResponse(response);
+                resp->setStatusCode(k409Conflict);
+                callback(resp);
+                co_return;
+            }
+            seatTaken = true;
+        }
+
+        // 更新报名状态，状态在读取后被改动时不更新
+        auto result = co_await dao::exec(
+            req, dao::sql::kRegistrationReview, registration_status, registration_id,
+            previous_status);
+
+        if (result.affectedRows() == 0) {
+            if (seatTaken) {
+                seats->releaseSeat();
+            }
+            response["error"] = "报名状态已被修改，请刷新后重试";
+            auto resp = HttpResponse::newHttpJsonResponse(response);
+            resp->setStatusCode(k409Conflict);
+            callback(resp);
+            co_return;
+        }
+        seatTaken = false;
+        if (seats) {
+            seats->setStatus(user_id, registration_status);
+        }
+        app().getPlugin<LiveCounters>()->registrationMoved(
+            activity_id, previous_status, registration_status);
+
+        if (seats && previous_status == "waitlist") {
+            seats->leaveWaitlist();
+        }
+        if (seats && hadSeat && !needsSeat) {
+            // 拒绝占名额的报名后递补候补名单
+            seats->releaseSeat();
+            try {
+                co_await ledger->promote(activity_id, timing);
+            } catch (const drogon::orm::DrogonDbException &e) {
+                LOG_ERROR << "候补递补失败: " << e.base().what();
+            }
+        }
+        app().getPlugin<ClubStats>()->invalidateActivity(activity_id);
+
         response["message"] = "报名状态更新成功";
         auto resp = HttpResponse::newHttpJsonResponse(response);
         resp->setStatusCode(k200OK); // 成功
         callback(resp);
     } catch (const drogon::orm::DrogonDbException &e) {
         LOG_ERROR << "Database error: " << e.base().what();
+        if (seatTaken) {
+            seats->releaseSeat();
+        }
         response["error"] = "数据库错误，无法更新报名状态";
         auto resp = HttpResponse::newHttpJsonResponse(response);
         resp->setStatusCode(k500InternalServerError); // 服务器内部错误
@@ -310,10 +447,9 @@ void ActivityRegistrationController::reviewRegistration(
     }
 }
 
-void ActivityRegistrationController::getApprovedRegistrationsByUser(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback) const {
-    auto dbClient = drogon::app().getDbClient();
+Task<> ActivityRegistrationController::getApprovedRegistrationsByUser(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback) const {
     Json::Value response;
 
     // 从请求体中获取 user_id
@@ -323,27 +459,22 @@ void ActivityRegistrationController::getApprovedRegistrationsByUser(
         auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
         resp->setStatusCode(k400BadRequest); // 错误请求
         callback(resp);
-        return;
+        co_return;
     }
 
     int userId = (*json)["user_id"].asInt();
 
     try {
         // 查询用户报名且报名状态为 accepted 的所有活动，并返回 payment_status
-        auto result = dbClient->execSqlSync(
-            "SELECT a.activity_id, a.activity_title, a.activity_time, a.activity_location, a.activity_description, "
-            "r.payment_status "
-            "FROM activity_registration r "
-            "JOIN club_activity a ON r.activity_id = a.activity_id "
-            "WHERE r.user_id = ? AND r.registration_status = 'accepted'",
-            userId);
+        auto result =
+            co_await dao::exec(req, dao::sql::kRegistrationApprovedByUser, userId);
 
         if (result.empty()) {
             response["error"] = "未找到任何已报名且通过的活动";
             auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
             resp->setStatusCode(k404NotFound); // 未找到
             callback(resp);
-            return;
+            co_return;
         }
 
         Json::Value approvedActivities(Json::arrayValue);
@@ -375,10 +506,9 @@ void ActivityRegistrationController::getApprovedRegistrationsByUser(
     }
 }
 
-void ActivityRegistrationController::setPaymentStatus(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback) const {
-    auto dbClient = drogon::app().getDbClient();
+Task<> ActivityRegistrationController::setPaymentStatus(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback) const {
     Json::Value response;
 
     // 从请求体中获取 registration_id 和 payment_status
@@ -388,7 +518,7 @@ void ActivityRegistrationController::setPaymentStatus(
         auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
         resp->setStatusCode(k400BadRequest); // 错误请求
         callback(resp);
-        return;
+        co_return;
     }
 
     int registrationId = (*json)["registration_id"].asInt();
@@ -400,21 +530,20 @@ void ActivityRegistrationController::setPaymentStatus(
         auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
         resp->setStatusCode(k400BadRequest); // 错误请求
         callback(resp);
-        return;
+        co_return;
     }
 
     try {
         // 查询当前报名记录的缴费状态
-        auto result = dbClient->execSqlSync(
-            "SELECT payment_status FROM activity_registration WHERE registration_id = ?",
-            registrationId);
+        auto result = co_await dao::exec(req, dao::sql::kRegistrationPaymentById,
+                                         registrationId);
 
         if (result.empty()) {
             response["error"] = "未找到对应的报名记录";
             auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
             resp->setStatusCode(k404NotFound); // 未找到
             callback(resp);
-            return;
+            co_return;
         }
 
         std::string currentStatus = result[0]["payment_status"].as<std::string>();
@@ -425,13 +554,14 @@ void ActivityRegistrationController::setPaymentStatus(
             auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
             resp->setStatusCode(k400BadRequest); // 错误请求
             callback(resp);
-            return;
+            co_return;
         }
 
         // 更新报名记录的缴费状态
-        dbClient->execSqlSync(
-            "UPDATE activity_registration SET payment_status = ? WHERE registration_id = ?",
-            paymentStatus, registrationId);
+        co_await dao::exec(req, dao::sql::kRegistrationUpdatePayment, paymentStatus,
+                           registrationId);
+        app().getPlugin<ClubStats>()->invalidateActivity(
+            result[0]["activity_id"].as<int>());
 
         response["message"] = "缴费状态更新成功";
         auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
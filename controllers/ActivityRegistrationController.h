@@ -1,6 +1,7 @@
 #pragma once
 
 #include <drogon/HttpController.h>
+#include <drogon/utils/coroutine.h>
 
 using namespace drogon;
 
@@ -8,18 +9,18 @@ class ActivityRegistrationController : public drogon::HttpController<ActivityReg
 {
   public:
     METHOD_LIST_BEGIN
-    ADD_METHOD_TO(ActivityRegistrationController::registerActivity, "/activity/register", Post);
-    ADD_METHOD_TO(ActivityRegistrationController::cancelRegistration, "/activity/register/cancel", Post);
-    ADD_METHOD_TO(ActivityRegistrationController::getRegistrationList, "/activity/register/list", Get);
-    ADD_METHOD_TO(ActivityRegistrationController::reviewRegistration, "/activity/register/review", Post);
+    ADD_METHOD_TO(ActivityRegistrationController::registerActivity, "/activity/register", Post, "SessionFilter");
+    ADD_METHOD_TO(ActivityRegistrationController::cancelRegistration, "/activity/register/cancel", Post, "SessionFilter");
+    ADD_METHOD_TO(ActivityRegistrationController::getRegistrationList, "/activity/register/list", Get, "SessionFilter");
+    ADD_METHOD_TO(ActivityRegistrationController::reviewRegistration, "/activity/register/review", Post, "SessionFilter");
     ADD_METHOD_TO(ActivityRegistrationController::getApprovedRegistrationsByUser, "/activity/registration/approved", Post);
     ADD_METHOD_TO(ActivityRegistrationController::setPaymentStatus, "/activity/register/payment", Post);
     METHOD_LIST_END
 
-    void registerActivity(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
-    void cancelRegistration(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
-    void getRegistrationList(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
-    void reviewRegistration(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
-    void getApprovedRegistrationsByUser(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
-    void setPaymentStatus(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+    Task<> registerActivity(HttpRequestPtr req, std::function<void(const HttpResponsePtr &)> callback) const;
+    Task<> cancelRegistration(HttpRequestPtr req, std::function<void(const HttpResponsePtr &)> callback) const;
+    Task<> getRegistrationList(HttpRequestPtr req, std::function<void(const HttpResponsePtr &)> callback) const;
+    Task<> reviewRegistration(HttpRequestPtr req, std::function<void(const HttpResponsePtr &)> callback) const;
+    Task<> getApprovedRegistrationsByUser(HttpRequestPtr req, std::function<void(const HttpResponsePtr &)> callback) const;
+    Task<> setPaymentStatus(HttpRequestPtr req, std::function<void(const HttpResponsePtr &)> callback) const;
 };
\ No newline at end of file
@@ -1,45 +1,59 @@
 #include "ClubActivityController.h"
+#include "common/SessionToken.h"
+#include "dao/Db.h"
+#include "common/JsonStream.h"
+#include "common/RowJson.h"
+#include "dao/Pagination.h"
+#include "plugins/ActivityCalendar.h"
+#include "plugins/CheckinPipeline.h"
+#include "plugins/ClubStats.h"
+#include "plugins/DbRouter.h"
+#include "plugins/LiveCounters.h"
+#include "plugins/PermissionIndex.h"
+#include "plugins/SearchIndex.h"
+#include "plugins/SeatLedger.h"
 #include <drogon/HttpResponse.h>
 #include <drogon/HttpTypes.h>
 #include <drogon/orm/Exception.h>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 // 创建活动
-void ClubActivityController::createActivity(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback,
+Task<> ClubActivityController::createActivity(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback,
     ClubActivity activity) const {
-    auto dbClient = drogon::app().getDbClient();
     Json::Value response;
 
-    // 从 Cookie 中获取当前登录用户的 user_id
-    auto userIdCookie = req->getCookie("user_id");
-    if (userIdCookie.empty()) {
-        response["error"] = "未登录";
+    // 当前登录用户，由 SessionFilter 校验令牌后写入
+    int user_id = common::currentSession(req).userId;
+
+    if (activity.capacity < 0 || activity.waitlist_capacity < 0) {
+        response["error"] = "名额不能为负数";
         auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
-        resp->setStatusCode(k401Unauthorized);
+        resp->setStatusCode(k400BadRequest);
         callback(resp);
-        return;
+        co_return;
     }
 
-    int user_id = std::stoi(userIdCookie);
-
     try {
         // 验证用户是否是社团的创始人
-        auto roleResult = dbClient->execSqlSync(
-            "SELECT founder_id FROM club WHERE club_id = ?",
-            activity.club_id);
+        auto founder = co_await app().getPlugin<PermissionIndex>()->clubFounder(
+            activity.club_id, common::requestTiming(*req));
 
-        if (roleResult.empty() || roleResult[0]["founder_id"].as<int>() != user_id) {
+        if (founder != user_id) {
             response["error"] = "无权限操作，只有社团创始人可以创建活动";
             auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
             resp->setStatusCode(k403Forbidden);
             callback(resp);
-            return;
+            co_return;
         }
 
         // 检查活动标题是否已存在（同一社团内不能有重复标题）
-        auto result = dbClient->execSqlSync(
-            "SELECT COUNT(*) AS count FROM club_activity WHERE club_id = ? AND activity_title = ?",
+        auto result = co_await dao::exec(
+            req, dao::sql::kActivityCountByTitle,
             activity.club_id,
             activity.activity_title);
         if (result[0]["count"].as<int>() > 0) {
@@ -47,19 +61,26 @@ void ClubActivityController::createActivity(
             auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
             resp->setStatusCode(k400BadRequest);
             callback(resp);
-            return;
+            co_return;
         }
 
         // 插入活动数据到数据库，使用 NOW() 设置发布时间
-        dbClient->execSqlSync(
-            "INSERT INTO club_activity (club_id, activity_title, activity_time, activity_location, registration_method, activity_description, publish_time) "
-            "VALUES (?, ?, ?, ?, ?, ?, NOW())",
+        auto insertResult = co_await dao::exec(
+            req, dao::sql::kActivityInsert,
             activity.club_id,
             activity.activity_title,
             activity.activity_time.toDbStringLocal(),
             activity.activity_location,
             activity.registration_method,
-            activity.activity_description);
+            activity.activity_description,
+            activity.capacity,
+            activity.waitlist_capacity);
+        app().getPlugin<PermissionIndex>()->invalidateActivity(
+            static_cast<int>(insertResult.insertId()));
+        app().getPlugin<SearchIndex>()->refresh();
+        co_await app().getPlugin<ActivityCalendar>()->upsert(
+            static_cast<int>(insertResult.insertId()), common::requestTiming(*req));
+        app().getPlugin<ClubStats>()->invalidateClub(activity.club_id);
 
         response["message"] = "活动创建成功";
     } catch (const drogon::orm::DrogonDbException &e) {
@@ -73,33 +94,22 @@ void ClubActivityController::createActivity(
 }
 
 // 获取活动列表
-void ClubActivityController::getActivityList(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback, int clubId) const {
-    auto dbClient = drogon::app().getDbClient();
+Task<> ClubActivityController::getActivityList(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback, int clubId) const {
     Json::Value response;
 
     try {
         // 查询指定社团的所有活动
-        auto result = dbClient->execSqlSync(
-            "SELECT activity_id, activity_title, activity_time FROM club_activity "
-            "WHERE club_id = ?",
-            clubId);
-        Json::Value activities(Json::arrayValue);
-
-        for (const auto &row : result) {
-            Json::Value activity;
-            activity["activity_id"] = row["activity_id"].as<int>();
-            activity["activity_title"] = row["activity_title"].as<std::string>();
-            activity["activity_time"] = row["activity_time"].as<std::string>();
-            activities.append(activity);
-        }
-
-        response["activities"] = activities;
-        response["message"] = "活动列表获取成功";
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
-        resp->setStatusCode(k200OK); // 成功返回 200 OK
-        callback(resp);
+        auto result = co_await dao::exec(req, dao::sql::kActivityListByClub, clubId);
+
+        // 行直接写入输出缓冲区，不经过 Json::Value
+        auto &body = common::jsonBuffer();
+        body += "{\"message\":\"活动列表获取成功\",\"activities\":";
+        common::RowSerializer<common::ClubActivityRow>(result).writeArray(
+            result, result.size(), body);
+        body += '}';
+        callback(common::newJsonBodyResponse(body));
     } catch (const drogon::orm::DrogonDbException &e) {
         response["error"] = "数据库错误，无法获取活动列表";
         auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
@@ -109,17 +119,16 @@ void ClubActivityController::getActivityList(
 }
 
 // 获取活动详情
-void ClubActivityController::getActivityDetail(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback,
+Task<> ClubActivityController::getActivityDetail(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback,
     int activityId) const {
-    auto dbClient = drogon::app().getDbClient();
     Json::Value response;
 
     try {
         // 查询活动详情
-        auto result = dbClient->execSqlSync(
-            "SELECT * FROM club_activity WHERE activity_id = ?", activityId);
+        auto result =
+            co_await dao::exec(req, dao::sql::kActivityFindById, activityId);
 
         if (!result.empty()) {
             response["activity_id"] = result[0]["activity_id"].as<int>();
@@ -134,6 +143,12 @@ void ClubActivityController::getActivityDetail(
             response["activity_description"] =
                 result[0]["activity_description"].as<std::string>();
             response["publish_time"] = result[0]["publish_time"].as<std::string>();
+            // 名额上限，null 表示不限
+            response["capacity"] = result[0]["capacity"].isNull()
+                                       ? Json::Value()
+                                       : Json::Value(result[0]["capacity"].as<int>());
+            response["waitlist_capacity"] =
+                result[0]["waitlist_capacity"].as<int>();
 
             auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
             resp->setStatusCode(k200OK); // 成功返回 200 OK
@@ -152,32 +167,22 @@ void ClubActivityController::getActivityDetail(
     }
 }
 
-void ClubActivityController::updateActivity(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback,
+Task<> ClubActivityController::updateActivity(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback,
     int activityId) const {
-    auto dbClient = drogon::app().getDbClient();
     auto json = req->getJsonObject();
     Json::Value response;
 
-    // 从 Cookie 中获取当前登录用户的 user_id
-    auto userIdCookie = req->getCookie("user_id");
-    if (userIdCookie.empty()) {
-        response["error"] = "未登录";
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
-        resp->setStatusCode(k401Unauthorized);
-        callback(resp);
-        return;
-    }
-
-    int user_id = std::stoi(userIdCookie);
+    // 当前登录用户，由 SessionFilter 校验令牌后写入
+    int user_id = common::currentSession(req).userId;
 
     if (!json) {
         response["error"] = "请求体格式错误，请使用 JSON";
         auto resp = HttpResponse::newHttpJsonResponse(response);
         resp->setStatusCode(k400BadRequest);
         callback(resp);
-        return;
+        co_return;
     }
 
     // 获取请求体中的字段
@@ -187,29 +192,77 @@ void ClubActivityController::updateActivity(
     std::string registration_method = (*json)["registration_method"].asString();
     std::string activity_description = (*json)["activity_description"].asString();
 
+    // 名额为可选字段，只在请求中给出时修改
+    bool hasCapacity = json->isMember("capacity");
+    bool hasWaitlistCapacity = json->isMember("waitlist_capacity");
+    int capacity = (*json)["capacity"].asInt();
+    int waitlist_capacity = (*json)["waitlist_capacity"].asInt();
+    if (capacity < 0 || waitlist_capacity < 0) {
+        response["error"] = "名额不能为负数";
+        auto resp = HttpResponse::newHttpJsonResponse(response);
+        resp->setStatusCode(k400BadRequest);
+        callback(resp);
+        co_return;
+    }
+
     try {
         // 验证用户是否是社团的创始人
-        auto roleResult = dbClient->execSqlSync(
-            "SELECT c.founder_id FROM club c "
-            "JOIN club_activity a ON c.club_id = a.club_id "
-            "WHERE a.activity_id = ?",
-            activityId);
+        auto founder = co_await app().getPlugin<PermissionIndex>()->activityFounder(
+            activityId, common::requestTiming(*req));
 
-        if (roleResult.empty() || roleResult[0]["founder_id"].as<int>() != user_id) {
+        if (founder != user_id) {
             response["error"] = "无权限操作，只有社团创始人可以更新活动";
             auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
             resp->setStatusCode(k403Forbidden);
             callback(resp);
-            return;
+            co_return;
         }
 
-        // 更新活动信息
-        dbClient->execSqlSync(
-            "UPDATE club_activity SET activity_title = ?, activity_time = ?, "
-            "activity_location = ?, registration_method = ?, activity_description = ? "
-            "WHERE activity_id = ?",
-            activity_title, activity_time, activity_location, registration_method,
-            activity_description, activityId);
+        // 活动信息与名额在同一事务中更新，要么都生效要么都不生效
+        auto *timing = common::requestTiming(*req);
+        auto trans = co_await app().getDbClient()->newTransactionCoro();
+        try {
+            co_await dao::exec(
+                trans, timing, dao::sql::kActivityUpdate,
+                activity_title, activity_time, activity_location, registration_method,
+                activity_description, activityId);
+            if (hasCapacity) {
+                co_await dao::exec(trans, timing, dao::sql::kActivityUpdateCapacity,
+                                   capacity, activityId);
+            }
+            if (hasWaitlistCapacity) {
+                co_await dao::exec(trans, timing,
+                                   dao::sql::kActivityUpdateWaitlistCapacity,
+                                   waitlist_capacity, activityId);
+            }
+        } catch (const drogon::orm::DrogonDbException &) {
+            trans->rollback();
+            throw;
+        }
+        if (!co_await dao::commit(std::move(trans))) {
+            response["error"] = "数据库错误，无法更新活动";
+            auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
+            resp->setStatusCode(k500InternalServerError);
+            callback(resp);
+            co_return;
+        }
+        app().getPlugin<DbRouter>()->recordWrite(req);
+
+        app().getPlugin<SearchIndex>()->refresh();
+        co_await app().getPlugin<ActivityCalendar>()->upsert(activityId, timing);
+
+        if (hasCapacity || hasWaitlistCapacity) {
+            // 按新上限重新计数，扩容空出的名额递补给候补名单
+            auto ledger = app().getPlugin<SeatLedger>();
+            ledger->invalidate(activityId);
+            try {
+                co_await ledger->promote(activityId, timing);
+            } catch (const drogon::orm::DrogonDbException &e) {
+                // 更新已生效；递补留待下一次取消或名额调整
+                LOG_ERROR << "候补递补失败: " << e.base().what();
+            }
+        }
+        app().getPlugin<ClubStats>()->invalidateActivity(activityId);
 
         response["message"] = "活动更新成功";
         auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
@@ -224,43 +277,37 @@ void ClubActivityController::updateActivity(
 }
 
 // 删除活动
-void ClubActivityController::deleteActivity(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback,
+Task<> ClubActivityController::deleteActivity(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback,
     int activityId) const {
-    auto dbClient = drogon::app().getDbClient();
     Json::Value response;
 
-    // 从 Cookie 中获取当前登录用户的 user_id
-    auto userIdCookie = req->getCookie("user_id");
-    if (userIdCookie.empty()) {
-        response["error"] = "未登录";
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
-        resp->setStatusCode(k401Unauthorized);
-        callback(resp);
-        return;
-    }
-
-    int user_id = std::stoi(userIdCookie);
+    // 当前登录用户，由 SessionFilter 校验令牌后写入
+    int user_id = common::currentSession(req).userId;
 
     try {
         // 验证用户是否是社团的创始人
-        auto roleResult = dbClient->execSqlSync(
-            "SELECT c.founder_id FROM club c "
-            "JOIN club_activity a ON c.club_id = a.club_id "
-            "WHERE a.activity_id = ?",
-            activityId);
+        auto founder = co_await app().getPlugin<PermissionIndex>()->activityFounder(
+            activityId, common::requestTiming(*req));
 
-        if (roleResult.empty() || roleResult[0]["founder_id"].as<int>() != user_id) {
+        if (founder != user_id) {
             response["error"] = "无权限操作，只有社团创始人可以删除活动";
             auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
             resp->setStatusCode(k403Forbidden);
             callback(resp);
-            return;
+            co_return;
         }
 
         // 删除活动
-        dbClient->execSqlSync("DELETE FROM club_activity WHERE activity_id = ?", activityId);
+        co_await dao::exec(req, dao::sql::kActivityDelete, activityId);
+        app().getPlugin<PermissionIndex>()->invalidateActivity(activityId);
+        app().getPlugin<CheckinPipeline>()->forgetActivity(activityId);
+        app().getPlugin<SeatLedger>()->invalidate(activityId);
+        app().getPlugin<SearchIndex>()->refresh();
+        app().getPlugin<ActivityCalendar>()->remove(activityId);
+        app().getPlugin<LiveCounters>()->forgetActivity(activityId);
+        app().getPlugin<ClubStats>()->invalidateActivity(activityId);
         response["message"] = "活动删除成功";
     } catch (const drogon::orm::DrogonDbException &e) {
         response["error"] = "数据库错误，无法删除活动";
@@ -272,77 +319,50 @@ void ClubActivityController::deleteActivity(
 }
 
 // 获取用户所属社团的所有活动
-void ClubActivityController::getAllActivitiesByUser(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback) const {
-    auto dbClient = drogon::app().getDbClient();
+Task<> ClubActivityController::getAllActivitiesByUser(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback) const {
     Json::Value response;
 
-    // 从 Cookie 中获取当前登录用户的 user_id
-    auto userIdCookie = req->getCookie("user_id");
-    if (userIdCookie.empty()) {
-        response["error"] = "未登录";
-        auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
-        resp->setStatusCode(k401Unauthorized); // 未授权
-        callback(resp);
-        return;
-    }
-
-    int user_id = std::stoi(userIdCookie);
+    // 当前登录用户，由 SessionFilter 校验令牌后写入
+    int user_id = common::currentSession(req).userId;
 
     try {
-        // 查询用户所属的所有社团
-        auto clubResult = dbClient->execSqlSync(
-            "SELECT c.club_id, c.club_name FROM club_member m "
-            "JOIN club c ON m.club_id = c.club_id "
-            "WHERE m.user_id = ?",
-            user_id);
-
-        if (clubResult.empty()) {
+        // 一次查询取回用户所属社团的全部活动及报名状态
+        auto result =
+            co_await dao::exec(req, dao::sql::kMemberActivityFeed, user_id);
+
+        if (result.empty()) {
             response["error"] = "您没有加入任何社团";
             auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
             resp->setStatusCode(k404NotFound); // 未找到
             callback(resp);
-            return;
+            co_return;
         }
 
         Json::Value activities(Json::arrayValue);
 
-        // 遍历每个社团，查询其活动列表
-        for (const auto &clubRow : clubResult) {
-            int club_id = clubRow["club_id"].as<int>();
-            std::string club_name = clubRow["club_name"].as<std::string>();
-
-            auto activityResult = dbClient->execSqlSync(
-                "SELECT a.activity_id, a.activity_title, a.activity_time, a.activity_location, a.activity_description "
-                "FROM club_activity a "
-                "WHERE a.club_id = ?",
-                club_id);
-
-            for (const auto &activityRow : activityResult) {
-                Json::Value activity;
-                activity["club_id"] = club_id;
-                activity["club_name"] = club_name;
-                activity["activity_id"] = activityRow["activity_id"].as<int>();
-                activity["activity_title"] = activityRow["activity_title"].as<std::string>();
-                activity["activity_time"] = activityRow["activity_time"].as<std::string>();
-                activity["activity_location"] = activityRow["activity_location"].as<std::string>();
-                activity["activity_description"] = activityRow["activity_description"].as<std::string>();
-
-                // 查询报名状态
-                auto registrationResult = dbClient->execSqlSync(
-                    "SELECT registration_status FROM activity_registration "
-                    "WHERE user_id = ? AND activity_id = ?",
-                    user_id, activityRow["activity_id"].as<int>());
-
-                if (!registrationResult.empty()) {
-                    activity["registration_status"] = registrationResult[0]["registration_status"].as<std::string>();
-                } else {
-                    activity["registration_status"] = "none"; // 未报名
-                }
-
-                activities.append(activity);
+        for (const auto &row : result) {
+            // 没有活动的社团只占一行，activity_id 为 NULL
+            if (row["activity_id"].isNull()) {
+                continue;
             }
+
+            Json::Value activity;
+            activity["club_id"] = row["club_id"].as<int>();
+            activity["club_name"] = row["club_name"].as<std::string>();
+            activity["activity_id"] = row["activity_id"].as<int>();
+            activity["activity_title"] = row["activity_title"].as<std::string>();
+            activity["activity_time"] = row["activity_time"].as<std::string>();
+            activity["activity_location"] = row["activity_location"].as<std::string>();
+            activity["activity_description"] = row["activity_description"].as<std::string>();
+            // 没有报名记录时为 none（未报名）
+            activity["registration_status"] =
+                row["registration_status"].isNull()
+                    ? "none"
+                    : row["registration_status"].as<std::string>();
+
+            activities.append(activity);
         }
 
         response["activities"] = activities;
@@ -359,10 +379,9 @@ void ClubActivityController::getAllActivitiesByUser(
     }
 }
 
-void ClubActivityController::getAllActivitiesByClub(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback) const {
-    auto dbClient = drogon::app().getDbClient();
+Task<> ClubActivityController::getAllActivitiesByClub(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback) const {
     Json::Value response;
 
     // 从请求体中获取 club_id
@@ -372,24 +391,22 @@ void ClubActivityController::getAllActivitiesByClub(
         auto resp = HttpResponse::newHttpJsonResponse(response);
         resp->setStatusCode(k400BadRequest); // 错误请求
         callback(resp);
-        return;
+        co_return;
     }
 
     int clubId = (*json)["club_id"].asInt();
 
     try {
         // 查询指定社团的所有活动
-        auto activityResult = dbClient->execSqlSync(
-            "SELECT activity_id, activity_title, activity_time, activity_location, activity_description "
-            "FROM club_activity WHERE club_id = ?",
-            clubId);
+        auto activityResult =
+            co_await dao::exec(req, dao::sql::kActivityDetailsByClub, clubId);
 
         if (activityResult.empty()) {
             response["error"] = "该社团没有任何活动";
             auto resp = HttpResponse::newHttpJsonResponse(response);
             resp->setStatusCode(k404NotFound); // 未找到
             callback(resp);
-            return;
+            co_return;
         }
 
         Json::Value activities(Json::arrayValue);
@@ -419,11 +436,10 @@ void ClubActivityController::getAllActivitiesByClub(
     }
 }
 
-void ClubActivityController::getActivityRegistrationsByClub(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback) const {
+Task<> ClubActivityController::getActivityRegistrationsByClub(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback) const {
 
-    auto dbClient = drogon::app().getDbClient();
     Json::Value response;
 
     // 从请求体中获取 club_id
@@ -433,50 +449,64 @@ void ClubActivityController::getActivityRegistrationsByClub(
         auto resp = HttpResponse::newHttpJsonResponse(response);
         resp->setStatusCode(k400BadRequest);
         callback(resp);
-        return;
+        co_return;
     }
 
     int clubId = (*json)["club_id"].asInt();
 
+    // 分页参数来自查询串：after_id / cursor、limit
+    dao::IdPage page;
+    if (!dao::parseIdPage(req, page)) {
+        response["error"] = "无效的分页参数: after_id、cursor 或 limit";
+        auto resp = HttpResponse::newHttpJsonResponse(response);
+        resp->setStatusCode(k400BadRequest);
+        callback(resp);
+        co_return;
+    }
+
     try {
-        // 查询某社团下所有活动的报名情况
-        auto result = dbClient->execSqlSync(
-            "SELECT a.activity_id, a.activity_title, r.registration_id, r.user_id, u.username, "
-            "r.registration_date, r.payment_status, r.registration_status "
-            "FROM club_activity a "
-            "JOIN activity_registration r ON a.activity_id = r.activity_id "
-            "JOIN user u ON r.user_id = u.user_id "
-            "WHERE a.club_id = ?",
-            clubId);
+        // ?stream=1 时按 limit 分页流式输出 after_id 之后的全部报名
+        if (common::wantsStream(req)) {
+            auto result = co_await dao::exec(req, dao::sql::kRegistrationDetailsByClub,
+                                             clubId, page.afterId, page.limit);
+            callback(common::newJsonPageStreamResponse(
+                std::move(result),
+                [req, clubId](int afterId, int limit) -> Task<drogon::orm::Result> {
+                    co_return co_await dao::exec(
+                        req, dao::sql::kRegistrationDetailsByClub, clubId, afterId,
+                        limit);
+                },
+                page.limit, "registration_id",
+                "{\"message\":\"报名信息获取成功\",\"registrations\":[",
+                common::writeRows<common::RegistrationRow>, "]}"));
+            co_return;
+        }
+
+        // 按 registration_id 分页查询某社团下所有活动的报名情况，
+        // 多取一行判断是否还有下一页
+        auto result = co_await dao::exec(req, dao::sql::kRegistrationDetailsByClub,
+                                         clubId, page.afterId, page.limit + 1);
 
         if (result.empty()) {
             response["message"] = "该社团暂无活动报名数据";
             response["registrations"] = Json::arrayValue;
+            response["next_cursor"] = Json::Value();
             auto resp = HttpResponse::newHttpJsonResponse(response);
             resp->setStatusCode(k200OK);
             callback(resp);
-            return;
+            co_return;
         }
 
-        Json::Value registrations(Json::arrayValue);
-        for (const auto &row : result) {
-            Json::Value reg;
-            reg["registration_id"] = row["registration_id"].as<int>();
-            reg["user_id"] = row["user_id"].as<int>();
-            reg["user_name"] = row["username"].as<std::string>();  // ✅ 使用 username 字段
-            reg["activity_id"] = row["activity_id"].as<int>();
-            reg["activity_title"] = row["activity_title"].as<std::string>();
-            reg["registration_date"] = row["registration_date"].as<std::string>();
-            reg["payment_status"] = row["payment_status"].as<std::string>();
-            reg["registration_status"] = row["registration_status"].as<std::string>();
-            registrations.append(reg);
-        }
-
-        response["registrations"] = registrations;
-        response["message"] = "报名信息获取成功";
-        auto resp = HttpResponse::newHttpJsonResponse(response);
-        resp->setStatusCode(k200OK);
-        callback(resp);
+        // 行直接写入输出缓冲区，不经过 Json::Value
+        auto &body = common::jsonBuffer();
+        body += "{\"message\":\"报名信息获取成功\",\"registrations\":";
+        common::RowSerializer<common::RegistrationRow>(result).writeArray(
+            result, dao::pageSize(result, page), body);
+        body += ",\"next_cursor\":";
+        common::appendJsonScalar(
+            body, dao::nextIdCursor(result, page, "registration_id"));
+        body += '}';
+        callback(common::newJsonBodyResponse(body));
 
     } catch (const drogon::orm::DrogonDbException &e) {
         LOG_ERROR << "Database error: " << e.base().what();
@@ -487,3 +517,129 @@ void ClubActivityController::getActivityRegistrationsByClub(
     }
 }
 
+
+// 即将举行的活动，从内存日历中按时间范围读取，可按社团过滤
+Task<> ClubActivityController::getUpcomingActivities(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback) const {
+    Json::Value response;
+    auto badRequest = [&](const char *error) {
+        response["error"] = error;
+        auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
+        resp->setStatusCode(k400BadRequest);
+        callback(resp);
+    };
+
+    // 起点：?from=YYYY-MM-DD 当天零点，缺省为当前时刻
+    std::string from = req->getParameter("from");
+    if (from.empty()) {
+        from = trantor::Date::now().toDbStringLocal();
+    } else if (from.size() != 10 || !ActivityCalendar::dayNumber(from)) {
+        badRequest("无效的起始日期，格式为 YYYY-MM-DD");
+        co_return;
+    }
+
+    // 天数：?days=，缺省 7，最多 90
+    int days = 7;
+    const auto &daysParam = req->getParameter("days");
+    if (!daysParam.empty()) {
+        try {
+            size_t used = 0;
+            days = std::stoi(daysParam, &used);
+            if (used != daysParam.size()) {
+                days = 0;
+            }
+        } catch (const std::exception &) {
+            days = 0;
+        }
+        if (days < 1 || days > 90) {
+            badRequest("无效的天数，应为 1 到 90");
+            co_return;
+        }
+    }
+    std::string to = trantor::Date::fromDbStringLocal(from)
+                         .after(static_cast<double>(days) * 86400)
+                         .toDbStringLocal();
+
+    // 社团过滤：?club_ids=1,2,3，缺省不限
+    std::vector<int> clubIds;
+    std::string clubParam = req->getParameter("club_ids");
+    for (size_t start = 0; start < clubParam.size();) {
+        size_t end = clubParam.find(',', start);
+        if (end == std::string::npos) {
+            end = clubParam.size();
+        }
+        try {
+            size_t used = 0;
+            auto token = clubParam.substr(start, end - start);
+            clubIds.push_back(std::stoi(token, &used));
+            if (used != token.size()) {
+                throw std::invalid_argument(token);
+            }
+        } catch (const std::exception &) {
+            badRequest("无效的社团列表，格式为逗号分隔的 club_id");
+            co_return;
+        }
+        start = end + 1;
+    }
+    std::sort(clubIds.begin(), clubIds.end());
+
+    int limit = dao::pageLimit(req);
+    if (limit < 0) {
+        badRequest("无效的分页参数: limit");
+        co_return;
+    }
+
+    auto calendar = app().getPlugin<ActivityCalendar>();
+    if (!calendar->ready()) {
+        response["error"] = "活动日历正在加载，请稍后重试";
+        auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
+        resp->setStatusCode(k503ServiceUnavailable);
+        resp->addHeader("Retry-After", "1");
+        callback(resp);
+        co_return;
+    }
+
+    // 各活动的 JSON 在放进日历时已序列化好，这里只做拼接
+    bool more = false;
+    auto &body = common::jsonBuffer();
+    body += "{\"from\":";
+    common::appendJsonString(body, from);
+    body += ",\"to\":";
+    common::appendJsonString(body, to);
+    body += ",\"activities\":[";
+    calendar->write(from, to, clubIds, static_cast<size_t>(limit), body, more);
+    body += "],\"has_more\":";
+    body += more ? "true" : "false";
+    body += '}';
+    callback(common::newJsonBodyResponse(body));
+}
+
+// 活动的报名与签到人数
+Task<> ClubActivityController::getActivityCounts(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback,
+    int activityId) const {
+    Json::Value response;
+
+    auto counters = app().getPlugin<LiveCounters>();
+    if (!counters->ready()) {
+        response["error"] = "计数尚未加载完成，请稍后重试";
+        auto resp = HttpResponse::newHttpJsonResponse(response);
+        resp->setStatusCode(k503ServiceUnavailable);
+        callback(resp);
+        co_return;
+    }
+
+    auto counts = counters->activity(activityId);
+    response["activity_id"] = activityId;
+    // 占用名额的报名：待审核与已通过
+    response["registered"] = counts.pending + counts.accepted;
+    response["pending"] = counts.pending;
+    response["accepted"] = counts.accepted;
+    response["waitlist"] = counts.waitlist;
+    response["checked_in"] = counts.checkedIn;
+    auto resp = HttpResponse::newHttpJsonResponse(response);
+    resp->setStatusCode(k200OK);
+    callback(resp);
+}
@@ -1,5 +1,7 @@
 #pragma once
+#include "common/RequestSchema.h"
 #include <drogon/HttpController.h>
+#include <drogon/utils/coroutine.h>
 
 using namespace drogon;
 
@@ -12,6 +14,8 @@ struct ClubActivity {
   std::string registration_method;  // 报名方式
   std::string activity_description; // 活动描述
   trantor::Date publish_time;       // 发布时间
+  int capacity;                     // 名额上限，0 表示不限
+  int waitlist_capacity;            // 候补名额上限，0 表示不设候补
 };
 
 class ClubActivityController
@@ -19,102 +23,97 @@ class ClubActivityController
 public:
   METHOD_LIST_BEGIN
   ADD_METHOD_TO(ClubActivityController::createActivity, "/activity/create",
-                Post);
+                Post, "SessionFilter");
   ADD_METHOD_TO(ClubActivityController::getActivityList, "/activity/list/{1}",
                 Get);
   ADD_METHOD_TO(ClubActivityController::getActivityDetail,
                 "/activity/detail/{1}", Get);
   ADD_METHOD_TO(ClubActivityController::updateActivity, "/activity/update/{1}",
-                Put);
+                Put, "SessionFilter");
   ADD_METHOD_TO(ClubActivityController::deleteActivity, "/activity/delete/{1}",
-                Delete);
+                Delete, "SessionFilter");
   // 获取当前用户所属社团的所有活动
   ADD_METHOD_TO(ClubActivityController::getAllActivitiesByUser,
-                "/club/activity/all_by_user", Get);
+                "/club/activity/all_by_user", Get, "SessionFilter");
   ADD_METHOD_TO(ClubActivityController::getAllActivitiesByClub,
                 "/club/activity/all_by_club", Post);
   ADD_METHOD_TO(ClubActivityController::getActivityRegistrationsByClub,
                 "/club/activity/registrations", Post);
+  // 即将举行的活动：?from=YYYY-MM-DD&days=&club_ids=1,2&limit=
+  ADD_METHOD_TO(ClubActivityController::getUpcomingActivities,
+                "/activity/upcoming", Get);
+  // 报名与签到人数，取自内存计数
+  ADD_METHOD_TO(ClubActivityController::getActivityCounts,
+                "/activity/counts/{1}", Get);
 
   METHOD_LIST_END
 
-  void createActivity(const HttpRequestPtr &req,
-                      std::function<void(const HttpResponsePtr &)> &&callback,
-                      ClubActivity activity) const;
+  Task<> createActivity(HttpRequestPtr req,
+                        std::function<void(const HttpResponsePtr &)> callback,
+                        ClubActivity activity) const;
 
-  void getActivityList(const HttpRequestPtr &req,
-                       std::function<void(const HttpResponsePtr &)> &&callback,
-                       int clubId) const;
-  void
-  getActivityDetail(const HttpRequestPtr &req,
-                    std::function<void(const HttpResponsePtr &)> &&callback,
+  Task<> getActivityList(HttpRequestPtr req,
+                         std::function<void(const HttpResponsePtr &)> callback,
+                         int clubId) const;
+  Task<>
+  getActivityDetail(HttpRequestPtr req,
+                    std::function<void(const HttpResponsePtr &)> callback,
                     int activityId) const;
-  void updateActivity(const HttpRequestPtr &req,
-                      std::function<void(const HttpResponsePtr &)> &&callback,
-                      int activityId) const;
-  void deleteActivity(const HttpRequestPtr &req,
-                      std::function<void(const HttpResponsePtr &)> &&callback,
-                      int activityId) const;
+  Task<> updateActivity(HttpRequestPtr req,
+                        std::function<void(const HttpResponsePtr &)> callback,
+                        int activityId) const;
+  Task<> deleteActivity(HttpRequestPtr req,
+                        std::function<void(const HttpResponsePtr &)> callback,
+                        int activityId) const;
 
   // 获取当前用户所属社团的所有活动方法
-  void getAllActivitiesByUser(
-      const HttpRequestPtr &req,
-      std::function<void(const HttpResponsePtr &)> &&callback) const;
-  void getAllActivitiesByClub(
-      const HttpRequestPtr &req,
-      std::function<void(const HttpResponsePtr &)> &&callback) const;
-  void getActivityRegistrationsByClub(
-      const HttpRequestPtr &req,
-      std::function<void(const HttpResponsePtr &)> &&callback) const;
+  Task<> getAllActivitiesByUser(
+      HttpRequestPtr req,
+      std::function<void(const HttpResponsePtr &)> callback) const;
+  Task<> getAllActivitiesByClub(
+      HttpRequestPtr req,
+      std::function<void(const HttpResponsePtr &)> callback) const;
+  Task<> getActivityRegistrationsByClub(
+      HttpRequestPtr req,
+      std::function<void(const HttpResponsePtr &)> callback) const;
+  Task<> getUpcomingActivities(
+      HttpRequestPtr req,
+      std::function<void(const HttpResponsePtr &)> callback) const;
+  Task<>
+  getActivityCounts(HttpRequestPtr req,
+                    std::function<void(const HttpResponsePtr &)> callback,
+                    int activityId) const;
+};
+
+// 请求体字段表，校验顺序与错误信息同原先逐字段解析一致
+template <> struct common::RequestSchema<ClubActivity> {
+  static constexpr common::RequestField<ClubActivity> fields[] = {
+      {.key = "activity_title",
+       .text = &ClubActivity::activity_title,
+       .missing = "缺少必备字段: activity_title",
+       .minLength = 1,
+       .tooShort = "活动标题不能为空"},
+      {.key = "activity_time",
+       .date = &ClubActivity::activity_time,
+       .missing = "缺少必备字段: activity_time",
+       .minLength = 1,
+       .tooShort = "活动时间不能为空"},
+      {.key = "activity_location", .text = &ClubActivity::activity_location},
+      {.key = "registration_method",
+       .text = &ClubActivity::registration_method},
+      {.key = "activity_description",
+       .text = &ClubActivity::activity_description},
+      {.key = "club_id",
+       .number = &ClubActivity::club_id,
+       .missing = "缺少必备字段: club_id"},
+      {.key = "capacity", .number = &ClubActivity::capacity},
+      {.key = "waitlist_capacity", .number = &ClubActivity::waitlist_capacity},
+  };
 };
 
+// 自定义从请求中解析 ClubActivity 对象的方法：单遍扫描请求体，不构建 Json::Value
 namespace drogon {
 template <> inline ClubActivity fromRequest(const HttpRequest &req) {
-  auto json = req.getJsonObject();
-  ClubActivity value;
-
-  if (json == nullptr) {
-    throw std::runtime_error("请求体格式错误，请使用 JSON");
-  }
-
-  // 解析活动标题
-  if (json->isMember("activity_title")) {
-    const auto &temp = (*json)["activity_title"].asString();
-    if (temp.empty()) {
-      throw std::runtime_error("活动标题不能为空");
-    }
-    value.activity_title = temp;
-  } else {
-    throw std::runtime_error("缺少必备字段: activity_title");
-  }
-
-  // 解析活动时间
-  if (json->isMember("activity_time")) {
-    const auto &temp = (*json)["activity_time"].asString();
-    if (temp.empty()) {
-      throw std::runtime_error("活动时间不能为空");
-    }
-    value.activity_time = trantor::Date::fromDbStringLocal(temp);
-  } else {
-    throw std::runtime_error("缺少必备字段: activity_time");
-  }
-
-  // 解析活动地点
-  value.activity_location = json->get("activity_location", "").asString();
-
-  // 解析报名方式
-  value.registration_method = json->get("registration_method", "").asString();
-
-  // 解析活动描述
-  value.activity_description = json->get("activity_description", "").asString();
-
-  // 解析社团 ID
-  if (json->isMember("club_id")) {
-    value.club_id = (*json)["club_id"].asInt();
-  } else {
-    throw std::runtime_error("缺少必备字段: club_id");
-  }
-
-  return value;
+  return common::parseRequest<ClubActivity>(req);
 }
 } // namespace drogon
\ No newline at end of file
@@ -1,25 +1,23 @@
 #include "ClubApprovalController.h"
+#include "common/SessionToken.h"
+#include "dao/Db.h"
+#include "dao/Pagination.h"
+#include "plugins/ClubCatalog.h"
+#include "plugins/LiveCounters.h"
+#include "plugins/PermissionIndex.h"
+#include "plugins/SearchIndex.h"
+#include "plugins/SessionManager.h"
 #include <drogon/HttpResponse.h>
 #include <drogon/HttpTypes.h>
 #include <drogon/orm/Exception.h>
 
-void ClubApprovalController::submitApproval(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback) const {
-  auto dbClient = drogon::app().getDbClient();
+Task<> ClubApprovalController::submitApproval(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback) const {
   Json::Value response;
 
-  // 从 Cookie 中获取当前登录用户的 user_id
-  auto userIdCookie = req->getCookie("user_id");
-  if (userIdCookie.empty()) {
-    response["error"] = "未登录";
-    auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
-    resp->setStatusCode(k401Unauthorized);
-    callback(resp);
-    return;
-  }
-
-  int user_id = std::stoi(userIdCookie);
+  // 当前登录用户，由 SessionFilter 校验令牌后写入
+  int user_id = common::currentSession(req).userId;
 
   // 获取请求体中的字段
   auto json = req->getJsonObject();
@@ -31,7 +29,7 @@ void ClubApprovalController::submitApproval(
     auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
     resp->setStatusCode(k400BadRequest);
     callback(resp);
-    return;
+    co_return;
   }
 
   std::string club_name = (*json)["club_name"].asString();
@@ -45,7 +43,7 @@ void ClubApprovalController::submitApproval(
     auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
     resp->setStatusCode(k400BadRequest);
     callback(resp);
-    return;
+    co_return;
   }
 
   if (contact_info.empty() || contact_info.size() > 100) {
@@ -53,7 +51,7 @@ void ClubApprovalController::submitApproval(
     auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
     resp->setStatusCode(k400BadRequest);
     callback(resp);
-    return;
+    co_return;
   }
 
   if (activity_venue.empty() || activity_venue.size() > 100) {
@@ -61,17 +59,13 @@ void ClubApprovalController::submitApproval(
     auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
     resp->setStatusCode(k400BadRequest);
     callback(resp);
-    return;
+    co_return;
   }
 
   try {
     // 插入审批记录到 club_approval 表
-    dbClient->execSqlSync(
-        "INSERT INTO club_approval (club_name, club_introduction, "
-        "contact_info, activity_venue, applicant_id, approval_status, "
-        "approval_opinion, approval_time) "
-        "VALUES (?, ?, ?, ?, ?, '待审核', NULL, NOW())",
-        club_name, club_introduction, contact_info, activity_venue, user_id);
+    co_await dao::exec(req, dao::sql::kApprovalInsert, club_name, club_introduction,
+                       contact_info, activity_venue, user_id);
 
     response["message"] = "审批申请已提交，等待管理员审批";
   } catch (const drogon::orm::DrogonDbException &e) {
@@ -84,39 +78,25 @@ void ClubApprovalController::submitApproval(
   callback(resp);
 }
 
-void ClubApprovalController::approveClub(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback,
+Task<> ClubApprovalController::approveClub(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback,
     int approvalId) const {
-  auto dbClient = drogon::app().getDbClient();
   Json::Value response;
 
-  // 从 Cookie 中获取当前登录管理员的 user_id
-  auto userIdCookie = req->getCookie("user_id");
-  if (userIdCookie.empty()) {
-    response["error"] = "未登录";
+  // 当前登录用户，由 SessionFilter 校验令牌后写入
+  const auto &session = common::currentSession(req);
+
+  // 验证用户是否为管理员，角色取自会话令牌
+  if (session.userType != "管理员") {
+    response["error"] = "无权限操作，只有管理员可以审批";
     auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
-    resp->setStatusCode(k401Unauthorized);
+    resp->setStatusCode(k403Forbidden);
     callback(resp);
-    return;
+    co_return;
   }
 
-  int admin_id = std::stoi(userIdCookie);
-
   try {
-    // 验证用户是否为管理员
-    auto userResult = dbClient->execSqlSync(
-        "SELECT user_type FROM user WHERE user_id = ?", admin_id);
-
-    if (userResult.empty() ||
-        userResult[0]["user_type"].as<std::string>() != "管理员") {
-      response["error"] = "无权限操作，只有管理员可以审批";
-      auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
-      resp->setStatusCode(k403Forbidden);
-      callback(resp);
-      return;
-    }
-
     // 获取请求体中的审批状态和意见
     auto json = req->getJsonObject();
     if (!json || !json->isMember("approval_status") ||
@@ -125,7 +105,7 @@ void ClubApprovalController::approveClub(
       auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
       resp->setStatusCode(k400BadRequest);
       callback(resp);
-      return;
+      co_return;
     }
 
     std::string approval_status = (*json)["approval_status"].asString();
@@ -133,17 +113,14 @@ void ClubApprovalController::approveClub(
 
     // 查询审批记录，获取所有相关字段
     auto approvalResult =
-        dbClient->execSqlSync("SELECT club_name, club_introduction, "
-                              "contact_info, activity_venue, applicant_id "
-                              "FROM club_approval WHERE approval_id = ?",
-                              approvalId);
+        co_await dao::exec(req, dao::sql::kApprovalFindById, approvalId);
 
     if (approvalResult.empty()) {
       response["error"] = "未找到对应的审批记录";
       auto resp = drogon::HttpResponse::newHttpJsonResponse(response);
       resp->setStatusCode(k404NotFound);
       callback(resp);
-      return;
+      co_return;
     }
 
     std::string club_name = approvalResult[0]["club_name"].as<std::string>();
@@ -158,35 +135,36 @@ void ClubApprovalController::approveClub(
     // 如果审批通过，创建社团并设置申请用户为社长
     if (approval_status == "通过") {
       // 插入社团记录到 club 表
-      auto clubResult = dbClient->execSqlSync(
-          "INSERT INTO club (club_name, club_introduction, contact_info, "
-          "activity_venue, founder_id) "
-          "VALUES (?, ?, ?, ?, ?)",
-          club_name, club_introduction, contact_info, activity_venue,
-          applicant_id);
+      auto clubResult =
+          co_await dao::exec(req, dao::sql::kClubInsert, club_name,
+                             club_introduction, contact_info, activity_venue,
+                             applicant_id);
 
       int club_id = clubResult.insertId();
       // 检查申请用户是否为管理员
-      auto applicantResult = dbClient->execSqlSync(
-          "SELECT user_type FROM user WHERE user_id = ?", applicant_id);
+      auto applicantResult =
+          co_await dao::exec(req, dao::sql::kUserTypeById, applicant_id);
       if (!applicantResult.empty() &&
           applicantResult[0]["user_type"].as<std::string>() != "管理员") {
         // 更新 user 表中的 user_type 为 '社长'
-        dbClient->execSqlSync(
-            "UPDATE user SET user_type = '社长' WHERE user_id = ?",
-            applicant_id);
+        co_await dao::exec(req, dao::sql::kUserPromotePresident, applicant_id);
+        // 旧令牌中的角色已过期，申请者需重新登录以获得社长身份
+        app().getPlugin<SessionManager>()->revokeUser(applicant_id);
       }
       // 将申请者添加到社团成员里并设置为社长
-      dbClient->execSqlSync("INSERT INTO club_member (user_id, club_id, "
-                            "join_date, member_role) "
-                            "VALUES (?, ?, NOW(), '社长')",
-                            applicant_id, club_id);
+      co_await dao::exec(req, dao::sql::kMemberInsertPresident, applicant_id,
+                         club_id);
+      app().getPlugin<LiveCounters>()->memberJoined(club_id);
+      app().getPlugin<PermissionIndex>()->invalidateClub(club_id);
+      // 发布包含新社团的目录快照
+      co_await app().getPlugin<ClubCatalog>()->rebuild(
+          common::requestTiming(*req));
+      app().getPlugin<SearchIndex>()->refresh();
     }
 
     // 更新审批记录
-    dbClient->execSqlSync("UPDATE club_approval SET approval_status = ?, "
-                          "approval_opinion = ? WHERE approval_id = ?",
-                          approval_status, approval_opinion, approvalId);
+    co_await dao::exec(req, dao::sql::kApprovalUpdateStatus, approval_status,
+                       approval_opinion, approvalId);
 
     response["message"] = "审批成功";
   } catch (const drogon::orm::DrogonDbException &e) {
@@ -199,64 +177,38 @@ void ClubApprovalController::approveClub(
   callback(resp);
 }
 
-void ClubApprovalController::getApprovalList(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback) const {
-  auto dbClient = drogon::app().getDbClient();
+Task<> ClubApprovalController::getApprovalList(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback) const {
   Json::Value response;
 
-  // 从 Cookie 中获取当前登录用户的 user_id
-  auto userIdCookie = req->getCookie("user_id");
-  if (userIdCookie.empty()) {
-    response["error"] = "未登录";
+  // 当前登录用户，由 SessionFilter 校验令牌后写入
+  const auto &session = common::currentSession(req);
+  int user_id = session.userId;
+
+  // 分页参数：after_id / cursor、limit
+  dao::IdPage page;
+  if (!dao::parseIdPage(req, page)) {
+    response["error"] = "无效的分页参数: after_id、cursor 或 limit";
     auto resp = HttpResponse::newHttpJsonResponse(response);
-    resp->setStatusCode(k401Unauthorized);
+    resp->setStatusCode(k400BadRequest);
     callback(resp);
-    return;
+    co_return;
   }
 
-  int user_id = std::stoi(userIdCookie);
-
   try {
-    // 查询用户类型
-    auto userResult = dbClient->execSqlSync(
-        "SELECT user_type FROM user WHERE user_id = ?", user_id);
-
-    if (userResult.empty()) {
-      response["error"] = "用户不存在";
-      auto resp = HttpResponse::newHttpJsonResponse(response);
-      resp->setStatusCode(k404NotFound);
-      callback(resp);
-      return;
-    }
-
-    std::string user_type = userResult[0]["user_type"].as<std::string>();
-
-    // 如果是管理员，查询所有审批记录
-    std::string query;
-    if (user_type == "管理员") {
-      query = "SELECT ca.approval_id, ca.club_name, ca.applicant_id, "
-              "u.username AS applicant_name, "
-              "ca.approval_status, ca.approval_opinion, ca.approval_time "
-              "FROM club_approval ca "
-              "JOIN user u ON ca.applicant_id = u.user_id";
-    } else {
-      // 如果是普通用户，只查询自己的审批记录
-      query = "SELECT ca.approval_id, ca.club_name, ca.applicant_id, "
-              "u.username AS applicant_name, "
-              "ca.approval_status, ca.approval_opinion, ca.approval_time "
-              "FROM club_approval ca "
-              "JOIN user u ON ca.applicant_id = u.user_id "
-              "WHERE ca.applicant_id = ?";
-    }
-
-    // 执行查询
-    auto result = (user_type == "管理员")
-                      ? dbClient->execSqlSync(query)
-                      : dbClient->execSqlSync(query, user_id);
+    // 如果是管理员，查询所有审批记录；普通用户只查询自己的审批记录。
+    // 按 approval_id 分页，多取一行判断是否还有下一页
+    auto result =
+        (session.userType == "管理员")
+            ? co_await dao::exec(req, dao::sql::kApprovalListAll, page.afterId,
+                                 page.limit + 1)
+            : co_await dao::exec(req, dao::sql::kApprovalListByApplicant, user_id,
+                                 page.afterId, page.limit + 1);
 
     Json::Value approvals(Json::arrayValue);
-    for (const auto &row : result) {
+    for (size_t i = 0; i < dao::pageSize(result, page); ++i) {
+      auto row = result[i];
       Json::Value approval;
       approval["approval_id"] = row["approval_id"].as<int>();
       approval["club_name"] = row["club_name"].as<std::string>();
@@ -274,6 +226,7 @@ void ClubApprovalController::getApprovalList(
     }
 
     response["approvals"] = approvals;
+    response["next_cursor"] = dao::nextIdCursor(result, page, "approval_id");
   } catch (const drogon::orm::DrogonDbException &e) {
     LOG_ERROR << "Database error: " << e.base().what();
     response["error"] = "数据库错误，无法获取审批记录";
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <drogon/HttpController.h>
+#include <drogon/utils/coroutine.h>
 
 using namespace drogon;
 
@@ -8,12 +9,12 @@ class ClubApprovalController : public drogon::HttpController<ClubApprovalControl
 {
   public:
     METHOD_LIST_BEGIN
-    ADD_METHOD_TO(ClubApprovalController::submitApproval, "/club/approval/submit", Post);
-    ADD_METHOD_TO(ClubApprovalController::approveClub, "/club/approval/{1}", Put);
-    ADD_METHOD_TO(ClubApprovalController::getApprovalList, "/club/approval/list", Get);
+    ADD_METHOD_TO(ClubApprovalController::submitApproval, "/club/approval/submit", Post, "SessionFilter");
+    ADD_METHOD_TO(ClubApprovalController::approveClub, "/club/approval/{1}", Put, "SessionFilter");
+    ADD_METHOD_TO(ClubApprovalController::getApprovalList, "/club/approval/list", Get, "SessionFilter");
     METHOD_LIST_END
 
-    void submitApproval(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
-    void approveClub(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, int approvalId) const;
-    void getApprovalList(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const;
+    Task<> submitApproval(HttpRequestPtr req, std::function<void(const HttpResponsePtr &)> callback) const;
+    Task<> approveClub(HttpRequestPtr req, std::function<void(const HttpResponsePtr &)> callback, int approvalId) const;
+    Task<> getApprovalList(HttpRequestPtr req, std::function<void(const HttpResponsePtr &)> callback) const;
 };
\ No newline at end of file
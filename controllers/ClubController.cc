@@ -1,32 +1,45 @@
 #include "ClubController.h"
+#include "common/SessionToken.h"
+#include "common/RowJson.h"
+#include "dao/Db.h"
+#include "dao/Pagination.h"
+#include "plugins/ClubCatalog.h"
+#include "plugins/ClubStats.h"
+#include "plugins/LiveCounters.h"
+#include "plugins/PermissionIndex.h"
+#include "plugins/SearchIndex.h"
 #include <drogon/HttpResponse.h>
 #include <drogon/orm/Exception.h>
 
 // 创建社团
-void ClubController::create(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, Club club) const {
-    auto dbClient = drogon::app().getDbClient();
+Task<> ClubController::create(HttpRequestPtr req, std::function<void(const HttpResponsePtr &)> callback, Club club) const {
     Json::Value response;
 
     try {
         // 检查社团名称是否已存在
-        auto result = dbClient->execSqlSync("SELECT COUNT(*) AS count FROM club WHERE club_name = ?", club.club_name);
+        auto result = co_await dao::exec(req, dao::sql::kClubCountByName, club.club_name);
         if (result[0]["count"].as<int>() > 0) {
             response["error"] = "社团名称已存在，创建失败";
             auto resp = HttpResponse::newHttpJsonResponse(response);
             resp->setStatusCode(k400BadRequest);
             callback(resp);
-            return;
+            co_return;
         }
 
         // 插入社团数据到数据库
-        dbClient->execSqlSync(
-            "INSERT INTO club (club_name, club_introduction, contact_info, activity_venue, founder_id) VALUES (?, ?, ?, ?, ?)",
+        auto insertResult = co_await dao::exec(
+            req, dao::sql::kClubInsert,
             club.club_name,
             club.club_introduction,
             club.contact_info,
             club.activity_venue,
             club.founder_id
         );
+        app().getPlugin<PermissionIndex>()->invalidateClub(
+            static_cast<int>(insertResult.insertId()));
+        // 发布包含新社团的目录快照
+        co_await app().getPlugin<ClubCatalog>()->rebuild(common::requestTiming(*req));
+        app().getPlugin<SearchIndex>()->refresh();
 
         response["message"] = "社团创建成功";
     } catch (const drogon::orm::DrogonDbException &e) {
@@ -39,16 +52,49 @@ void ClubController::create(const HttpRequestPtr &req, std::function<void(const
 }
 
 // 获取社团列表
-void ClubController::list(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback) const {
-    auto dbClient = drogon::app().getDbClient();
+Task<> ClubController::list(HttpRequestPtr req, std::function<void(const HttpResponsePtr &)> callback) const {
     Json::Value response;
 
+    // 分页参数：after_id / cursor、limit
+    dao::IdPage page;
+    if (!dao::parseIdPage(req, page)) {
+        response["error"] = "无效的分页参数: after_id、cursor 或 limit";
+        auto resp = HttpResponse::newHttpJsonResponse(response);
+        resp->setStatusCode(k400BadRequest);
+        callback(resp);
+        co_return;
+    }
+
+    // 优先从内存快照分页，快照未就绪时回退到查库
+    // 各社团的 JSON 在快照发布时已序列化好，这里只做拼接
+    if (auto snapshot = app().getPlugin<ClubCatalog>()->snapshot()) {
+        auto &body = common::jsonBuffer();
+        body += "{\"clubs\":[";
+        auto it = snapshot->after(page.afterId);
+        for (int n = 0; n < page.limit && it != snapshot->clubs.end(); ++n, ++it) {
+            if (n > 0) {
+                body += ',';
+            }
+            body += it->listJson;
+        }
+        body += "],\"next_cursor\":";
+        if (it == snapshot->clubs.end()) {
+            body += "null";
+        } else {
+            common::appendJsonString(body, dao::encodeIdCursor(std::prev(it)->club_id));
+        }
+        body += '}';
+        callback(common::newJsonBodyResponse(body));
+        co_return;
+    }
+
     try {
-        // 查询所有社团
-        auto result = dbClient->execSqlSync("SELECT club_id, club_name, club_introduction FROM club");
+        // 按 club_id 分页查询社团，多取一行判断是否还有下一页
+        auto result = co_await dao::exec(req, dao::sql::kClubList, page.afterId, page.limit + 1);
         Json::Value clubs(Json::arrayValue);
 
-        for (const auto &row : result) {
+        for (size_t i = 0; i < dao::pageSize(result, page); ++i) {
+            auto row = result[i];
             Json::Value club;
             club["club_id"] = row["club_id"].as<int>();
             club["club_name"] = row["club_name"].as<std::string>();
@@ -57,6 +103,7 @@ void ClubController::list(const HttpRequestPtr &req, std::function<void(const Ht
         }
 
         response["clubs"] = clubs;
+        response["next_cursor"] = dao::nextIdCursor(result, page, "club_id");
     } catch (const drogon::orm::DrogonDbException &e) {
         response["error"] = "数据库错误，无法获取社团列表";
     }
@@ -67,13 +114,30 @@ void ClubController::list(const HttpRequestPtr &req, std::function<void(const Ht
 }
 
 // 获取社团详情
-void ClubController::detail(const HttpRequestPtr &req, std::function<void(const HttpResponsePtr &)> &&callback, int club_id) const {
-    auto dbClient = drogon::app().getDbClient();
+Task<> ClubController::detail(HttpRequestPtr req, std::function<void(const HttpResponsePtr &)> callback, int club_id) const {
     Json::Value response;
 
+    // 优先从内存快照读取，快照未就绪时回退到查库；
+    // 快照重建失败期间可能缺少新社团，查不到时同样回退到查库
+    auto catalog = app().getPlugin<ClubCatalog>();
+    if (auto snapshot = catalog->snapshot()) {
+        const auto *club = snapshot->find(club_id);
+        if (club != nullptr) {
+            callback(common::newJsonBodyResponse(club->detailJson));
+            co_return;
+        }
+        if (!catalog->stale()) {
+            response["error"] = "社团不存在";
+            auto resp = HttpResponse::newHttpJsonResponse(response);
+            resp->setStatusCode(k404NotFound);
+            callback(resp);
+            co_return;
+        }
+    }
+
     try {
         // 查询社团详情
-        auto result = dbClient->execSqlSync("SELECT * FROM club WHERE club_id = ?", club_id);
+        auto result = co_await dao::exec(req, dao::sql::kClubFindById, club_id);
 
         if (!result.empty()) {
             response["club_id"] = result[0]["club_id"].as<int>();
@@ -87,7 +151,7 @@ void ClubController::detail(const HttpRequestPtr &req, std::function<void(const
             auto resp = HttpResponse::newHttpJsonResponse(response);
             resp->setStatusCode(k404NotFound);
             callback(resp);
-            return;
+            co_return;
         }
     } catch (const drogon::orm::DrogonDbException &e) {
         response["error"] = "数据库错误，无法获取社团详情";
@@ -99,30 +163,17 @@ void ClubController::detail(const HttpRequestPtr &req, std::function<void(const
 }
 
 // 获取用户拥有的社团
-void ClubController::ownedClubs(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback) const {
-    auto dbClient = drogon::app().getDbClient();
+Task<> ClubController::ownedClubs(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback) const {
     Json::Value response;
 
-    // 从 Cookie 中获取当前登录用户的 user_id
-    auto userIdCookie = req->getCookie("user_id");
-    if (userIdCookie.empty()) {
-        response["error"] = "未登录";
-        auto resp = HttpResponse::newHttpJsonResponse(response);
-        resp->setStatusCode(k401Unauthorized);
-        callback(resp);
-        return;
-    }
-
-    int user_id = std::stoi(userIdCookie);
+    // 当前登录用户，由 SessionFilter 校验令牌后写入
+    int user_id = common::currentSession(req).userId;
 
     try {
         // 查询当前用户拥有的社团
-        auto result = dbClient->execSqlSync(
-            "SELECT club_id, club_name, club_introduction, contact_info, activity_venue "
-            "FROM club WHERE founder_id = ?",
-            user_id);
+        auto result = co_await dao::exec(req, dao::sql::kClubListByFounder, user_id);
 
         Json::Value clubs(Json::arrayValue);
         for (const auto &row : result) {
@@ -144,4 +195,75 @@ void ClubController::ownedClubs(
         resp->setStatusCode(k500InternalServerError);
         callback(resp);
     }
-}
\ No newline at end of file
+}
+
+// 获取社团计数
+Task<> ClubController::counts(HttpRequestPtr req, std::function<void(const HttpResponsePtr &)> callback, int club_id) const {
+    Json::Value response;
+
+    auto counters = app().getPlugin<LiveCounters>();
+    if (!counters->ready()) {
+        response["error"] = "计数尚未加载完成，请稍后重试";
+        auto resp = HttpResponse::newHttpJsonResponse(response);
+        resp->setStatusCode(k503ServiceUnavailable);
+        callback(resp);
+        co_return;
+    }
+
+    // 目录快照就绪且没有落后于数据库时先确认社团存在
+    auto catalog = app().getPlugin<ClubCatalog>();
+    if (auto snapshot = catalog->snapshot();
+        snapshot && !catalog->stale() && snapshot->find(club_id) == nullptr) {
+        response["error"] = "社团不存在";
+        auto resp = HttpResponse::newHttpJsonResponse(response);
+        resp->setStatusCode(k404NotFound);
+        callback(resp);
+        co_return;
+    }
+
+    auto club = counters->club(club_id);
+    response["club_id"] = club_id;
+    response["members"] = club.members;
+    auto resp = HttpResponse::newHttpJsonResponse(response);
+    resp->setStatusCode(k200OK);
+    callback(resp);
+}
+
+// 获取社团看板统计
+Task<> ClubController::stats(HttpRequestPtr req, std::function<void(const HttpResponsePtr &)> callback, int club_id) const {
+    Json::Value response;
+
+    // 当前登录用户，由 SessionFilter 校验令牌后写入
+    const auto &session = common::currentSession(req);
+
+    try {
+        auto *timing = common::requestTiming(*req);
+        auto founder = co_await app().getPlugin<PermissionIndex>()->clubFounder(club_id, timing);
+        if (!founder) {
+            response["error"] = "社团不存在";
+            auto resp = HttpResponse::newHttpJsonResponse(response);
+            resp->setStatusCode(k404NotFound);
+            callback(resp);
+            co_return;
+        }
+
+        // 管理员可以查看任意社团，社长只能查看自己的社团
+        if (session.userType != "管理员" && *founder != session.userId) {
+            response["error"] = "无权限操作，只能查看自己社团的统计";
+            auto resp = HttpResponse::newHttpJsonResponse(response);
+            resp->setStatusCode(k403Forbidden);
+            callback(resp);
+            co_return;
+        }
+
+        // 统计结果已序列化并缓存，命中时不访问数据库
+        auto body = co_await app().getPlugin<ClubStats>()->stats(club_id, timing);
+        callback(common::newJsonBodyResponse(*body));
+    } catch (const drogon::orm::DrogonDbException &e) {
+        LOG_ERROR << "Database error: " << e.base().what();
+        response["error"] = "数据库错误，无法获取社团统计";
+        auto resp = HttpResponse::newHttpJsonResponse(response);
+        resp->setStatusCode(k500InternalServerError);
+        callback(resp);
+    }
+}
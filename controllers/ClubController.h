@@ -1,5 +1,7 @@
 #pragma once
+#include "common/RequestSchema.h"
 #include <drogon/HttpController.h>
+#include <drogon/utils/coroutine.h>
 #include <stdexcept>
 
 using namespace drogon;
@@ -23,65 +25,62 @@ public:
     // 获取社团详情接口
     ADD_METHOD_TO(ClubController::detail, "/club/detail/{1}", Get); // {1} 表示路径参数 club_id
     // 添加获取当前用户拥有的社团接口
-    ADD_METHOD_TO(ClubController::ownedClubs, "/club/owned", Get);
+    ADD_METHOD_TO(ClubController::ownedClubs, "/club/owned", Get, "SessionFilter");
+    // 社团成员数，取自内存计数
+    ADD_METHOD_TO(ClubController::counts, "/club/counts/{1}", Get); // {1} 表示 club_id
+    // 社团看板统计，社长或管理员可见
+    ADD_METHOD_TO(ClubController::stats, "/club/{1}/stats", Get, "SessionFilter"); // {1} 表示 club_id
     METHOD_LIST_END
 
     // 创建社团方法
-    void create(const HttpRequestPtr &req,
-                std::function<void(const HttpResponsePtr &)> &&callback,
-                Club club) const;
+    Task<> create(HttpRequestPtr req,
+                  std::function<void(const HttpResponsePtr &)> callback,
+                  Club club) const;
 
     // 获取社团列表方法
-    void list(const HttpRequestPtr &req,
-              std::function<void(const HttpResponsePtr &)> &&callback) const;
+    Task<> list(HttpRequestPtr req,
+                std::function<void(const HttpResponsePtr &)> callback) const;
 
     // 获取社团详情方法
-    void detail(const HttpRequestPtr &req,
-                std::function<void(const HttpResponsePtr &)> &&callback,
-                int club_id) const;
+    Task<> detail(HttpRequestPtr req,
+                  std::function<void(const HttpResponsePtr &)> callback,
+                  int club_id) const;
 
     // 获取当前用户拥有的社团方法
-    void ownedClubs(const HttpRequestPtr &req,
-                    std::function<void(const HttpResponsePtr &)> &&callback) const;
-};
-
-// 自定义从请求中解析 Club 对象的方法
-namespace drogon {
-template <> inline Club fromRequest(const HttpRequest &req) {
-    auto json = req.getJsonObject();
-    Club value;
-
-    if (json == nullptr) {
-        throw std::runtime_error("请求体格式错误，请使用 JSON");
-    }
-
-    // 解析社团名称
-    if (json->isMember("club_name")) {
-        const auto &temp = (*json)["club_name"].asString();
-        if (temp.empty()) {
-            throw std::runtime_error("社团名称不能为空");
-        }
-        value.club_name = temp;
-    } else {
-        throw std::runtime_error("缺少必备字段: club_name");
-    }
+    Task<> ownedClubs(HttpRequestPtr req,
+                      std::function<void(const HttpResponsePtr &)> callback) const;
 
-    // 解析社团简介
-    value.club_introduction = json->get("club_introduction", "").asString();
+    // 获取社团计数方法
+    Task<> counts(HttpRequestPtr req,
+                  std::function<void(const HttpResponsePtr &)> callback,
+                  int club_id) const;
 
-    // 解析联系方式
-    value.contact_info = json->get("contact_info", "").asString();
-
-    // 解析活动场地
-    value.activity_venue = json->get("activity_venue", "").asString();
+    // 获取社团看板统计方法
+    Task<> stats(HttpRequestPtr req,
+                 std::function<void(const HttpResponsePtr &)> callback,
+                 int club_id) const;
+};
 
-    // 解析创建者 ID
-    if (json->isMember("founder_id")) {
-        value.founder_id = (*json)["founder_id"].asInt();
-    } else {
-        throw std::runtime_error("缺少必备字段: founder_id");
-    }
+// 请求体字段表，校验顺序与错误信息同原先逐字段解析一致
+template <> struct common::RequestSchema<Club> {
+    static constexpr common::RequestField<Club> fields[] = {
+        {.key = "club_name",
+         .text = &Club::club_name,
+         .missing = "缺少必备字段: club_name",
+         .minLength = 1,
+         .tooShort = "社团名称不能为空"},
+        {.key = "club_introduction", .text = &Club::club_introduction},
+        {.key = "contact_info", .text = &Club::contact_info},
+        {.key = "activity_venue", .text = &Club::activity_venue},
+        {.key = "founder_id",
+         .number = &Club::founder_id,
+         .missing = "缺少必备字段: founder_id"},
+    };
+};
 
-    return value;
+// 自定义从请求中解析 Club 对象的方法：单遍扫描请求体，不构建 Json::Value
+namespace drogon {
+template <> inline Club fromRequest(const HttpRequest &req) {
+  return common::parseRequest<Club>(req);
 }
 } // namespace drogon
\ No newline at end of file
@@ -1,13 +1,36 @@
 #include "ClubMemberController.h"
+#include "common/SessionToken.h"
+#include "dao/Db.h"
+#include "common/JsonStream.h"
+#include "common/RowJson.h"
+#include "common/MemberImport.h"
+#include "dao/Pagination.h"
+#include "plugins/ClubStats.h"
+#include "plugins/DbRouter.h"
+#include "plugins/LiveCounters.h"
+#include "plugins/PermissionIndex.h"
 #include <drogon/HttpResponse.h>
 #include <drogon/HttpTypes.h>
 #include <drogon/orm/Exception.h>
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+// 单次导入的行数上限
+constexpr size_t kImportMaxRows = 2000;
+// 每条多行 INSERT 的行数
+constexpr size_t kImportChunkRows = 500;
+
+} // namespace
 
 // 申请加入社团
-void ClubMemberController::apply(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback) const {
-  auto dbClient = drogon::app().getDbClient();
+Task<> ClubMemberController::apply(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback) const {
   Json::Value response;
 
   try {
@@ -15,36 +38,33 @@ void ClubMemberController::apply(
     auto clubMember = drogon::fromRequest<ClubMember>(*req);
 
     // 检查用户是否已经是该社团的成员
-    auto memberCheckResult = dbClient->execSqlSync(
-        "SELECT member_id FROM club_member WHERE user_id = ? AND club_id = ?",
-        clubMember.user_id, clubMember.club_id);
+    auto memberCheckResult = co_await dao::exec(
+        req, dao::sql::kMemberFind, clubMember.user_id, clubMember.club_id);
 
     if (!memberCheckResult.empty()) {
       response["error"] = "您已经是该社团的成员，无法重复申请";
       auto resp = HttpResponse::newHttpJsonResponse(response);
       resp->setStatusCode(k400BadRequest);
       callback(resp);
-      return;
+      co_return;
     }
 
     // 检查是否已存在重复申请
-    auto result = dbClient->execSqlSync(
-        "SELECT apply_id FROM club_member_apply WHERE user_id = ? AND club_id "
-        "= ? AND status = ?",
-        clubMember.user_id, clubMember.club_id, "pending");
+    auto result =
+        co_await dao::exec(req, dao::sql::kApplyFindByStatus, clubMember.user_id,
+                           clubMember.club_id, "pending");
 
     if (!result.empty()) {
       response["error"] = "重复申请，您已提交过申请，正在等待审核";
       auto resp = HttpResponse::newHttpJsonResponse(response);
       resp->setStatusCode(k400BadRequest);
       callback(resp);
-      return;
+      co_return;
     }
 
     // 插入申请记录到 club_member_apply 表
-    dbClient->execSqlSync("INSERT INTO club_member_apply (user_id, club_id, "
-                          "apply_date, status) VALUES (?, ?, NOW(), ?)",
-                          clubMember.user_id, clubMember.club_id, "pending");
+    co_await dao::exec(req, dao::sql::kApplyInsert, clubMember.user_id,
+                       clubMember.club_id, "pending");
 
     response["message"] = "申请已提交，等待审核";
     auto resp = HttpResponse::newHttpJsonResponse(response);
@@ -64,10 +84,9 @@ void ClubMemberController::apply(
 }
 
 // 审核加入申请
-void ClubMemberController::approve(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback) const {
-  auto dbClient = drogon::app().getDbClient();
+Task<> ClubMemberController::approve(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback) const {
   Json::Value response;
 
   auto json = req->getJsonObject();
@@ -76,7 +95,7 @@ void ClubMemberController::approve(
     auto resp = HttpResponse::newHttpJsonResponse(response);
     resp->setStatusCode(k400BadRequest);
     callback(resp);
-    return;
+    co_return;
   }
 
   int apply_id = (*json)["apply_id"].asInt();
@@ -84,33 +103,30 @@ void ClubMemberController::approve(
 
   try {
     // 查询申请记录
-    auto result =
-        dbClient->execSqlSync("SELECT user_id, club_id FROM club_member_apply "
-                              "WHERE apply_id = ? AND status = 'pending'",
-                              apply_id);
+    auto result = co_await dao::exec(req, dao::sql::kApplyFindPending, apply_id);
 
     if (result.empty()) {
       response["error"] = "未找到待审核的申请记录";
       auto resp = HttpResponse::newHttpJsonResponse(response);
       resp->setStatusCode(k404NotFound);
       callback(resp);
-      return;
+      co_return;
     }
 
     int user_id = result[0]["user_id"].as<int>();
     int club_id = result[0]["club_id"].as<int>();
 
     // 更新申请状态
-    dbClient->execSqlSync(
-        "UPDATE club_member_apply SET status = ? WHERE apply_id = ?", status,
-        apply_id);
+    co_await dao::exec(req, dao::sql::kApplyUpdateStatus, status, apply_id);
 
-    // 如果审核通过，将用户加入 club_member 表
+    // 如果审核通过，将用户加入 club_member 表；用户已由导入加入时不重复写入
     if (status == "approved") {
-      dbClient->execSqlSync(
-          "INSERT INTO club_member (user_id, club_id, join_date, member_role) "
-          "VALUES (?, ?, NOW(), '社员')",
-          user_id, club_id);
+      auto insertResult =
+          co_await dao::exec(req, dao::sql::kMemberInsert, user_id, club_id);
+      if (insertResult.affectedRows() > 0) {
+        app().getPlugin<LiveCounters>()->memberJoined(club_id);
+        app().getPlugin<ClubStats>()->invalidateClub(club_id);
+      }
     }
 
     response["message"] = "申请状态已更新";
@@ -126,10 +142,9 @@ void ClubMemberController::approve(
 }
 
 // 移除成员
-void ClubMemberController::remove(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback) const {
-  auto dbClient = drogon::app().getDbClient();
+Task<> ClubMemberController::remove(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback) const {
   auto json = req->getJsonObject();
   Json::Value response;
 
@@ -139,15 +154,25 @@ void ClubMemberController::remove(
     auto resp = HttpResponse::newHttpJsonResponse(response);
     resp->setStatusCode(k400BadRequest);
     callback(resp);
-    return;
+    co_return;
   }
 
   auto member_id = (*json)["member_id"].asInt();
 
   try {
+    // 成员所属社团，用于更新成员计数
+    auto memberResult =
+        co_await dao::exec(req, dao::sql::kMemberClubById, member_id);
+
     // 删除成员记录
-    dbClient->execSqlSync("DELETE FROM club_member WHERE member_id = ?",
-                          member_id);
+    auto deleteResult =
+        co_await dao::exec(req, dao::sql::kMemberDelete, member_id);
+    if (!memberResult.empty() && deleteResult.affectedRows() > 0) {
+      int club_id = memberResult[0]["club_id"].as<int>();
+      app().getPlugin<LiveCounters>()->memberLeft(
+          club_id, static_cast<int>(deleteResult.affectedRows()));
+      app().getPlugin<ClubStats>()->invalidateClub(club_id);
+    }
 
     response["message"] = "成员已移除";
   } catch (const drogon::orm::DrogonDbException &e) {
@@ -155,7 +180,7 @@ void ClubMemberController::remove(
     auto resp = HttpResponse::newHttpJsonResponse(response);
     resp->setStatusCode(k500InternalServerError);
     callback(resp);
-    return;
+    co_return;
   }
 
   auto resp = HttpResponse::newHttpJsonResponse(response);
@@ -164,38 +189,53 @@ void ClubMemberController::remove(
 }
 
 // 获取社团成员列表
-void ClubMemberController::list(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback,
+Task<> ClubMemberController::list(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback,
     int club_id) const {
-  auto dbClient = drogon::app().getDbClient();
   Json::Value response;
 
+  // 分页参数：after_id / cursor、limit
+  dao::IdPage page;
+  if (!dao::parseIdPage(req, page)) {
+    response["error"] = "无效的分页参数: after_id、cursor 或 limit";
+    auto resp = HttpResponse::newHttpJsonResponse(response);
+    resp->setStatusCode(k400BadRequest);
+    callback(resp);
+    co_return;
+  }
+
   try {
-    // 查询社团成员列表，包含 email 和 phone 字段
-    auto result =
-        dbClient->execSqlSync("SELECT user.user_id, user.username, user.email, user.phone, "
-                              "club_member.member_role FROM club_member "
-                              "JOIN user ON club_member.user_id = user.user_id "
-                              "WHERE club_member.club_id = ?",
-                              club_id);
-
-    Json::Value members(Json::arrayValue);
-    for (const auto &row : result) {
-      Json::Value member;
-      member["user_id"] = row["user_id"].as<int>();
-      member["username"] = row["username"].as<std::string>();
-      member["email"] = row["email"].isNull() ? "" : row["email"].as<std::string>();
-      member["phone"] = row["phone"].isNull() ? "" : row["phone"].as<std::string>();
-      member["member_role"] = row["member_role"].as<std::string>();
-      members.append(member);
+    // ?stream=1 时按 limit 分页流式输出 after_id 之后的全部成员
+    if (common::wantsStream(req)) {
+      auto result = co_await dao::exec(req, dao::sql::kMemberListByClub, club_id,
+                                       page.afterId, page.limit);
+      callback(common::newJsonPageStreamResponse(
+          std::move(result),
+          [req, club_id](int afterId, int limit) -> Task<drogon::orm::Result> {
+            co_return co_await dao::exec(req, dao::sql::kMemberListByClub,
+                                         club_id, afterId, limit);
+          },
+          page.limit, "member_id",
+          "{\"message\":\"社团成员列表获取成功\",\"members\":[",
+          common::writeRows<common::MemberRow>, "]}"));
+      co_return;
     }
 
-    response["members"] = members;
-    response["message"] = "社团成员列表获取成功";
-    auto resp = HttpResponse::newHttpJsonResponse(response);
-    resp->setStatusCode(k200OK);
-    callback(resp);
+    // 按 member_id 分页查询社团成员，包含 email 和 phone 字段
+    auto result = co_await dao::exec(req, dao::sql::kMemberListByClub, club_id,
+                                     page.afterId, page.limit + 1);
+
+    // 行直接写入输出缓冲区，不经过 Json::Value
+    auto &body = common::jsonBuffer();
+    body += "{\"message\":\"社团成员列表获取成功\",\"members\":";
+    common::RowSerializer<common::MemberRow>(result).writeArray(
+        result, dao::pageSize(result, page), body);
+    body += ",\"next_cursor\":";
+    common::appendJsonScalar(body,
+                             dao::nextIdCursor(result, page, "member_id"));
+    body += '}';
+    callback(common::newJsonBodyResponse(body));
   } catch (const drogon::orm::DrogonDbException &e) {
     response["error"] = "数据库错误，无法获取成员列表";
     auto resp = HttpResponse::newHttpJsonResponse(response);
@@ -205,66 +245,78 @@ void ClubMemberController::list(
 }
 
 // 获取所有申请列表
-void ClubMemberController::getAllApplications(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback) const {
-  auto dbClient = drogon::app().getDbClient();
+Task<> ClubMemberController::getAllApplications(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback) const {
   Json::Value response;
 
-  // 从 Cookie 中获取当前登录用户的 user_id
-  auto userIdCookie = req->getCookie("user_id");
-  if (userIdCookie.empty()) {
-    response["error"] = "未登录";
+  // 当前登录用户，由 SessionFilter 校验令牌后写入
+  int user_id = common::currentSession(req).userId;
+
+  // 可选的状态过滤与分页参数
+  auto status = req->getParameter("status");
+  if (!status.empty() && status != "pending" && status != "approved" &&
+      status != "rejected") {
+    response["error"] = "无效的 status，必须是 pending、approved 或 rejected";
     auto resp = HttpResponse::newHttpJsonResponse(response);
-    resp->setStatusCode(k401Unauthorized); // 未授权
+    resp->setStatusCode(k400BadRequest);
     callback(resp);
-    return;
+    co_return;
   }
 
-  int user_id = std::stoi(userIdCookie);
+  int limit = dao::pageLimit(req);
+  auto cursor = dao::firstDateCursor();
+  const auto &cursorParam = req->getParameter("cursor");
+  if (limit < 0 ||
+      (!cursorParam.empty() && !dao::decodeDateCursor(cursorParam, cursor))) {
+    response["error"] = "无效的分页参数: limit 或 cursor";
+    auto resp = HttpResponse::newHttpJsonResponse(response);
+    resp->setStatusCode(k400BadRequest);
+    callback(resp);
+    co_return;
+  }
 
   try {
-    // 查询用户作为社长的所有社团
-    auto clubResult = dbClient->execSqlSync(
-        "SELECT club_id, club_name FROM club WHERE founder_id = ?", user_id);
-
-    if (clubResult.empty()) {
-      response["error"] = "您没有管理的社团";
-      auto resp = HttpResponse::newHttpJsonResponse(response);
-      resp->setStatusCode(drogon::k200OK); // 未找到
-      callback(resp);
-      return;
+    // 一次查询取回名下所有社团的申请，多取一行判断是否还有下一页
+    auto result = co_await dao::exec(req, dao::sql::kApplyInboxByFounder, user_id,
+                                     status, status, cursor.date, cursor.id,
+                                     limit + 1);
+
+    if (result.empty() && cursorParam.empty()) {
+      auto clubResult =
+          co_await dao::exec(req, dao::sql::kClubIdsByFounder, user_id);
+      if (clubResult.empty()) {
+        response["error"] = "您没有管理的社团";
+        auto resp = HttpResponse::newHttpJsonResponse(response);
+        resp->setStatusCode(drogon::k200OK); // 未找到
+        callback(resp);
+        co_return;
+      }
     }
 
     Json::Value applications(Json::arrayValue);
+    size_t count = std::min(result.size(), static_cast<size_t>(limit));
+    for (size_t i = 0; i < count; ++i) {
+      const auto &applicationRow = result[i];
+      Json::Value application;
+      application["club_id"] = applicationRow["club_id"].as<int>();
+      application["club_name"] = applicationRow["club_name"].as<std::string>();
+      application["apply_id"] = applicationRow["apply_id"].as<int>();
+      application["user_id"] = applicationRow["user_id"].as<int>();
+      application["user_name"] = applicationRow["user_name"].as<std::string>();
+      application["apply_date"] =
+          applicationRow["apply_date"].as<std::string>();
+      application["status"] = applicationRow["status"].as<std::string>();
+      applications.append(application);
+    }
 
-    // 遍历每个社团，查询其申请列表
-    for (const auto &clubRow : clubResult) {
-      int club_id = clubRow["club_id"].as<int>();
-      std::string club_name = clubRow["club_name"].as<std::string>();
-
-      // 联表查询申请记录和用户名
-      auto applicationResult =
-          dbClient->execSqlSync("SELECT a.apply_id, a.user_id, u.username AS "
-                                "user_name, a.apply_date, a.status "
-                                "FROM club_member_apply a "
-                                "JOIN user u ON a.user_id = u.user_id "
-                                "WHERE a.club_id = ?",
-                                club_id);
-
-      for (const auto &applicationRow : applicationResult) {
-        Json::Value application;
-        application["club_id"] = club_id;
-        application["club_name"] = club_name;
-        application["apply_id"] = applicationRow["apply_id"].as<int>();
-        application["user_id"] = applicationRow["user_id"].as<int>();
-        application["user_name"] =
-            applicationRow["user_name"].as<std::string>();
-        application["apply_date"] =
-            applicationRow["apply_date"].as<std::string>();
-        application["status"] = applicationRow["status"].as<std::string>();
-        applications.append(application);
-      }
+    // 还有下一页时返回游标，否则为 null
+    if (result.size() > count) {
+      const auto &last = result[count - 1];
+      response["next_cursor"] = dao::encodeDateCursor(
+          last["apply_date"].as<std::string>(), last["apply_id"].as<int>());
+    } else {
+      response["next_cursor"] = Json::Value();
     }
 
     response["applications"] = applications;
@@ -279,4 +331,282 @@ void ClubMemberController::getAllApplications(
     resp->setStatusCode(k500InternalServerError); // 服务器内部错误
     callback(resp);
   }
-}
\ No newline at end of file
+}
+// 批量导入成员
+Task<> ClubMemberController::importMembers(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback,
+    int club_id) const {
+  Json::Value response;
+
+  // 当前登录用户，由 SessionFilter 校验令牌后写入
+  const auto &session = common::currentSession(req);
+
+  // 解析请求体，每行的处理结果最终都写入报告
+  std::vector<common::ImportRow> rows;
+  auto body = req->body();
+  if (common::isNdjson(req->getHeader("content-type"), body)) {
+    common::parseNdjson(body, rows);
+  } else if (!common::parseCsv(body, rows)) {
+    response["error"] = "CSV 首行须为表头，包含 user_id 或 username 列";
+    auto resp = HttpResponse::newHttpJsonResponse(response);
+    resp->setStatusCode(k400BadRequest);
+    callback(resp);
+    co_return;
+  }
+  if (rows.empty()) {
+    response["error"] = "导入内容为空";
+    auto resp = HttpResponse::newHttpJsonResponse(response);
+    resp->setStatusCode(k400BadRequest);
+    callback(resp);
+    co_return;
+  }
+  if (rows.size() > kImportMaxRows) {
+    response["error"] = "单次最多导入 " + std::to_string(kImportMaxRows) + " 行";
+    auto resp = HttpResponse::newHttpJsonResponse(response);
+    resp->setStatusCode(k413RequestEntityTooLarge);
+    callback(resp);
+    co_return;
+  }
+
+  auto *timing = common::requestTiming(*req);
+  try {
+    // 管理员可以导入任意社团，社长只能导入自己的社团
+    auto founder =
+        co_await app().getPlugin<PermissionIndex>()->clubFounder(club_id,
+                                                                 timing);
+    if (!founder) {
+      response["error"] = "社团不存在";
+      auto resp = HttpResponse::newHttpJsonResponse(response);
+      resp->setStatusCode(k404NotFound);
+      callback(resp);
+      co_return;
+    }
+    if (session.userType != "管理员" && *founder != session.userId) {
+      response["error"] = "无权限操作，只能向自己的社团导入成员";
+      auto resp = HttpResponse::newHttpJsonResponse(response);
+      resp->setStatusCode(k403Forbidden);
+      callback(resp);
+      co_return;
+    }
+
+    // user_id 与 username 各用一次查询解析
+    std::vector<int> ids;
+    std::vector<std::string> names;
+    for (const auto &row : rows) {
+      if (!row.status.empty()) {
+        continue;
+      }
+      if (row.userId) {
+        ids.push_back(*row.userId);
+      } else {
+        names.push_back(row.username);
+      }
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+
+    std::unordered_map<int, std::string> nameOf;
+    if (!ids.empty()) {
+      std::string sql = dao::sql::kUserResolve.sql;
+      sql += dao::placeholders(ids.size());
+      auto users = co_await dao::execBound(
+          app().getDbClient(), timing, dao::sql::kUserResolve, std::move(sql),
+          ids.size(), [&ids](auto &binder) {
+            for (int id : ids) {
+              binder << id;
+            }
+          });
+      for (const auto &user : users) {
+        nameOf.emplace(user["user_id"].as<int>(),
+                       user["username"].as<std::string>());
+      }
+    }
+
+    // 名字由 MySQL 按 username 列的排序规则匹配，"Alice" 也能找到 "alice"；
+    // 结果按文件中的原始名字分组，匹配到多个用户的名字无法确定导入谁
+    std::unordered_map<std::string, std::vector<std::pair<int, std::string>>>
+        matchesOf;
+    if (!names.empty()) {
+      std::string sql = dao::sql::kUserResolveByName.sql;
+      for (size_t i = 1; i < names.size(); ++i) {
+        sql += dao::sql::kUserResolveByNameRow;
+      }
+      sql += dao::sql::kUserResolveByNameEnd;
+      auto users = co_await dao::execBound(
+          app().getDbClient(), timing, dao::sql::kUserResolveByName,
+          std::move(sql), names.size(), [&names](auto &binder) {
+            for (const auto &name : names) {
+              binder << name;
+            }
+          });
+      for (const auto &user : users) {
+        matchesOf[user["name"].as<std::string>()].emplace_back(
+            user["user_id"].as<int>(), user["username"].as<std::string>());
+      }
+    }
+
+    // 同一用户在文件中出现多次时只导入第一次
+    std::vector<int> candidates;
+    std::unordered_set<int> seen;
+    for (auto &row : rows) {
+      if (!row.status.empty()) {
+        continue;
+      }
+      if (row.userId) {
+        auto it = nameOf.find(*row.userId);
+        if (it != nameOf.end()) {
+          row.resolvedId = *row.userId;
+          row.username = it->second;
+        }
+      } else if (auto it = matchesOf.find(row.username);
+                 it != matchesOf.end()) {
+        if (it->second.size() > 1) {
+          row.status = "ambiguous";
+          row.error = "有 " + std::to_string(it->second.size()) +
+                      " 个用户匹配该用户名，请改用 user_id";
+          continue;
+        }
+        row.resolvedId = it->second.front().first;
+        row.username = it->second.front().second;
+      }
+      if (row.resolvedId == 0) {
+        row.status = "not_found";
+      } else if (!seen.insert(row.resolvedId).second) {
+        row.status = "duplicate";
+      } else {
+        candidates.push_back(row.resolvedId);
+      }
+    }
+
+    if (!candidates.empty()) {
+      auto trans = co_await app().getDbClient()->newTransactionCoro();
+      std::unordered_set<int> existing;
+      std::vector<int> inserts;
+      try {
+        // 在事务中一次查出已是成员的用户并加锁，直到提交前其他事务
+        // 不能再为这些用户写入成员记录
+        std::string existingSql = dao::sql::kMemberExistingIn.sql;
+        existingSql += dao::placeholders(candidates.size());
+        existingSql += dao::sql::kMemberExistingInEnd;
+        auto members = co_await dao::execBound(
+            trans, timing, dao::sql::kMemberExistingIn, std::move(existingSql),
+            candidates.size() + 1, [club_id, &candidates](auto &binder) {
+              binder << club_id;
+              for (int id : candidates) {
+                binder << id;
+              }
+            });
+        for (const auto &member : members) {
+          existing.insert(member["user_id"].as<int>());
+        }
+        for (int id : candidates) {
+          if (existing.count(id) == 0) {
+            inserts.push_back(id);
+          }
+        }
+
+        // 分块写入，每块一条多行 INSERT
+        for (size_t begin = 0; begin < inserts.size();
+             begin += kImportChunkRows) {
+          size_t end = std::min(inserts.size(), begin + kImportChunkRows);
+          std::string insertSql = dao::sql::kMemberInsertBatch.sql;
+          for (size_t i = begin; i < end; ++i) {
+            if (i > begin) {
+              insertSql += ',';
+            }
+            insertSql += dao::sql::kMemberInsertBatchRow;
+          }
+          co_await dao::execBound(
+              trans, timing, dao::sql::kMemberInsertBatch, std::move(insertSql),
+              (end - begin) * 2, [&inserts, begin, end, club_id](auto &binder) {
+                for (size_t i = begin; i < end; ++i) {
+                  binder << inserts[i] << club_id;
+                }
+              });
+        }
+
+        // 这些用户尚在审核中的入社申请随之通过
+        if (!inserts.empty()) {
+          std::string applySql = dao::sql::kApplyApproveIn.sql;
+          applySql += dao::placeholders(inserts.size());
+          co_await dao::execBound(
+              trans, timing, dao::sql::kApplyApproveIn, std::move(applySql),
+              inserts.size() + 1, [club_id, &inserts](auto &binder) {
+                binder << club_id;
+                for (int id : inserts) {
+                  binder << id;
+                }
+              });
+        }
+      } catch (const drogon::orm::DrogonDbException &) {
+        trans->rollback();
+        throw;
+      }
+
+      if (!co_await dao::commit(std::move(trans))) {
+        response["error"] = "数据库错误，导入未生效";
+        auto resp = HttpResponse::newHttpJsonResponse(response);
+        resp->setStatusCode(k500InternalServerError);
+        callback(resp);
+        co_return;
+      }
+      app().getPlugin<DbRouter>()->recordWrite(req);
+
+      for (auto &row : rows) {
+        if (row.status.empty()) {
+          row.status = existing.count(row.resolvedId) > 0 ? "already_member"
+                                                          : "added";
+        }
+      }
+      if (!inserts.empty()) {
+        app().getPlugin<LiveCounters>()->memberJoined(
+            club_id, static_cast<int>(inserts.size()));
+        app().getPlugin<ClubStats>()->invalidateClub(club_id);
+      }
+    }
+  } catch (const drogon::orm::DrogonDbException &e) {
+    LOG_ERROR << "Database error: " << e.base().what();
+    response["error"] = "数据库错误，导入未生效";
+    auto resp = HttpResponse::newHttpJsonResponse(response);
+    resp->setStatusCode(k500InternalServerError);
+    callback(resp);
+    co_return;
+  }
+
+  // 逐行报告
+  std::unordered_map<std::string, int> summary;
+  Json::Value results(Json::arrayValue);
+  for (const auto &row : rows) {
+    ++summary[row.status];
+    Json::Value item;
+    item["line"] = static_cast<Json::UInt64>(row.line);
+    if (row.resolvedId != 0) {
+      item["user_id"] = row.resolvedId;
+    } else if (row.userId) {
+      item["user_id"] = *row.userId;
+    }
+    if (!row.username.empty()) {
+      item["username"] = row.username;
+    }
+    item["status"] = row.status;
+    if (!row.error.empty()) {
+      item["error"] = row.error;
+    }
+    results.append(item);
+  }
+
+  response["message"] = "成员导入完成";
+  response["total"] = static_cast<Json::UInt64>(rows.size());
+  for (const char *status :
+       {"added", "already_member", "duplicate", "not_found", "ambiguous",
+        "invalid"}) {
+    response[status] = summary[status];
+  }
+  response["results"] = results;
+  auto resp = HttpResponse::newHttpJsonResponse(response);
+  resp->setStatusCode(k200OK);
+  callback(resp);
+}
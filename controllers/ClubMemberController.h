@@ -1,6 +1,8 @@
 #pragma once
 
+#include "common/RequestSchema.h"
 #include <drogon/HttpController.h>
+#include <drogon/utils/coroutine.h>
 
 using namespace drogon;
 
@@ -24,57 +26,56 @@ public:
   ADD_METHOD_TO(ClubMemberController::list, "/club/member/list/{1}",
                 Get); // {1} 表示 club_id
   // 获取用户作为社长的所有社团下的申请列表
-  ADD_METHOD_TO(ClubMemberController::getAllApplications, "/club/member/all_applications", Get);
+  ADD_METHOD_TO(ClubMemberController::getAllApplications, "/club/member/all_applications", Get, "SessionFilter");
+  // 批量导入成员，请求体为 CSV 或 NDJSON
+  ADD_METHOD_TO(ClubMemberController::importMembers,
+                "/club/member/import/{1}", Post,
+                "SessionFilter"); // {1} 表示 club_id
   METHOD_LIST_END
 
   // 申请加入社团方法
-  void apply(const HttpRequestPtr &req,
-             std::function<void(const HttpResponsePtr &)> &&callback) const;
+  Task<> apply(HttpRequestPtr req,
+               std::function<void(const HttpResponsePtr &)> callback) const;
 
   // 审核加入申请方法
-  void approve(const HttpRequestPtr &req,
-               std::function<void(const HttpResponsePtr &)> &&callback) const;
+  Task<> approve(HttpRequestPtr req,
+                 std::function<void(const HttpResponsePtr &)> callback) const;
 
   // 移除成员方法
-  void remove(const HttpRequestPtr &req,
-              std::function<void(const HttpResponsePtr &)> &&callback) const;
+  Task<> remove(HttpRequestPtr req,
+                std::function<void(const HttpResponsePtr &)> callback) const;
 
   // 获取社团成员列表方法
-  void list(const HttpRequestPtr &req,
-            std::function<void(const HttpResponsePtr &)> &&callback,
-            int club_id) const;
+  Task<> list(HttpRequestPtr req,
+              std::function<void(const HttpResponsePtr &)> callback,
+              int club_id) const;
 
   // 获取用户作为社长的所有社团下的申请列表方法
-  void getAllApplications(const HttpRequestPtr &req,
-                          std::function<void(const HttpResponsePtr &)> &&callback) const;
+  Task<> getAllApplications(HttpRequestPtr req,
+                            std::function<void(const HttpResponsePtr &)> callback) const;
+
+  // 批量导入成员方法
+  Task<> importMembers(HttpRequestPtr req,
+                       std::function<void(const HttpResponsePtr &)> callback,
+                       int club_id) const;
+};
+
+// 请求体字段表，校验顺序与错误信息同原先逐字段解析一致
+template <> struct common::RequestSchema<ClubMember> {
+  static constexpr common::RequestField<ClubMember> fields[] = {
+      {.key = "user_id",
+       .number = &ClubMember::user_id,
+       .missing = "缺少必备字段: user_id"},
+      {.key = "club_id",
+       .number = &ClubMember::club_id,
+       .missing = "缺少必备字段: club_id"},
+      {.key = "status", .text = &ClubMember::status, .defaultText = "pending"},
+  };
 };
 
+// 自定义从请求中解析 ClubMember 对象的方法：单遍扫描请求体，不构建 Json::Value
 namespace drogon {
 template <> inline ClubMember fromRequest(const HttpRequest &req) {
-  auto json = req.getJsonObject();
-  ClubMember value;
-
-  if (json == nullptr) {
-    throw std::runtime_error("请求体格式错误，请使用 JSON");
-  }
-
-  // 解析 user_id
-  if (json->isMember("user_id")) {
-    value.user_id = (*json)["user_id"].asInt();
-  } else {
-    throw std::runtime_error("缺少必备字段: user_id");
-  }
-
-  // 解析 club_id
-  if (json->isMember("club_id")) {
-    value.club_id = (*json)["club_id"].asInt();
-  } else {
-    throw std::runtime_error("缺少必备字段: club_id");
-  }
-
-  // 解析 status（可选字段，默认为 "pending"）
-  value.status = json->get("status", "pending").asString();
-
-  return value;
+  return common::parseRequest<ClubMember>(req);
 }
 } // namespace drogon
\ No newline at end of file
@@ -0,0 +1,72 @@
+#include "SearchController.h"
+#include "common/JsonStream.h"
+#include "common/RowJson.h"
+#include "dao/Pagination.h"
+#include "plugins/SearchIndex.h"
+#include <drogon/HttpResponse.h>
+
+// 搜索社团与活动，结果按相关度排序
+Task<> SearchController::search(HttpRequestPtr req, std::function<void(const HttpResponsePtr &)> callback) const {
+    Json::Value response;
+
+    const auto &query = req->getParameter("q");
+    if (query.empty()) {
+        response["error"] = "缺少搜索关键词: q";
+        auto resp = HttpResponse::newHttpJsonResponse(response);
+        resp->setStatusCode(k400BadRequest);
+        callback(resp);
+        co_return;
+    }
+
+    SearchDoc::Type type;
+    const SearchDoc::Type *typeFilter = nullptr;
+    const auto &typeParam = req->getParameter("type");
+    if (typeParam == "club") {
+        type = SearchDoc::Type::Club;
+        typeFilter = &type;
+    } else if (typeParam == "activity") {
+        type = SearchDoc::Type::Activity;
+        typeFilter = &type;
+    } else if (!typeParam.empty()) {
+        response["error"] = "无效的类型，可选 club 或 activity";
+        auto resp = HttpResponse::newHttpJsonResponse(response);
+        resp->setStatusCode(k400BadRequest);
+        callback(resp);
+        co_return;
+    }
+
+    int limit = dao::pageLimit(req);
+    if (limit < 0) {
+        response["error"] = "无效的分页参数: limit";
+        auto resp = HttpResponse::newHttpJsonResponse(response);
+        resp->setStatusCode(k400BadRequest);
+        callback(resp);
+        co_return;
+    }
+
+    auto snapshot = app().getPlugin<SearchIndex>()->snapshot();
+    if (!snapshot) {
+        response["error"] = "搜索索引正在加载，请稍后重试";
+        auto resp = HttpResponse::newHttpJsonResponse(response);
+        resp->setStatusCode(k503ServiceUnavailable);
+        resp->addHeader("Retry-After", "1");
+        callback(resp);
+        co_return;
+    }
+
+    // 结果项在索引发布时已序列化好，这里只做拼接
+    size_t total = 0;
+    auto hits = snapshot->search(query, typeFilter, static_cast<size_t>(limit), total);
+    auto &body = common::jsonBuffer();
+    body += "{\"total\":";
+    body += std::to_string(total);
+    body += ",\"results\":[";
+    for (size_t i = 0; i < hits.size(); ++i) {
+        if (i > 0) {
+            body += ',';
+        }
+        body += hits[i].doc->json;
+    }
+    body += "]}";
+    callback(common::newJsonBodyResponse(body));
+}
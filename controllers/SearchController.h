@@ -0,0 +1,17 @@
+#pragma once
+
+#include <drogon/HttpController.h>
+#include <drogon/utils/coroutine.h>
+
+using namespace drogon;
+
+class SearchController : public drogon::HttpController<SearchController> {
+public:
+    METHOD_LIST_BEGIN
+    // 搜索社团与活动：?q=关键词&type=club|activity&limit=
+    ADD_METHOD_TO(SearchController::search, "/search", Get);
+    METHOD_LIST_END
+
+    Task<> search(HttpRequestPtr req,
+                  std::function<void(const HttpResponsePtr &)> callback) const;
+};
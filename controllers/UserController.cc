@@ -1,4 +1,7 @@
 #include "UserController.h"
+#include "common/SessionToken.h"
+#include "dao/Db.h"
+#include "plugins/SessionManager.h"
 #include <drogon/Cookie.h>
 #include <drogon/HttpResponse.h>
 #include <drogon/orm/Exception.h>
@@ -6,29 +9,26 @@
 
 
 // 用户注册功能实现
-void UserController::m_register(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback, User user) const {
-  auto dbClient = drogon::app().getDbClient();
+Task<> UserController::m_register(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback, User user) const {
   Json::Value json;
 
   try {
     // 检查用户名是否已存在
-    auto result = dbClient->execSqlSync(
-        "SELECT COUNT(*) AS count FROM user WHERE username = ?", user.username);
+    auto result =
+        co_await dao::exec(req, dao::sql::kUserCountByName, user.username);
     if (result[0]["count"].as<int>() > 0) {
       json["error"] = "用户名已存在，注册失败";
       auto resp = drogon::HttpResponse::newHttpJsonResponse(json);
       resp->setStatusCode(k400BadRequest);
       callback(resp);
-      return;
+      co_return;
     }
 
     // 插入用户数据到数据库
-    dbClient->execSqlSync("INSERT INTO user (username, password, email, phone, "
-                          "user_type) VALUES (?, ?, ?, ?, ?)",
-                          user.username, user.password, user.email, user.phone,
-                          user.user_type);
+    co_await dao::exec(req, dao::sql::kUserInsert, user.username, user.password,
+                       user.email, user.phone, user.user_type);
       std::cout << "注册成功" <<std::endl;
     json["message"] = "注册成功";
   } catch (const drogon::orm::DrogonDbException &e) {
@@ -41,10 +41,9 @@ void UserController::m_register(
   callback(resp);
 }
 
-void UserController::login(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback) const {
-  auto dbClient = drogon::app().getDbClient();
+Task<> UserController::login(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback) const {
   auto json = req->getJsonObject();
   Json::Value response;
 
@@ -53,35 +52,38 @@ void UserController::login(
     auto resp = HttpResponse::newHttpJsonResponse(response);
     resp->setStatusCode(k400BadRequest);
     callback(resp);
-    return;
+    co_return;
   }
 
   std::string username = (*json)["username"].asString();
   std::string password = (*json)["password"].asString();
 
   try {
-    auto result = dbClient->execSqlSync(
-        "SELECT * FROM user WHERE username = ? AND password = ?", username,
-        password);
+    auto result = co_await dao::exec(req, dao::sql::kUserFindByCredentials,
+                                     username, password);
     if (!result.empty()) {
       int user_id = result[0]["user_id"].as<int>();
+      std::string user_type = result[0]["user_type"].as<std::string>();
       std::cout << "登录成功" << std::endl;
       response["message"] = "登录成功";
       response["user_id"] = user_id;
+      response["user_type"] = user_type;
 
       auto resp = HttpResponse::newHttpJsonResponse(response);
-      // 设置 Cookie
-      Cookie userIdCookie("user_id", std::to_string(user_id));
-      userIdCookie.setHttpOnly(true);
-      userIdCookie.setPath("/");
-      //userIdCookie.setMaxAge(3600); // 1小时
+      // 设置 Cookie：签名的会话令牌，携带 user_id 与角色
+      auto sessions = app().getPlugin<SessionManager>();
+      Cookie sessionCookie("session_token",
+                           sessions->issue(user_id, user_type));
+      sessionCookie.setHttpOnly(true);
+      sessionCookie.setPath("/");
+      sessionCookie.setMaxAge(sessions->tokenTtl());
 
       Cookie loginStatus("is_logged_in", "true");
       loginStatus.setHttpOnly(true);
       loginStatus.setPath("/");
-      //loginStatus.setMaxAge(3600);
+      loginStatus.setMaxAge(sessions->tokenTtl());
 
-      resp->addCookie(userIdCookie);
+      resp->addCookie(sessionCookie);
       resp->addCookie(loginStatus);
       resp->setStatusCode(k200OK);
       callback(resp);
@@ -105,42 +107,40 @@ void UserController::logout(
   Json::Value response;
   response["message"] = "登出成功";
 
+  // 撤销当前令牌，之后即使 Cookie 被重放也无法使用
+  auto sessions = app().getPlugin<SessionManager>();
+  common::SessionClaims claims;
+  const auto &token = req->getCookie("session_token");
+  if (!token.empty() && sessions->verify(token, claims)) {
+    sessions->revoke(claims);
+  }
+
   auto resp = HttpResponse::newHttpJsonResponse(response);
   // 清除 Cookie
-  Cookie userIdCookie("user_id", "");
-  userIdCookie.setPath("/");
-  userIdCookie.setMaxAge(0); // 删除
+  Cookie sessionCookie("session_token", "");
+  sessionCookie.setPath("/");
+  sessionCookie.setMaxAge(0); // 删除
 
   Cookie loginStatus("is_logged_in", "");
   loginStatus.setPath("/");
   loginStatus.setMaxAge(0);
   resp->setStatusCode(drogon::k200OK); 
-  resp->addCookie(userIdCookie);
+  resp->addCookie(sessionCookie);
   resp->addCookie(loginStatus);
 
   callback(resp);
 }
 
-void UserController::info(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback) const {
-  auto dbClient = drogon::app().getDbClient();
+Task<> UserController::info(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback) const {
   Json::Value response;
 
-  auto userIdCookie = req->getCookie("user_id");
-  if (userIdCookie.empty()) {
-    response["error"] = "未登录";
-    auto resp = HttpResponse::newHttpJsonResponse(response);
-    resp->setStatusCode(k401Unauthorized);
-    callback(resp);
-    return;
-  }
-
-  int user_id = std::stoi(userIdCookie);
+  // 当前登录用户，由 SessionFilter 校验令牌后写入
+  int user_id = common::currentSession(req).userId;
 
   try {
-    auto result =
-        dbClient->execSqlSync("SELECT * FROM user WHERE user_id = ?", user_id);
+    auto result = co_await dao::exec(req, dao::sql::kUserFindById, user_id);
     if (!result.empty()) {
       response["user_id"] = result[0]["user_id"].as<int>();
       response["username"] = result[0]["username"].as<std::string>();
@@ -152,14 +152,14 @@ void UserController::info(
       auto resp = HttpResponse::newHttpJsonResponse(response);
       resp->setStatusCode(k404NotFound);
       callback(resp);
-      return;
+      co_return;
     }
   } catch (...) {
     response["error"] = "数据库错误";
     auto resp = HttpResponse::newHttpJsonResponse(response);
     resp->setStatusCode(k500InternalServerError);
     callback(resp);
-    return;
+    co_return;
   }
 
   auto resp = HttpResponse::newHttpJsonResponse(response);
@@ -167,23 +167,14 @@ void UserController::info(
   callback(resp);
 }
 
-void UserController::update(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback) const {
-  auto dbClient = drogon::app().getDbClient();
+Task<> UserController::update(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback) const {
   auto json = req->getJsonObject();
   Json::Value response;
 
-  auto userIdCookie = req->getCookie("user_id");
-  if (userIdCookie.empty()) {
-    response["error"] = "未登录";
-    auto resp = HttpResponse::newHttpJsonResponse(response);
-    resp->setStatusCode(k401Unauthorized);
-    callback(resp);
-    return;
-  }
-
-  int user_id = std::stoi(userIdCookie);
+  // 当前登录用户，由 SessionFilter 校验令牌后写入
+  int user_id = common::currentSession(req).userId;
 
   std::string username = (*json)["username"].asString();
   std::string password = (*json)["password"].asString();
@@ -191,9 +182,8 @@ void UserController::update(
   std::string phone = (*json)["phone"].asString();
 
   try {
-    dbClient->execSqlSync(
-        "UPDATE user SET username = ?, password = ?, email = ?, phone = ? WHERE user_id = ?",
-        username, password, email, phone, user_id);
+    co_await dao::exec(req, dao::sql::kUserUpdate, username, password, email, phone,
+                       user_id);
     response["message"] = "更新成功";
     auto resp = HttpResponse::newHttpJsonResponse(response);
     resp->setStatusCode(drogon::k200OK); 
@@ -206,36 +196,28 @@ void UserController::update(
   }
 }
 
-void UserController::remove(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback) const {
-  auto dbClient = drogon::app().getDbClient();
+Task<> UserController::remove(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback) const {
   Json::Value response;
 
-  auto userIdCookie = req->getCookie("user_id");
-  if (userIdCookie.empty()) {
-    response["error"] = "未登录";
-    auto resp = HttpResponse::newHttpJsonResponse(response);
-    resp->setStatusCode(k401Unauthorized);
-    callback(resp);
-    return;
-  }
-
-  int user_id = std::stoi(userIdCookie);
+  // 当前登录用户，由 SessionFilter 校验令牌后写入
+  int user_id = common::currentSession(req).userId;
 
   try {
-    dbClient->execSqlSync("DELETE FROM user WHERE user_id = ?", user_id);
+    co_await dao::exec(req, dao::sql::kUserDelete, user_id);
     response["message"] = "删除成功";
 
-    // 同时登出（清除 cookie）
+    // 同时登出：撤销该用户的全部令牌并清除 cookie
+    app().getPlugin<SessionManager>()->revokeUser(user_id);
     auto resp = HttpResponse::newHttpJsonResponse(response);
-    Cookie userIdCookie("user_id", "");
-    userIdCookie.setPath("/");
-    userIdCookie.setMaxAge(0);
+    Cookie sessionCookie("session_token", "");
+    sessionCookie.setPath("/");
+    sessionCookie.setMaxAge(0);
     Cookie loginStatus("is_logged_in", "");
     loginStatus.setPath("/");
     loginStatus.setMaxAge(0);
-    resp->addCookie(userIdCookie);
+    resp->addCookie(sessionCookie);
     resp->addCookie(loginStatus);
     resp->setStatusCode(drogon::k200OK); 
     callback(resp);
@@ -247,45 +229,24 @@ void UserController::remove(
   }
 }
 
-void UserController::getUserRole(
-    const HttpRequestPtr &req,
-    std::function<void(const HttpResponsePtr &)> &&callback) const {
-  auto dbClient = drogon::app().getDbClient();
+Task<> UserController::getUserRole(
+    HttpRequestPtr req,
+    std::function<void(const HttpResponsePtr &)> callback) const {
   Json::Value response;
 
-  // 从 Cookie 中获取当前登录用户的 user_id
-  auto userIdCookie = req->getCookie("user_id");
-  if (userIdCookie.empty()) {
-    response["error"] = "未登录";
-    auto resp = HttpResponse::newHttpJsonResponse(response);
-    resp->setStatusCode(k401Unauthorized);
-    callback(resp);
-    return;
-  }
-
-  int user_id = std::stoi(userIdCookie);
+  // 当前登录用户，由 SessionFilter 校验令牌后写入
+  const auto &session = common::currentSession(req);
+  int user_id = session.userId;
 
   try {
-    // 查询用户的权限信息
-    auto userResult = dbClient->execSqlSync(
-        "SELECT user_type FROM user WHERE user_id = ?", user_id);
-
-    if (userResult.empty()) {
-      response["error"] = "用户不存在";
-      auto resp = HttpResponse::newHttpJsonResponse(response);
-      resp->setStatusCode(k404NotFound);
-      callback(resp);
-      return;
-    }
-
-    // 获取用户权限
-    std::string userType = userResult[0]["user_type"].as<std::string>();
+    // 用户权限取自会话令牌
+    std::string userType = session.userType;
     response["user_type"] = userType;
 
     // 如果用户是社长，查询其管理的社团
     if (userType == "社长") {
-      auto clubResult = dbClient->execSqlSync(
-          "SELECT club_id, club_name FROM club WHERE founder_id = ?", user_id);
+      auto clubResult =
+          co_await dao::exec(req, dao::sql::kClubNamesByFounder, user_id);
 
       Json::Value clubs(Json::arrayValue);
       for (const auto &row : clubResult) {
@@ -1,7 +1,9 @@
 #pragma once
+#include "common/RequestSchema.h"
 #include <drogon/HttpController.h>
 #include <drogon/HttpResponse.h>
 #include <drogon/HttpTypes.h>
+#include <drogon/utils/coroutine.h>
 #include <functional>
 #include <stdexcept>
 
@@ -24,104 +26,76 @@ public:
   // 登录接口
   ADD_METHOD_TO(UserController::login, "/user/login", Post);
   // 获取用户信息接口
-  ADD_METHOD_TO(UserController::info, "/user/info", Get);
+  ADD_METHOD_TO(UserController::info, "/user/info", Get, "SessionFilter");
   // 更新用户信息接口
-  ADD_METHOD_TO(UserController::update, "/user/update", Put);
+  ADD_METHOD_TO(UserController::update, "/user/update", Put, "SessionFilter");
   // 删除用户接口
-  ADD_METHOD_TO(UserController::remove, "/user/delete", Delete);
+  ADD_METHOD_TO(UserController::remove, "/user/delete", Delete, "SessionFilter");
   // 退出登录接口
   ADD_METHOD_TO(UserController::logout, "/user/logout", Post);
   // 获取用户权限接口
-  ADD_METHOD_TO(UserController::getUserRole, "/user/role", Get);
+  ADD_METHOD_TO(UserController::getUserRole, "/user/role", Get, "SessionFilter");
   METHOD_LIST_END
 
   // 注册方法
-  void m_register(const HttpRequestPtr &req,
-                  std::function<void(const HttpResponsePtr &)> &&callback,
-                  User user) const;
+  Task<> m_register(HttpRequestPtr req,
+                    std::function<void(const HttpResponsePtr &)> callback,
+                    User user) const;
 
   // 登录方法
-  void login(const HttpRequestPtr &req,
-             std::function<void(const HttpResponsePtr &)> &&callback) const;
+  Task<> login(HttpRequestPtr req,
+               std::function<void(const HttpResponsePtr &)> callback) const;
 
   // 获取用户信息方法
-  void info(const HttpRequestPtr &req,
-            std::function<void(const HttpResponsePtr &)> &&callback) const;
+  Task<> info(HttpRequestPtr req,
+              std::function<void(const HttpResponsePtr &)> callback) const;
 
   // 更新用户信息方法
-  void update(const HttpRequestPtr &req,
-              std::function<void(const HttpResponsePtr &)> &&callback) const;
+  Task<> update(HttpRequestPtr req,
+                std::function<void(const HttpResponsePtr &)> callback) const;
 
   // 删除用户方法
-  void remove(const HttpRequestPtr &req,
-              std::function<void(const HttpResponsePtr &)> &&callback) const;
+  Task<> remove(HttpRequestPtr req,
+                std::function<void(const HttpResponsePtr &)> callback) const;
 
   // 退出登录方法
   void logout(const HttpRequestPtr &req,
               std::function<void(const HttpResponsePtr &)> &&callback) const;
 
   // 获取用户权限方法
-  void getUserRole(const HttpRequestPtr &req,
-                   std::function<void(const HttpResponsePtr &)> &&callback) const;
+  Task<> getUserRole(HttpRequestPtr req,
+                     std::function<void(const HttpResponsePtr &)> callback) const;
+};
+
+// 用户类型的合法取值
+inline constexpr const char *kUserTypes[] = {"社员", "社长", "管理员"};
+
+// 请求体字段表，校验顺序与错误信息同原先逐字段解析一致
+template <> struct common::RequestSchema<User> {
+  static constexpr common::RequestField<User> fields[] = {
+      {.key = "username",
+       .text = &User::username,
+       .missing = "缺少必备字段: username",
+       .minLength = 3,
+       .tooShort = "用户名长度过短"},
+      {.key = "password",
+       .text = &User::password,
+       .missing = "缺少必备字段: password",
+       .minLength = 6,
+       .tooShort = "密码长度过短"},
+      {.key = "email", .text = &User::email},
+      {.key = "phone", .text = &User::phone},
+      {.key = "user_type",
+       .text = &User::user_type,
+       .defaultText = "社员",
+       .allowed = kUserTypes,
+       .notAllowed = "用户类型无效"},
+  };
 };
 
-// 自定义从请求中解析 User 对象的方法
+// 自定义从请求中解析 User 对象的方法：单遍扫描请求体，不构建 Json::Value
 namespace drogon {
 template <> inline User fromRequest(const HttpRequest &req) {
-  auto json = req.getJsonObject();
-  User value;
-
-  if (json == nullptr) {
-    throw std::runtime_error("请求体格式错误，请使用 JSON");
-  }
-
-  // 解析用户名
-  if (json->isMember("username")) {
-    const auto &temp = (*json)["username"].asString();
-    if (temp.size() < 3) {
-      throw std::runtime_error("用户名长度过短");
-    }
-    value.username = temp;
-  } else {
-    throw std::runtime_error("缺少必备字段: username");
-  }
-
-  // 解析密码
-  if (json->isMember("password")) {
-    const auto &temp = (*json)["password"].asString();
-    if (temp.size() < 6) {
-      throw std::runtime_error("密码长度过短");
-    }
-    value.password = temp;
-  } else {
-    throw std::runtime_error("缺少必备字段: password");
-  }
-
-  // 解析邮箱
-  if (json->isMember("email")) {
-    value.email = (*json)["email"].asString();
-  } else {
-    value.email = ""; // 默认值
-  }
-
-  // 解析手机号
-  if (json->isMember("phone")) {
-    value.phone = (*json)["phone"].asString();
-  } else {
-    value.phone = ""; // 默认值
-  }
-
-  // 解析用户类型
-  if (json->isMember("user_type")) {
-    const auto &temp = (*json)["user_type"].asString();
-    if (temp != "社员" && temp != "社长" && temp != "管理员") {
-      throw std::runtime_error("用户类型无效");
-    }
-    value.user_type = temp;
-  } else {
-    value.user_type = "社员"; // 默认值
-  }
-
-  return value;
+  return common::parseRequest<User>(req);
 }
 } // namespace drogon
\ No newline at end of file
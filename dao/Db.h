@@ -0,0 +1,307 @@
+#pragma once
+
+#include "common/RequestTiming.h"
+#include "dao/Statements.h"
+#include "plugins/AdmissionControl.h"
+#include "plugins/DbRouter.h"
+#include "plugins/QueryMetrics.h"
+#include "plugins/SlowQueryLog.h"
+#include <drogon/HttpAppFramework.h>
+#include <drogon/orm/DbClient.h>
+#include <drogon/orm/Exception.h>
+#include <drogon/utils/coroutine.h>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace dao {
+
+namespace detail {
+
+template <typename T> void appendParam(std::string &out, const T &value) {
+  if constexpr (std::is_same_v<T, bool>) {
+    out += value ? "true" : "false";
+  } else if constexpr (std::is_arithmetic_v<T>) {
+    out += std::to_string(value);
+  } else if constexpr (std::is_convertible_v<const T &, std::string_view>) {
+    out += '"';
+    out += std::string_view(value);
+    out += '"';
+  } else {
+    out += "?";
+  }
+}
+
+template <typename T>
+void appendParam(std::string &out, const std::optional<T> &value) {
+  if (value) {
+    appendParam(out, *value);
+  } else {
+    out += "NULL";
+  }
+}
+
+// 参数格式化为 [1, "abc"]，只在写慢查询日志时调用
+template <typename... Arguments>
+std::string formatParams(const Arguments &...args) {
+  std::string out = "[";
+  bool first = true;
+  ((out += first ? "" : ", ", first = false, appendParam(out, args)), ...);
+  out += ']';
+  return out;
+}
+
+// 记录一条慢查询，并以相同参数异步 EXPLAIN。
+// 敏感语句不记录参数，EXPLAIN 时占位符换成常量，参数不再发往数据库
+template <typename... Arguments>
+void logSlow(const drogon::orm::DbClientPtr &dbClient, const Statement &stmt,
+             double elapsedMs, const std::string &error,
+             const Arguments &...args) {
+  auto slowLog = drogon::app().getPlugin<SlowQueryLog>();
+  auto params = stmt.sensitive ? std::string("[redacted]")
+                               : formatParams(args...);
+  if (!slowLog->claimExplain(stmt)) {
+    slowLog->write(stmt, elapsedMs, params, error, nullptr);
+    return;
+  }
+  auto binder = stmt.sensitive
+                    ? *dbClient << explainSql(stmt.sql)
+                    : *dbClient << (std::string("EXPLAIN ") + stmt.sql);
+  if (!stmt.sensitive) {
+    (binder << ... << args);
+  }
+  binder >> [slowLog, &stmt, elapsedMs, params,
+             error](const drogon::orm::Result &result) {
+    slowLog->write(stmt, elapsedMs, params, error, &result);
+  };
+  binder >> [slowLog, &stmt, elapsedMs, params,
+             error](const drogon::orm::DrogonDbException &e) {
+    slowLog->write(stmt, elapsedMs, params, error, nullptr, e.base().what());
+  };
+  binder.exec();
+}
+
+inline void recordPhase(common::RequestTiming *timing, const Statement &stmt,
+                        double elapsedMs) {
+  if (timing != nullptr) {
+    timing->add("db", elapsedMs);
+    timing->add(std::string("db.") + stmt.name, elapsedMs);
+  }
+}
+
+// 在指定客户端上执行一条语句，并记录耗时、排队等待、行数与错误。
+// 排队与执行耗时同时计入 AdmissionControl，用于过载时降级；
+// 超过阈值的查询写入慢查询日志。参数不移交给 execSqlCoro，
+// 慢查询日志需要在查询结束后用到它们。
+// timing 不为空时耗时同时记入请求的 db 阶段。
+template <typename... Arguments>
+drogon::Task<drogon::orm::Result> run(drogon::orm::DbClientPtr dbClient,
+                                      common::RequestTiming *timing,
+                                      const Statement &stmt,
+                                      Arguments... args) {
+  auto probe = drogon::app().getPlugin<AdmissionControl>()->probe();
+  auto metrics = drogon::app().getPlugin<QueryMetrics>();
+  auto slowLog = drogon::app().getPlugin<SlowQueryLog>();
+  try {
+    auto result = co_await dbClient->execSqlCoro(stmt.sql, args...);
+    auto elapsed = probe.finish();
+    metrics->record(stmt, elapsed.elapsedMs, elapsed.waitMs,
+                    stmt.readOnly() ? result.size() : result.affectedRows());
+    recordPhase(timing, stmt, elapsed.elapsedMs);
+    if (slowLog->isSlow(elapsed.elapsedMs)) {
+      logSlow(dbClient, stmt, elapsed.elapsedMs, {}, args...);
+    }
+    co_return result;
+  } catch (const drogon::orm::DrogonDbException &e) {
+    auto elapsed = probe.finish();
+    metrics->recordError(stmt, elapsed.elapsedMs, elapsed.waitMs);
+    recordPhase(timing, stmt, elapsed.elapsedMs);
+    if (slowLog->isSlow(elapsed.elapsedMs)) {
+      logSlow(dbClient, stmt, elapsed.elapsedMs, e.base().what(), args...);
+    }
+    throw;
+  }
+}
+
+// 执行一条在运行时拼接的语句，挂起到结果返回
+class BoundQuery {
+public:
+  using Bind = std::function<void(drogon::orm::internal::SqlBinder &)>;
+
+  BoundQuery(drogon::orm::DbClientPtr dbClient, std::string sql, Bind bind)
+      : dbClient_(std::move(dbClient)), sql_(std::move(sql)),
+        bind_(std::move(bind)) {}
+
+  bool await_ready() const noexcept { return false; }
+
+  void await_suspend(std::coroutine_handle<> handle) {
+    auto binder = *dbClient_ << std::move(sql_);
+    bind_(binder);
+    binder >> [this, handle](const drogon::orm::Result &result) {
+      result_ = result;
+      handle.resume();
+    };
+    binder >> [this, handle](const std::exception_ptr &error) {
+      error_ = error;
+      handle.resume();
+    };
+    // 回调可能在 exec 返回前恢复协程，之后不再访问 this
+    binder.exec();
+  }
+
+  drogon::orm::Result await_resume() {
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+    return std::move(*result_);
+  }
+
+private:
+  drogon::orm::DbClientPtr dbClient_;
+  std::string sql_;
+  Bind bind_;
+  std::optional<drogon::orm::Result> result_;
+  std::exception_ptr error_;
+};
+
+// 等待事务提交的结果
+class CommitAwaiter {
+public:
+  explicit CommitAwaiter(std::shared_ptr<drogon::orm::Transaction> trans)
+      : trans_(std::move(trans)) {}
+
+  bool await_ready() const noexcept { return false; }
+
+  void await_suspend(std::coroutine_handle<> handle) {
+    trans_->setCommitCallback([this, handle](bool committed) {
+      committed_ = committed;
+      handle.resume();
+    });
+    // 释放最后一个引用，事务对象析构时提交
+    trans_.reset();
+  }
+
+  bool await_resume() const noexcept { return committed_; }
+
+private:
+  std::shared_ptr<drogon::orm::Transaction> trans_;
+  bool committed_ = false;
+};
+
+} // namespace detail
+
+// 提交事务，返回是否成功。调用方须持有事务的唯一引用，
+// 且事务未被回滚（回滚后不会再有提交回调）
+inline detail::CommitAwaiter commit(
+    std::shared_ptr<drogon::orm::Transaction> trans) {
+  return detail::CommitAwaiter(std::move(trans));
+}
+
+// "(?, ?, ?)"；count 为 0 时返回 "(NULL)"，IN 列表不匹配任何行
+inline std::string placeholders(size_t count) {
+  if (count == 0) {
+    return "(NULL)";
+  }
+  std::string out = "(?";
+  for (size_t i = 1; i < count; ++i) {
+    out += ", ?";
+  }
+  out += ')';
+  return out;
+}
+
+// 占位符个数在运行时才确定的语句（IN 列表、多行 INSERT）。
+// sql 以 stmt.sql 为前缀由调用方拼接，bind 依次绑定 paramCount 个参数。
+// 耗时、行数与错误的记录同 run；慢查询只记参数个数，不做 EXPLAIN。
+// dbClient 可以是事务。
+inline drogon::Task<drogon::orm::Result>
+execBound(drogon::orm::DbClientPtr dbClient, common::RequestTiming *timing,
+          const Statement &stmt, std::string sql, size_t paramCount,
+          detail::BoundQuery::Bind bind) {
+  auto probe = drogon::app().getPlugin<AdmissionControl>()->probe();
+  auto metrics = drogon::app().getPlugin<QueryMetrics>();
+  auto slowLog = drogon::app().getPlugin<SlowQueryLog>();
+  auto params = "[" + std::to_string(paramCount) + " 个参数]";
+  try {
+    auto result = co_await detail::BoundQuery(std::move(dbClient),
+                                              std::move(sql), std::move(bind));
+    auto elapsed = probe.finish();
+    metrics->record(stmt, elapsed.elapsedMs, elapsed.waitMs,
+                    stmt.readOnly() ? result.size() : result.affectedRows());
+    detail::recordPhase(timing, stmt, elapsed.elapsedMs);
+    if (slowLog->isSlow(elapsed.elapsedMs)) {
+      slowLog->write(stmt, elapsed.elapsedMs, params, {}, nullptr);
+    }
+    co_return result;
+  } catch (const drogon::orm::DrogonDbException &e) {
+    auto elapsed = probe.finish();
+    metrics->recordError(stmt, elapsed.elapsedMs, elapsed.waitMs);
+    detail::recordPhase(timing, stmt, elapsed.elapsedMs);
+    if (slowLog->isSlow(elapsed.elapsedMs)) {
+      slowLog->write(stmt, elapsed.elapsedMs, params, e.base().what(),
+                     nullptr);
+    }
+    throw;
+  }
+}
+
+// 以协程方式执行一条语句。
+// execSqlCoro 在查询期间挂起当前协程而不是阻塞 IO 线程，
+// 同一个 IO 线程上的其他请求可以继续处理。
+// 参数按值保存在协程帧中，调用方无需关心其生命周期。
+template <typename... Arguments>
+drogon::Task<drogon::orm::Result> exec(const Statement &stmt,
+                                       Arguments... args) {
+  co_return co_await detail::run(drogon::app().getDbClient(), nullptr, stmt,
+                                 std::move(args)...);
+}
+
+// 按请求路由：GET 请求中的只读查询发往该用户当前应使用的读客户端；
+// 其余请求中的查询多是写入前的校验，与写语句一起走主库，
+// 写语句提交后记下该用户的写入时刻（读己之写）。
+// 不带请求的 exec 一律走主库，供插件等需要最新数据的地方使用。
+template <typename... Arguments>
+drogon::Task<drogon::orm::Result> exec(const drogon::HttpRequestPtr &req,
+                                       const Statement &stmt,
+                                       Arguments... args) {
+  auto router = drogon::app().getPlugin<DbRouter>();
+  auto *timing = common::requestTiming(*req);
+  if (stmt.readOnly() && req->method() == drogon::Get) {
+    co_return co_await detail::run(router->reader(req), timing, stmt,
+                                   std::move(args)...);
+  }
+  auto result = co_await detail::run(drogon::app().getDbClient(), timing,
+                                     stmt, std::move(args)...);
+  if (!stmt.readOnly()) {
+    router->recordWrite(req);
+  }
+  co_return result;
+}
+
+// 插件代请求执行的查询：走主库，耗时记入该请求的 db 阶段，timing 可以为空
+template <typename... Arguments>
+drogon::Task<drogon::orm::Result> exec(common::RequestTiming *timing,
+                                       const Statement &stmt,
+                                       Arguments... args) {
+  co_return co_await detail::run(drogon::app().getDbClient(), timing, stmt,
+                                 std::move(args)...);
+}
+
+// 在指定客户端（通常是事务）上执行，记录同 run。
+// 不记写入时刻，调用方在事务提交后调用 DbRouter::recordWrite
+template <typename... Arguments>
+drogon::Task<drogon::orm::Result> exec(drogon::orm::DbClientPtr dbClient,
+                                       common::RequestTiming *timing,
+                                       const Statement &stmt,
+                                       Arguments... args) {
+  co_return co_await detail::run(std::move(dbClient), timing, stmt,
+                                 std::move(args)...);
+}
+
+} // namespace dao
@@ -0,0 +1,113 @@
+#include "Pagination.h"
+#include <drogon/utils/Utilities.h>
+#include <algorithm>
+#include <climits>
+
+namespace dao {
+
+namespace {
+constexpr int kDefaultLimit = 50;
+constexpr int kMaxLimit = 200;
+} // namespace
+
+DateCursor firstDateCursor() { return {"9999-12-31 23:59:59", INT_MAX}; }
+
+std::string encodeDateCursor(const std::string &date, int id) {
+  auto raw = date + "|" + std::to_string(id);
+  return drogon::utils::base64Encode(
+      reinterpret_cast<const unsigned char *>(raw.data()),
+      static_cast<unsigned int>(raw.size()), true);
+}
+
+bool decodeDateCursor(const std::string &token, DateCursor &cursor) {
+  auto raw = drogon::utils::base64Decode(token);
+  auto pos = raw.rfind('|');
+  if (pos == std::string::npos || pos == 0 || pos + 1 == raw.size()) {
+    return false;
+  }
+  try {
+    size_t used = 0;
+    cursor.id = std::stoi(raw.substr(pos + 1), &used);
+    if (used != raw.size() - pos - 1) {
+      return false;
+    }
+  } catch (const std::exception &) {
+    return false;
+  }
+  cursor.date = raw.substr(0, pos);
+  return true;
+}
+
+int pageLimit(const drogon::HttpRequestPtr &req) {
+  const auto &param = req->getParameter("limit");
+  if (param.empty()) {
+    return kDefaultLimit;
+  }
+  try {
+    size_t used = 0;
+    int limit = std::stoi(param, &used);
+    if (used != param.size() || limit <= 0) {
+      return -1;
+    }
+    return limit > kMaxLimit ? kMaxLimit : limit;
+  } catch (const std::exception &) {
+    return -1;
+  }
+}
+
+bool parseIdPage(const drogon::HttpRequestPtr &req, IdPage &page) {
+  page.limit = pageLimit(req);
+  page.afterId = 0;
+  if (page.limit < 0) {
+    return false;
+  }
+
+  std::string raw = req->getParameter("after_id");
+  const auto &cursor = req->getParameter("cursor");
+  if (!cursor.empty()) {
+    raw = drogon::utils::base64Decode(cursor);
+  }
+  if (raw.empty()) {
+    return true;
+  }
+  try {
+    size_t used = 0;
+    page.afterId = std::stoi(raw, &used);
+    return used == raw.size() && page.afterId >= 0;
+  } catch (const std::exception &) {
+    return false;
+  }
+}
+
+std::string encodeIdCursor(int id) {
+  auto raw = std::to_string(id);
+  return drogon::utils::base64Encode(
+      reinterpret_cast<const unsigned char *>(raw.data()),
+      static_cast<unsigned int>(raw.size()), true);
+}
+
+size_t pageSize(size_t rows, const IdPage &page) {
+  return std::min(rows, static_cast<size_t>(page.limit));
+}
+
+size_t pageSize(const drogon::orm::Result &result, const IdPage &page) {
+  return pageSize(result.size(), page);
+}
+
+std::optional<size_t> nextCursorRow(size_t rows, const IdPage &page) {
+  if (rows <= static_cast<size_t>(page.limit)) {
+    return std::nullopt;
+  }
+  return static_cast<size_t>(page.limit) - 1;
+}
+
+Json::Value nextIdCursor(const drogon::orm::Result &result,
+                         const IdPage &page, const char *idColumn) {
+  auto row = nextCursorRow(result.size(), page);
+  if (!row) {
+    return Json::Value();
+  }
+  return encodeIdCursor(result[*row][idColumn].as<int>());
+}
+
+} // namespace dao
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <drogon/HttpRequest.h>
+#include <drogon/orm/Result.h>
+#include <json/value.h>
+#include <optional>
+#include <string>
+
+// 列表接口的分页参数与游标。
+// 游标对客户端是不透明的字符串（URL 安全的 base64），
+// 内容是上一页最后一行的排序键，下一页从它之后开始取。
+
+namespace dao {
+
+// 按 (日期, id) 倒序翻页时的游标
+struct DateCursor {
+  std::string date; // 数据库中的日期字符串，如 2025-04-16 20:40:11
+  int id;
+};
+
+// 第一页使用的游标：比任何真实记录都大
+DateCursor firstDateCursor();
+
+std::string encodeDateCursor(const std::string &date, int id);
+
+// 解析失败返回 false
+bool decodeDateCursor(const std::string &token, DateCursor &cursor);
+
+// 读取 ?limit=，缺省 50，最大 200；非法值返回 -1
+int pageLimit(const drogon::HttpRequestPtr &req);
+
+// 按自增 id 升序翻页：取 id > afterId 的前 limit 行
+struct IdPage {
+  int afterId;
+  int limit;
+};
+
+// 解析 ?after_id=、?cursor= 与 ?limit=，cursor 优先于 after_id。
+// 参数非法时返回 false
+bool parseIdPage(const drogon::HttpRequestPtr &req, IdPage &page);
+
+std::string encodeIdCursor(int id);
+
+// 查询按 limit + 1 取数，返回本页实际行数
+size_t pageSize(size_t rows, const IdPage &page);
+size_t pageSize(const drogon::orm::Result &result, const IdPage &page);
+
+// 取回 rows 行时下一页游标所在的行，即本页最后一行；没有下一页时返回空
+std::optional<size_t> nextCursorRow(size_t rows, const IdPage &page);
+
+// 还有下一页时返回本页最后一行 idColumn 的游标，否则返回 null
+Json::Value nextIdCursor(const drogon::orm::Result &result,
+                         const IdPage &page, const char *idColumn);
+
+} // namespace dao
@@ -0,0 +1,589 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// 控制器使用的全部 SQL 语句。
+// 每条语句有一个稳定的名字，便于日志、监控中按语句定位。
+
+namespace dao {
+
+struct Statement {
+  const char *name; // 语句名，形如 "表.动作"
+  const char *sql;  // 带 ? 占位符的 SQL
+  // 参数含密码等敏感数据：慢查询日志不记录参数，EXPLAIN 不带真实参数
+  bool sensitive = false;
+
+  // 只读查询（SELECT 开头），可以发往只读库
+  constexpr bool readOnly() const {
+    const char *prefix = "SELECT ";
+    for (size_t i = 0; prefix[i] != '\0'; ++i) {
+      if (sql[i] != prefix[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+// 占位符换成常量即可 EXPLAIN，语句中没有带 ? 的字符串字面量
+inline std::string explainSql(const char *sql) {
+  std::string out = "EXPLAIN ";
+  for (const char *p = sql; *p != '\0'; ++p) {
+    out += *p == '?' ? '1' : *p;
+  }
+  return out;
+}
+
+namespace sql {
+
+// ---------------------------- user ----------------------------
+inline constexpr Statement kUserCountByName{
+    "user.count_by_name",
+    "SELECT COUNT(*) AS count FROM user WHERE username = ?"};
+inline constexpr Statement kUserInsert{
+    "user.insert",
+    "INSERT INTO user (username, password, email, phone, user_type) "
+    "VALUES (?, ?, ?, ?, ?)",
+    true};
+inline constexpr Statement kUserFindByCredentials{
+    "user.find_by_credentials",
+    "SELECT * FROM user WHERE username = ? AND password = ?",
+    true};
+inline constexpr Statement kUserFindById{
+    "user.find_by_id", "SELECT * FROM user WHERE user_id = ?"};
+inline constexpr Statement kUserUpdate{
+    "user.update",
+    "UPDATE user SET username = ?, password = ?, email = ?, phone = ? "
+    "WHERE user_id = ?",
+    true};
+inline constexpr Statement kUserDelete{"user.delete",
+                                       "DELETE FROM user WHERE user_id = ?"};
+inline constexpr Statement kUserTypeById{
+    "user.type_by_id", "SELECT user_type FROM user WHERE user_id = ?"};
+inline constexpr Statement kUserPromotePresident{
+    "user.promote_president",
+    "UPDATE user SET user_type = '社长' WHERE user_id = ?"};
+// 批量导入时按 user_id 解析：前缀后接 user_id 的占位符列表
+inline constexpr Statement kUserResolve{
+    "user.resolve",
+    "SELECT user_id, username FROM user WHERE user_id IN "};
+// 批量导入时按 username 解析。username 没有唯一键，且按列的排序规则
+// （utf8mb4_0900_ai_ci，不区分大小写与重音）比较，一个名字可能对应多个用户；
+// 文件中的名字作为派生表与 user 连接，每行带回匹配它的原始名字 name。
+// 前缀后接 kUserResolveByNameRow 重复 n - 1 次，再接 kUserResolveByNameEnd
+inline constexpr Statement kUserResolveByName{
+    "user.resolve_by_name",
+    "SELECT n.name, u.user_id, u.username FROM "
+    "(SELECT CONVERT(? USING utf8mb4) AS name"};
+inline constexpr const char *kUserResolveByNameRow =
+    " UNION ALL SELECT CONVERT(? USING utf8mb4)";
+inline constexpr const char *kUserResolveByNameEnd =
+    ") AS n JOIN user u ON u.username = n.name";
+
+// ---------------------------- club ----------------------------
+inline constexpr Statement kClubCountByName{
+    "club.count_by_name",
+    "SELECT COUNT(*) AS count FROM club WHERE club_name = ?"};
+inline constexpr Statement kClubInsert{
+    "club.insert",
+    "INSERT INTO club (club_name, club_introduction, contact_info, "
+    "activity_venue, founder_id) VALUES (?, ?, ?, ?, ?)"};
+// 列表类语句按主键升序翻页，最后两个参数为 after_id 与 limit
+inline constexpr Statement kClubList{
+    "club.list",
+    "SELECT club_id, club_name, club_introduction FROM club "
+    "WHERE club_id > ? ORDER BY club_id LIMIT ?"};
+// 社团目录快照，一次取出整张表
+inline constexpr Statement kClubCatalog{
+    "club.catalog",
+    "SELECT club_id, club_name, club_introduction, contact_info, "
+    "activity_venue, founder_id FROM club ORDER BY club_id"};
+inline constexpr Statement kClubFindById{
+    "club.find_by_id", "SELECT * FROM club WHERE club_id = ?"};
+inline constexpr Statement kClubListByFounder{
+    "club.list_by_founder",
+    "SELECT club_id, club_name, club_introduction, contact_info, "
+    "activity_venue FROM club WHERE founder_id = ?"};
+inline constexpr Statement kClubNamesByFounder{
+    "club.names_by_founder",
+    "SELECT club_id, club_name FROM club WHERE founder_id = ?"};
+inline constexpr Statement kClubIdsByFounder{
+    "club.ids_by_founder",
+    "SELECT c.club_id FROM club c WHERE c.founder_id = ?"};
+inline constexpr Statement kClubFounderById{
+    "club.founder_by_id", "SELECT founder_id FROM club WHERE club_id = ?"};
+inline constexpr Statement kClubFounderByActivity{
+    "club.founder_by_activity",
+    "SELECT a.club_id, c.founder_id FROM club c "
+    "JOIN club_activity a ON c.club_id = a.club_id "
+    "WHERE a.activity_id = ?"};
+
+// ------------------------ club_approval -----------------------
+inline constexpr Statement kApprovalInsert{
+    "club_approval.insert",
+    "INSERT INTO club_approval (club_name, club_introduction, "
+    "contact_info, activity_venue, applicant_id, approval_status, "
+    "approval_opinion, approval_time) "
+    "VALUES (?, ?, ?, ?, ?, '待审核', NULL, NOW())"};
+inline constexpr Statement kApprovalFindById{
+    "club_approval.find_by_id",
+    "SELECT club_name, club_introduction, contact_info, activity_venue, "
+    "applicant_id FROM club_approval WHERE approval_id = ?"};
+inline constexpr Statement kApprovalUpdateStatus{
+    "club_approval.update_status",
+    "UPDATE club_approval SET approval_status = ?, approval_opinion = ? "
+    "WHERE approval_id = ?"};
+inline constexpr Statement kApprovalListAll{
+    "club_approval.list_all",
+    "SELECT ca.approval_id, ca.club_name, ca.applicant_id, "
+    "u.username AS applicant_name, "
+    "ca.approval_status, ca.approval_opinion, ca.approval_time "
+    "FROM club_approval ca "
+    "JOIN user u ON ca.applicant_id = u.user_id "
+    "WHERE ca.approval_id > ? ORDER BY ca.approval_id LIMIT ?"};
+inline constexpr Statement kApprovalListByApplicant{
+    "club_approval.list_by_applicant",
+    "SELECT ca.approval_id, ca.club_name, ca.applicant_id, "
+    "u.username AS applicant_name, "
+    "ca.approval_status, ca.approval_opinion, ca.approval_time "
+    "FROM club_approval ca "
+    "JOIN user u ON ca.applicant_id = u.user_id "
+    "WHERE ca.applicant_id = ? AND ca.approval_id > ? "
+    "ORDER BY ca.approval_id LIMIT ?"};
+
+// ------------------------- club_member ------------------------
+inline constexpr Statement kMemberInsertPresident{
+    "club_member.insert_president",
+    "INSERT INTO club_member (user_id, club_id, join_date, member_role) "
+    "VALUES (?, ?, NOW(), '社长')"};
+// (user_id, club_id) 有唯一键，已是成员时不写入，affectedRows 为 0
+inline constexpr Statement kMemberInsert{
+    "club_member.insert",
+    "INSERT IGNORE INTO club_member (user_id, club_id, join_date, member_role) "
+    "VALUES (?, ?, NOW(), '社员')"};
+inline constexpr Statement kMemberFind{
+    "club_member.find",
+    "SELECT member_id FROM club_member WHERE user_id = ? AND club_id = ?"};
+inline constexpr Statement kMemberDelete{
+    "club_member.delete", "DELETE FROM club_member WHERE member_id = ?"};
+inline constexpr Statement kMemberClubById{
+    "club_member.club_by_id",
+    "SELECT club_id FROM club_member WHERE member_id = ?"};
+// 各社团成员数，内存计数的校正基准
+inline constexpr Statement kMemberCountsByClub{
+    "club_member.counts_by_club",
+    "SELECT club_id, COUNT(*) AS members FROM club_member GROUP BY club_id"};
+// 批量导入：前缀后接 user_id 的占位符列表与 kMemberExistingInEnd，
+// 参数为 club_id 与各 user_id。加锁读，并发的审核与导入在事务提交前
+// 无法写入这些 (user_id, club_id)
+inline constexpr Statement kMemberExistingIn{
+    "club_member.existing_in",
+    "SELECT user_id FROM club_member WHERE club_id = ? AND user_id IN "};
+inline constexpr const char *kMemberExistingInEnd = " FOR UPDATE";
+// 批量写入：前缀后接若干组 kMemberInsertBatchRow，以逗号分隔
+inline constexpr Statement kMemberInsertBatch{
+    "club_member.insert_batch",
+    "INSERT INTO club_member (user_id, club_id, join_date, member_role) "
+    "VALUES "};
+inline constexpr const char *kMemberInsertBatchRow = "(?, ?, NOW(), '社员')";
+// 社团统计：按月的入社人数（只含仍在社团中的成员）
+inline constexpr Statement kMemberGrowthByClub{
+    "club_member.growth_by_club",
+    "SELECT DATE_FORMAT(join_date, '%Y-%m') AS month, COUNT(*) AS joined "
+    "FROM club_member WHERE club_id = ? GROUP BY month ORDER BY month"};
+inline constexpr Statement kMemberListByClub{
+    "club_member.list_by_club",
+    "SELECT club_member.member_id, user.user_id, user.username, user.email, "
+    "user.phone, club_member.member_role FROM club_member "
+    "JOIN user ON club_member.user_id = user.user_id "
+    "WHERE club_member.club_id = ? AND club_member.member_id > ? "
+    "ORDER BY club_member.member_id LIMIT ?"};
+// 用户所在全部社团的活动及本人报名状态，一次查询完成。
+// 没有活动的社团也会返回一行（activity_id 为 NULL），用于区分"未加入社团"；
+// 同一活动存在多条报名记录时（取消后重新报名）取最新一条。
+inline constexpr Statement kMemberActivityFeed{
+    "club_member.activity_feed",
+    "SELECT c.club_id, c.club_name, a.activity_id, a.activity_title, "
+    "a.activity_time, a.activity_location, a.activity_description, "
+    "r.registration_status "
+    "FROM club_member m "
+    "JOIN club c ON m.club_id = c.club_id "
+    "LEFT JOIN club_activity a ON a.club_id = c.club_id "
+    "LEFT JOIN activity_registration r ON r.registration_id = ("
+    "SELECT MAX(r2.registration_id) FROM activity_registration r2 "
+    "WHERE r2.user_id = m.user_id AND r2.activity_id = a.activity_id) "
+    "WHERE m.user_id = ? "
+    "ORDER BY c.club_id, a.activity_id"};
+
+// ---------------------- club_member_apply ---------------------
+inline constexpr Statement kApplyFindByStatus{
+    "club_member_apply.find_by_status",
+    "SELECT apply_id FROM club_member_apply "
+    "WHERE user_id = ? AND club_id = ? AND status = ?"};
+inline constexpr Statement kApplyInsert{
+    "club_member_apply.insert",
+    "INSERT INTO club_member_apply (user_id, club_id, apply_date, status) "
+    "VALUES (?, ?, NOW(), ?)"};
+inline constexpr Statement kApplyFindPending{
+    "club_member_apply.find_pending",
+    "SELECT user_id, club_id FROM club_member_apply "
+    "WHERE apply_id = ? AND status = 'pending'"};
+inline constexpr Statement kApplyUpdateStatus{
+    "club_member_apply.update_status",
+    "UPDATE club_member_apply SET status = ? WHERE apply_id = ?"};
+// 批量导入后结案这些用户的待审核申请：前缀后接 user_id 的占位符列表
+inline constexpr Statement kApplyApproveIn{
+    "club_member_apply.approve_in",
+    "UPDATE club_member_apply SET status = 'approved' "
+    "WHERE club_id = ? AND status = 'pending' AND user_id IN "};
+// 社长名下所有社团的入社申请，按申请时间倒序翻页。
+// 参数：founder_id, status, status（空串表示不过滤）, 游标日期, 游标 id, limit
+inline constexpr Statement kApplyInboxByFounder{
+    "club_member_apply.inbox_by_founder",
+    "SELECT a.apply_id, a.club_id, c.club_name, a.user_id, "
+    "u.username AS user_name, a.apply_date, a.status "
+    "FROM club c "
+    "JOIN club_member_apply a ON a.club_id = c.club_id "
+    "JOIN user u ON a.user_id = u.user_id "
+    "WHERE c.founder_id = ? AND (? = '' OR a.status = ?) "
+    "AND (a.apply_date, a.apply_id) < (?, ?) "
+    "ORDER BY a.apply_date DESC, a.apply_id DESC LIMIT ?"};
+
+// ------------------------ club_activity -----------------------
+inline constexpr Statement kActivityCountByTitle{
+    "club_activity.count_by_title",
+    "SELECT COUNT(*) AS count FROM club_activity "
+    "WHERE club_id = ? AND activity_title = ?"};
+inline constexpr Statement kActivityInsert{
+    "club_activity.insert",
+    "INSERT INTO club_activity (club_id, activity_title, activity_time, "
+    "activity_location, registration_method, activity_description, "
+    "capacity, waitlist_capacity, publish_time) "
+    "VALUES (?, ?, ?, ?, ?, ?, NULLIF(?, 0), ?, NOW())"};
+inline constexpr Statement kActivityListByClub{
+    "club_activity.list_by_club",
+    "SELECT activity_id, activity_title, activity_time FROM club_activity "
+    "WHERE club_id = ?"};
+inline constexpr Statement kActivityDetailsByClub{
+    "club_activity.details_by_club",
+    "SELECT activity_id, activity_title, activity_time, activity_location, "
+    "activity_description FROM club_activity WHERE club_id = ?"};
+inline constexpr Statement kActivityFindById{
+    "club_activity.find_by_id",
+    "SELECT * FROM club_activity WHERE activity_id = ?"};
+inline constexpr Statement kActivityUpdate{
+    "club_activity.update",
+    "UPDATE club_activity SET activity_title = ?, activity_time = ?, "
+    "activity_location = ?, registration_method = ?, "
+    "activity_description = ? WHERE activity_id = ?"};
+// 名额为 0 表示不限
+inline constexpr Statement kActivityUpdateCapacity{
+    "club_activity.update_capacity",
+    "UPDATE club_activity SET capacity = NULLIF(?, 0) WHERE activity_id = ?"};
+inline constexpr Statement kActivityUpdateWaitlistCapacity{
+    "club_activity.update_waitlist_capacity",
+    "UPDATE club_activity SET waitlist_capacity = ? WHERE activity_id = ?"};
+// 名额计数的初始值：pending、accepted 占用名额，waitlist 为候补
+inline constexpr Statement kActivitySeatCounts{
+    "club_activity.seat_counts",
+    "SELECT a.capacity, a.waitlist_capacity, "
+    "COUNT(CASE WHEN r.registration_status IN ('pending', 'accepted') "
+    "THEN 1 END) AS seats, "
+    "COUNT(CASE WHEN r.registration_status = 'waitlist' THEN 1 END) "
+    "AS waiting "
+    "FROM club_activity a "
+    "LEFT JOIN activity_registration r ON r.activity_id = a.activity_id "
+    "WHERE a.activity_id = ? GROUP BY a.activity_id"};
+inline constexpr Statement kActivityDelete{
+    "club_activity.delete",
+    "DELETE FROM club_activity WHERE activity_id = ?"};
+// 搜索索引的数据源
+inline constexpr Statement kActivitySearchSource{
+    "club_activity.search_source",
+    "SELECT activity_id, club_id, activity_title, activity_time, "
+    "activity_description FROM club_activity ORDER BY activity_id"};
+// 活动日历的数据源；没有时间的活动不进日历
+inline constexpr Statement kActivityCalendar{
+    "club_activity.calendar",
+    "SELECT activity_id, club_id, activity_title, activity_time, "
+    "activity_location FROM club_activity WHERE activity_time IS NOT NULL"};
+inline constexpr Statement kActivityCalendarById{
+    "club_activity.calendar_by_id",
+    "SELECT activity_id, club_id, activity_title, activity_time, "
+    "activity_location FROM club_activity WHERE activity_id = ?"};
+
+// -------------------- activity_registration -------------------
+inline constexpr Statement kRegistrationStatus{
+    "activity_registration.status",
+    "SELECT registration_status FROM activity_registration "
+    "WHERE user_id = ? AND activity_id = ? "
+    "ORDER BY registration_id DESC LIMIT 1"};
+// 签到校验：有任意状态的报名记录即可签到
+inline constexpr Statement kRegistrationCount{
+    "activity_registration.count",
+    "SELECT COUNT(*) AS count FROM activity_registration "
+    "WHERE user_id = ? AND activity_id = ?"};
+// 活动的全部报名，按报名先后，SeatLedger 据此得到每个用户最近一次的状态
+inline constexpr Statement kRegistrationStatusesByActivity{
+    "activity_registration.statuses_by_activity",
+    "SELECT user_id, registration_status FROM activity_registration "
+    "WHERE activity_id = ? ORDER BY registration_id"};
+inline constexpr Statement kRegistrationUsersByActivity{
+    "activity_registration.users_by_activity",
+    "SELECT DISTINCT user_id FROM activity_registration WHERE activity_id = ?"};
+inline constexpr Statement kRegistrationInsert{
+    "activity_registration.insert",
+    "INSERT INTO activity_registration (user_id, activity_id, "
+    "registration_date, registration_status) "
+    "VALUES (?, ?, NOW(), ?)"};
+inline constexpr Statement kRegistrationCancel{
+    "activity_registration.cancel",
+    "UPDATE activity_registration SET registration_status = 'cancel' "
+    "WHERE user_id = ? AND activity_id = ? AND registration_status = ?"};
+inline constexpr Statement kRegistrationReview{
+    "activity_registration.review",
+    "UPDATE activity_registration SET registration_status = ? "
+    "WHERE registration_id = ? AND registration_status = ?"};
+// 候补名单按报名先后递补
+inline constexpr Statement kRegistrationFirstWaitlisted{
+    "activity_registration.first_waitlisted",
+    "SELECT registration_id, user_id FROM activity_registration "
+    "WHERE activity_id = ? AND registration_status = 'waitlist' "
+    "ORDER BY registration_id LIMIT 1"};
+inline constexpr Statement kRegistrationPromote{
+    "activity_registration.promote",
+    "UPDATE activity_registration SET registration_status = 'pending' "
+    "WHERE registration_id = ? AND registration_status = 'waitlist'"};
+// 社长看到名下所有社团活动的报名，其他用户只看到自己的报名，
+// 按报名时间倒序翻页。
+// 参数：user_id, user_id, user_id, status, status（空串表示不过滤）,
+//       游标日期, 游标 id, limit
+inline constexpr Statement kRegistrationInbox{
+    "activity_registration.inbox",
+    "SELECT r.registration_id, r.user_id, r.activity_id, "
+    "r.registration_date, r.payment_status, r.registration_status "
+    "FROM activity_registration r "
+    "JOIN club_activity a ON r.activity_id = a.activity_id "
+    "JOIN club c ON a.club_id = c.club_id "
+    "WHERE (c.founder_id = ? OR (r.user_id = ? AND NOT EXISTS ("
+    "SELECT 1 FROM club f WHERE f.founder_id = ?))) "
+    "AND (? = '' OR r.registration_status = ?) "
+    "AND (r.registration_date, r.registration_id) < (?, ?) "
+    "ORDER BY r.registration_date DESC, r.registration_id DESC LIMIT ?"};
+inline constexpr Statement kRegistrationDetailsByClub{
+    "activity_registration.details_by_club",
+    "SELECT a.activity_id, a.activity_title, r.registration_id, r.user_id, "
+    "u.username, r.registration_date, r.payment_status, "
+    "r.registration_status "
+    "FROM club_activity a "
+    "JOIN activity_registration r ON a.activity_id = r.activity_id "
+    "JOIN user u ON r.user_id = u.user_id "
+    "WHERE a.club_id = ? AND r.registration_id > ? "
+    "ORDER BY r.registration_id LIMIT ?"};
+inline constexpr Statement kRegistrationApprovedByUser{
+    "activity_registration.approved_by_user",
+    "SELECT a.activity_id, a.activity_title, a.activity_time, "
+    "a.activity_location, a.activity_description, r.payment_status "
+    "FROM activity_registration r "
+    "JOIN club_activity a ON r.activity_id = a.activity_id "
+    "WHERE r.user_id = ? AND r.registration_status = 'accepted'"};
+// 已通过的报名及签到状态，签到状态由 EXISTS 子查询在同一次往返中取回
+inline constexpr Statement kRegistrationAcceptedWithCheckin{
+    "activity_registration.accepted_with_checkin",
+    "SELECT r.registration_id, a.activity_id, a.activity_title, "
+    "a.activity_time, a.activity_location, a.activity_description, "
+    "r.payment_status, "
+    "EXISTS (SELECT 1 FROM activity_checkin k "
+    "WHERE k.activity_id = r.activity_id AND k.user_id = r.user_id) "
+    "AS checked_in "
+    "FROM activity_registration r "
+    "JOIN club_activity a ON r.activity_id = a.activity_id "
+    "WHERE r.user_id = ? AND r.registration_status = 'accepted'"};
+// 同上，只取指定活动：前缀后接 activity_id 的占位符列表，
+// 参数为 user_id 与各 activity_id
+inline constexpr Statement kRegistrationAcceptedWithCheckinIn{
+    "activity_registration.accepted_with_checkin_in",
+    "SELECT r.registration_id, a.activity_id, a.activity_title, "
+    "a.activity_time, a.activity_location, a.activity_description, "
+    "r.payment_status, "
+    "EXISTS (SELECT 1 FROM activity_checkin k "
+    "WHERE k.activity_id = r.activity_id AND k.user_id = r.user_id) "
+    "AS checked_in "
+    "FROM activity_registration r "
+    "JOIN club_activity a ON r.activity_id = a.activity_id "
+    "WHERE r.user_id = ? AND r.registration_status = 'accepted' "
+    "AND r.activity_id IN "};
+inline constexpr Statement kRegistrationActivityById{
+    "activity_registration.activity_by_id",
+    "SELECT activity_id, user_id, registration_status "
+    "FROM activity_registration WHERE registration_id = ?"};
+inline constexpr Statement kRegistrationPaymentById{
+    "activity_registration.payment_by_id",
+    "SELECT activity_id, payment_status FROM activity_registration "
+    "WHERE registration_id = ?"};
+inline constexpr Statement kRegistrationUpdatePayment{
+    "activity_registration.update_payment",
+    "UPDATE activity_registration SET payment_status = ? "
+    "WHERE registration_id = ?"};
+// 各活动按状态的报名数，内存计数的校正基准
+inline constexpr Statement kRegistrationCountsByActivity{
+    "activity_registration.counts_by_activity",
+    "SELECT activity_id, "
+    "COUNT(CASE WHEN registration_status = 'pending' THEN 1 END) AS pending, "
+    "COUNT(CASE WHEN registration_status = 'accepted' THEN 1 END) "
+    "AS accepted, "
+    "COUNT(CASE WHEN registration_status = 'waitlist' THEN 1 END) "
+    "AS waitlist "
+    "FROM activity_registration "
+    "WHERE registration_status IN ('pending', 'accepted', 'waitlist') "
+    "GROUP BY activity_id"};
+// 社团统计：每个活动的报名漏斗与已通过报名的缴费情况，没有报名的活动也返回一行
+inline constexpr Statement kRegistrationFunnelByClub{
+    "activity_registration.funnel_by_club",
+    "SELECT a.activity_id, a.activity_title, a.activity_time, "
+    "COUNT(CASE WHEN r.registration_status = 'pending' THEN 1 END) "
+    "AS pending, "
+    "COUNT(CASE WHEN r.registration_status = 'accepted' THEN 1 END) "
+    "AS accepted, "
+    "COUNT(CASE WHEN r.registration_status = 'rejected' THEN 1 END) "
+    "AS rejected, "
+    "COUNT(CASE WHEN r.registration_status = 'cancel' THEN 1 END) AS cancel, "
+    "COUNT(CASE WHEN r.registration_status = 'waitlist' THEN 1 END) "
+    "AS waitlist, "
+    "COUNT(CASE WHEN r.registration_status = 'accepted' "
+    "AND r.payment_status = '已缴费' THEN 1 END) AS paid "
+    "FROM club_activity a "
+    "LEFT JOIN activity_registration r ON r.activity_id = a.activity_id "
+    "WHERE a.club_id = ? GROUP BY a.activity_id ORDER BY a.activity_id"};
+
+// ----------------------- activity_checkin ---------------------
+inline constexpr Statement kCheckinInsert{
+    "activity_checkin.insert",
+    "INSERT INTO activity_checkin (user_id, activity_id, checkin_time) "
+    "VALUES (?, ?, NOW())"};
+// 批量写入：前缀后接若干组 kCheckinInsertBatchRow，以逗号分隔
+inline constexpr Statement kCheckinInsertBatch{
+    "activity_checkin.insert_batch",
+    "INSERT INTO activity_checkin (user_id, activity_id, checkin_time) "
+    "VALUES "};
+inline constexpr const char *kCheckinInsertBatchRow = "(?, ?, NOW())";
+inline constexpr Statement kCheckinUsersByActivity{
+    "activity_checkin.users_by_activity",
+    "SELECT user_id FROM activity_checkin WHERE activity_id = ?"};
+inline constexpr Statement kCheckinListByActivity{
+    "activity_checkin.list_by_activity",
+    "SELECT checkin_id, user_id, checkin_time FROM activity_checkin "
+    "WHERE activity_id = ? AND checkin_id > ? "
+    "ORDER BY checkin_id LIMIT ?"};
+inline constexpr Statement kCheckinCountsByActivity{
+    "activity_checkin.counts_by_activity",
+    "SELECT activity_id, COUNT(*) AS checked_in FROM activity_checkin "
+    "GROUP BY activity_id"};
+// 社团统计：每个活动的签到人数
+inline constexpr Statement kCheckinCountsByClub{
+    "activity_checkin.counts_by_club",
+    "SELECT k.activity_id, COUNT(*) AS checked_in "
+    "FROM club_activity a "
+    "JOIN activity_checkin k ON k.activity_id = a.activity_id "
+    "WHERE a.club_id = ? GROUP BY k.activity_id"};
+
+// --------------------------- schema ---------------------------
+// 当前库中的表名，启动预热时核对表是否齐全
+inline constexpr Statement kSchemaTables{
+    "schema.tables",
+    "SELECT table_name AS name FROM information_schema.tables "
+    "WHERE table_schema = DATABASE()"};
+
+// 以上全部完整语句，启动预热时逐条校验。
+// 只是前缀、由调用方拼接占位符的语句列在 kPrefixes 中
+inline constexpr const Statement *kAll[] = {
+    &kUserCountByName,
+    &kUserInsert,
+    &kUserFindByCredentials,
+    &kUserFindById,
+    &kUserUpdate,
+    &kUserDelete,
+    &kUserTypeById,
+    &kUserPromotePresident,
+    &kClubCountByName,
+    &kClubInsert,
+    &kClubList,
+    &kClubCatalog,
+    &kClubFindById,
+    &kClubListByFounder,
+    &kClubNamesByFounder,
+    &kClubIdsByFounder,
+    &kClubFounderById,
+    &kClubFounderByActivity,
+    &kApprovalInsert,
+    &kApprovalFindById,
+    &kApprovalUpdateStatus,
+    &kApprovalListAll,
+    &kApprovalListByApplicant,
+    &kMemberInsertPresident,
+    &kMemberInsert,
+    &kMemberFind,
+    &kMemberDelete,
+    &kMemberClubById,
+    &kMemberCountsByClub,
+    &kMemberGrowthByClub,
+    &kMemberListByClub,
+    &kMemberActivityFeed,
+    &kApplyFindByStatus,
+    &kApplyInsert,
+    &kApplyFindPending,
+    &kApplyUpdateStatus,
+    &kApplyInboxByFounder,
+    &kActivityCountByTitle,
+    &kActivityInsert,
+    &kActivityListByClub,
+    &kActivityDetailsByClub,
+    &kActivityFindById,
+    &kActivityUpdate,
+    &kActivityUpdateCapacity,
+    &kActivityUpdateWaitlistCapacity,
+    &kActivitySeatCounts,
+    &kActivityDelete,
+    &kActivitySearchSource,
+    &kActivityCalendar,
+    &kActivityCalendarById,
+    &kRegistrationStatus,
+    &kRegistrationStatusesByActivity,
+    &kRegistrationCount,
+    &kRegistrationUsersByActivity,
+    &kRegistrationInsert,
+    &kRegistrationCancel,
+    &kRegistrationReview,
+    &kRegistrationFirstWaitlisted,
+    &kRegistrationPromote,
+    &kRegistrationInbox,
+    &kRegistrationDetailsByClub,
+    &kRegistrationApprovedByUser,
+    &kRegistrationAcceptedWithCheckin,
+    &kRegistrationActivityById,
+    &kRegistrationPaymentById,
+    &kRegistrationUpdatePayment,
+    &kRegistrationCountsByActivity,
+    &kRegistrationFunnelByClub,
+    &kCheckinInsert,
+    &kCheckinUsersByActivity,
+    &kCheckinListByActivity,
+    &kCheckinCountsByActivity,
+    &kCheckinCountsByClub,
+    &kSchemaTables,
+};
+
+// 前缀语句，不能直接 EXPLAIN，只登记监控指标
+inline constexpr const Statement *kPrefixes[] = {
+    &kUserResolve,
+    &kUserResolveByName,
+    &kMemberExistingIn,
+    &kMemberInsertBatch,
+    &kApplyApproveIn,
+    &kRegistrationAcceptedWithCheckinIn,
+    &kCheckinInsertBatch,
+};
+
+} // namespace sql
+} // namespace dao
@@ -0,0 +1,28 @@
+#include "SessionFilter.h"
+#include "common/RequestTiming.h"
+#include "plugins/SessionManager.h"
+#include <drogon/HttpAppFramework.h>
+#include <drogon/HttpResponse.h>
+
+void SessionFilter::doFilter(const HttpRequestPtr &req, FilterCallback &&fcb,
+                             FilterChainCallback &&fccb) {
+  const auto &token = req->getCookie("session_token");
+  common::SessionClaims claims;
+  bool verified = false;
+  {
+    common::PhaseTimer timer(*req, "auth");
+    verified = !token.empty() &&
+               app().getPlugin<SessionManager>()->verify(token, claims);
+  }
+  if (verified) {
+    req->attributes()->insert("session", std::move(claims));
+    fccb();
+    return;
+  }
+
+  Json::Value response;
+  response["error"] = "未登录";
+  auto resp = HttpResponse::newHttpJsonResponse(response);
+  resp->setStatusCode(k401Unauthorized);
+  fcb(resp);
+}
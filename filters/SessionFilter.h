@@ -0,0 +1,15 @@
+#pragma once
+
+#include <drogon/HttpFilter.h>
+
+using namespace drogon;
+
+// 校验 session_token Cookie 中的会话令牌。
+// 通过后把会话信息写入请求属性，处理函数用 common::currentSession 读取；
+// 未登录、令牌无效、过期或已撤销时直接返回 401。
+class SessionFilter : public drogon::HttpFilter<SessionFilter> {
+public:
+  SessionFilter() = default;
+  void doFilter(const HttpRequestPtr &req, FilterCallback &&fcb,
+                FilterChainCallback &&fccb) override;
+};
@@ -1,7 +1,11 @@
+#include "plugins/StartupWarmup.h"
 #include <drogon/drogon.h>
 #include <json/value.h>
 
 int main() {
+    // 冷启动计时起点，预热完成时输出耗时
+    StartupWarmup::markProcessStart();
+
     // 加载配置文件
     drogon::app().loadConfigFile("../config.json");
 
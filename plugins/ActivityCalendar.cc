@@ -0,0 +1,260 @@
+#include "ActivityCalendar.h"
+#include "common/JsonStream.h"
+#include "dao/Db.h"
+#include <drogon/HttpAppFramework.h>
+#include <drogon/orm/Exception.h>
+#include <algorithm>
+#include <charconv>
+#include <mutex>
+#include <tuple>
+#include <utility>
+
+namespace {
+
+bool parseNumber(std::string_view text, int &value) {
+  const char *last = text.data() + text.size();
+  auto [end, ec] = std::from_chars(text.data(), last, value);
+  return ec == std::errc() && end == last;
+}
+
+// 公历日期到 1970-01-01 起的天数（proleptic Gregorian）
+int daysFromCivil(int y, unsigned m, unsigned d) {
+  y -= m <= 2;
+  const int era = (y >= 0 ? y : y - 399) / 400;
+  const unsigned yoe = static_cast<unsigned>(y - era * 400);
+  const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + static_cast<int>(doe) - 719468;
+}
+
+// 桶内按时间排序，同一时间按 activity_id
+bool before(const CalendarDays::Entry &a, const CalendarDays::Entry &b) {
+  return std::tie(a.time, a.activityId) < std::tie(b.time, b.activityId);
+}
+
+// 由一行结果构造日历项；没有时间或时间格式不对时返回 false
+bool makeEntry(const drogon::orm::Row &row, CalendarDays::Entry &entry) {
+  if (row["activity_time"].isNull()) {
+    return false;
+  }
+  entry.time = row["activity_time"].as<std::string>();
+  if (!ActivityCalendar::dayNumber(entry.time)) {
+    return false;
+  }
+  entry.activityId = row["activity_id"].as<int>();
+  entry.clubId = row["club_id"].as<int>();
+
+  entry.json = "{\"activity_id\":" + std::to_string(entry.activityId);
+  entry.json += ",\"club_id\":" + std::to_string(entry.clubId);
+  entry.json += ",\"activity_title\":";
+  common::appendJsonString(entry.json, row["activity_title"].as<std::string>());
+  entry.json += ",\"activity_time\":";
+  common::appendJsonString(entry.json, entry.time);
+  entry.json += ",\"activity_location\":";
+  common::appendJsonString(entry.json,
+                           row["activity_location"].as<std::string>());
+  entry.json += '}';
+  return true;
+}
+
+// 加载失败后的重试间隔上限，秒
+constexpr double kMaxRetryDelay = 60.0;
+
+} // namespace
+
+std::optional<int> ActivityCalendar::dayNumber(std::string_view time) {
+  int year = 0;
+  int month = 0;
+  int day = 0;
+  if (time.size() < 10 || time[4] != '-' || time[7] != '-' ||
+      !parseNumber(time.substr(0, 4), year) ||
+      !parseNumber(time.substr(5, 2), month) ||
+      !parseNumber(time.substr(8, 2), day) || month < 1 || month > 12 ||
+      day < 1 || day > 31) {
+    return std::nullopt;
+  }
+  return daysFromCivil(year, static_cast<unsigned>(month),
+                       static_cast<unsigned>(day));
+}
+
+CalendarDays::CalendarDays(std::vector<Entry> entries) {
+  for (auto &entry : entries) {
+    int day = *ActivityCalendar::dayNumber(entry.time);
+    dayOf_.emplace(entry.activityId, day);
+    days_[day].push_back(std::move(entry));
+  }
+  for (auto &[day, bucket] : days_) {
+    std::sort(bucket.begin(), bucket.end(), before);
+  }
+}
+
+void CalendarDays::place(Entry entry) {
+  int day = *ActivityCalendar::dayNumber(entry.time);
+  auto &entries = days_[day];
+  auto at = std::upper_bound(entries.begin(), entries.end(), entry, before);
+  dayOf_[entry.activityId] = day;
+  entries.insert(at, std::move(entry));
+}
+
+void CalendarDays::erase(int activityId) {
+  auto it = dayOf_.find(activityId);
+  if (it == dayOf_.end()) {
+    return;
+  }
+  auto bucket = days_.find(it->second);
+  if (bucket != days_.end()) {
+    std::erase_if(bucket->second, [activityId](const Entry &entry) {
+      return entry.activityId == activityId;
+    });
+    if (bucket->second.empty()) {
+      days_.erase(bucket);
+    }
+  }
+  dayOf_.erase(it);
+}
+
+size_t CalendarDays::write(const std::string &from, const std::string &to,
+                           const std::vector<int> &clubIds, size_t limit,
+                           std::string &out, bool &more) const {
+  more = false;
+  auto firstDay = ActivityCalendar::dayNumber(from);
+  auto lastDay = ActivityCalendar::dayNumber(to);
+  if (!firstDay || !lastDay) {
+    return 0;
+  }
+
+  size_t count = 0;
+  for (auto bucket = days_.lower_bound(*firstDay);
+       bucket != days_.end() && bucket->first <= *lastDay; ++bucket) {
+    for (const auto &entry : bucket->second) {
+      if (entry.time < from) {
+        continue;
+      }
+      if (entry.time >= to) {
+        return count;
+      }
+      if (!clubIds.empty() &&
+          !std::binary_search(clubIds.begin(), clubIds.end(), entry.clubId)) {
+        continue;
+      }
+      if (count == limit) {
+        more = true;
+        return count;
+      }
+      if (count > 0) {
+        out += ',';
+      }
+      out += entry.json;
+      ++count;
+    }
+  }
+  return count;
+}
+
+void ActivityCalendar::initAndStart(const Json::Value &config) {
+  // 立即发起加载，连接未就绪时查询在客户端排队；加载完成前接口返回 503。
+  // 所依赖的计量插件在 config.json 中声明，先于本插件初始化
+  drogon::async_run([this]() -> drogon::Task<> { co_await load(); });
+}
+
+void ActivityCalendar::shutdown() {
+  drogon::app().getLoop()->invalidateTimer(retryTimer_);
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  days_ = CalendarDays();
+}
+
+bool ActivityCalendar::ready() const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return loaded_;
+}
+
+drogon::Task<> ActivityCalendar::load() {
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    loading_ = true;
+  }
+
+  std::vector<CalendarDays::Entry> entries;
+  bool ok = true;
+  try {
+    auto result = co_await dao::exec(dao::sql::kActivityCalendar);
+    entries.reserve(result.size());
+    for (const auto &row : result) {
+      CalendarDays::Entry entry;
+      if (makeEntry(row, entry)) {
+        entries.push_back(std::move(entry));
+      }
+    }
+  } catch (const drogon::orm::DrogonDbException &e) {
+    LOG_ERROR << "活动日历加载失败: " << e.base().what();
+    ok = false;
+  }
+
+  std::vector<int> touched;
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    loading_ = false;
+    if (ok) {
+      days_ = CalendarDays(std::move(entries));
+      loaded_ = true;
+    }
+    touched.swap(touchedWhileLoading_);
+  }
+  if (!ok) {
+    // 加载期间的写入会由下一次完整加载覆盖
+    scheduleRetry();
+    co_return;
+  }
+
+  // 加载查询可能早于这些写入，逐个重新读取
+  for (int activityId : touched) {
+    co_await upsert(activityId);
+  }
+}
+
+void ActivityCalendar::scheduleRetry() {
+  double delay = retryDelay_;
+  retryDelay_ = std::min(retryDelay_ * 2, kMaxRetryDelay);
+  LOG_WARN << "活动日历将在 " << delay << " 秒后重新加载";
+  retryTimer_ = drogon::app().getLoop()->runAfter(delay, [this]() {
+    drogon::async_run([this]() -> drogon::Task<> { co_await load(); });
+  });
+}
+
+drogon::Task<> ActivityCalendar::upsert(int activityId,
+                                        common::RequestTiming *timing) {
+  std::optional<drogon::orm::Result> result;
+  try {
+    result = co_await dao::exec(timing, dao::sql::kActivityCalendarById,
+                                activityId);
+  } catch (const drogon::orm::DrogonDbException &e) {
+    LOG_ERROR << "活动日历更新失败，活动 " << activityId << ": "
+              << e.base().what();
+    co_return;
+  }
+
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  if (loading_) {
+    touchedWhileLoading_.push_back(activityId);
+  }
+  days_.erase(activityId);
+  CalendarDays::Entry entry;
+  if (!result->empty() && makeEntry((*result)[0], entry)) {
+    days_.place(std::move(entry));
+  }
+}
+
+void ActivityCalendar::remove(int activityId) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  if (loading_) {
+    touchedWhileLoading_.push_back(activityId);
+  }
+  days_.erase(activityId);
+}
+
+size_t ActivityCalendar::write(const std::string &from, const std::string &to,
+                               const std::vector<int> &clubIds, size_t limit,
+                               std::string &out, bool &more) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return days_.write(from, to, clubIds, limit, out, more);
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "common/RequestTiming.h"
+#include <drogon/plugins/Plugin.h>
+#include <drogon/utils/coroutine.h>
+#include <trantor/net/EventLoop.h>
+#include <map>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// 按天分桶的活动日历。
+// 启动时加载全部有时间的活动，按 activity_time 的日期放进桶里，
+// 桶内按时间升序；之后由 createActivity / updateActivity / deleteActivity
+// 逐条维护。范围查询只遍历涉及的几天，不访问数据库。
+// 时间一律是数据库中的本地时间字符串 "YYYY-MM-DD HH:MM:SS"，
+// 同一格式下字符串序即时间序。
+// 首次加载失败时按 1、2、4 … 60 秒的间隔退避重试，直到成功；此前接口返回 503。
+
+// 日历的桶本身，不加锁，由 ActivityCalendar 在读写锁下使用
+class CalendarDays {
+public:
+  struct Entry {
+    std::string time;
+    int activityId;
+    int clubId;
+    std::string json; // 预先序列化好的列表项
+  };
+
+  CalendarDays() = default;
+  // 一次放入全部活动，逐桶排序；time 须能被 dayNumber 解析
+  explicit CalendarDays(std::vector<Entry> entries);
+
+  // 放到对应桶中的有序位置；已在日历中的活动须先 erase
+  void place(Entry entry);
+  void erase(int activityId);
+
+  // 见 ActivityCalendar::write
+  size_t write(const std::string &from, const std::string &to,
+               const std::vector<int> &clubIds, size_t limit,
+               std::string &out, bool &more) const;
+
+private:
+  std::map<int, std::vector<Entry>> days_; // 天数 → 当天的活动
+  std::unordered_map<int, int> dayOf_;     // activity_id → 天数
+};
+
+class ActivityCalendar : public drogon::Plugin<ActivityCalendar> {
+public:
+  ActivityCalendar() = default;
+  void initAndStart(const Json::Value &config) override;
+  void shutdown() override;
+
+  // 首次加载是否完成
+  bool ready() const;
+
+  // 重新读取一个活动并放到对应的桶；活动不存在或没有时间时移出日历。
+  // 读取失败只记录日志，不影响调用方已完成的写入；读取耗时记入 timing
+  drogon::Task<> upsert(int activityId,
+                        common::RequestTiming *timing = nullptr);
+  void remove(int activityId);
+
+  // 把 [from, to) 内的活动按时间升序追加到 out（逗号分隔的 JSON 对象），
+  // 最多 limit 条；clubIds 为空时不限社团。返回追加的条数，
+  // 范围内还有更多时 more 置为 true
+  size_t write(const std::string &from, const std::string &to,
+               const std::vector<int> &clubIds, size_t limit,
+               std::string &out, bool &more) const;
+
+  // "YYYY-MM-DD..." 的日期部分换算为自 1970-01-01 起的天数；格式错误返回空
+  static std::optional<int> dayNumber(std::string_view time);
+
+private:
+  drogon::Task<> load();
+  // 加载失败后在事件循环上安排下一次 load()
+  void scheduleRetry();
+
+  mutable std::shared_mutex mutex_;
+  CalendarDays days_;
+  bool loaded_ = false;
+  bool loading_ = false;
+  // 加载期间发生变化的活动，加载结果发布后重新读取
+  std::vector<int> touchedWhileLoading_;
+
+  double retryDelay_ = 1.0; // 下一次重试前等待的秒数，只在 load 链上读写
+  trantor::TimerId retryTimer_{0};
+};
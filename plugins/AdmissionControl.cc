@@ -0,0 +1,120 @@
+#include "AdmissionControl.h"
+#include "common/JsonStream.h"
+#include <drogon/HttpAppFramework.h>
+#include <drogon/HttpResponse.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+using namespace drogon;
+
+namespace {
+constexpr double kAlpha = 0.2; // 滑动平均中新样本的权重
+// 超过预算的倍数达到该值时，普通请求也开始降级
+constexpr double kNormalShedFactor = 2.0;
+} // namespace
+
+AdmissionControl::QueryProbe::QueryProbe(AdmissionControl *owner)
+    : owner_(owner), start_(std::chrono::steady_clock::now()),
+      contended_(owner->inflight_.fetch_add(1, std::memory_order_relaxed) >=
+                 owner->connections_) {}
+
+AdmissionControl::QueryProbe::QueryProbe(QueryProbe &&other) noexcept
+    : owner_(other.owner_), start_(other.start_), contended_(other.contended_) {
+  other.owner_ = nullptr;
+}
+
+AdmissionControl::QueryProbe::~QueryProbe() { finish(); }
+
+AdmissionControl::Timing AdmissionControl::QueryProbe::finish() {
+  if (owner_ == nullptr) {
+    return {0.0, 0.0};
+  }
+  double elapsedMs = std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - start_)
+                         .count();
+  owner_->inflight_.fetch_sub(1, std::memory_order_relaxed);
+  double waitMs = owner_->finished(elapsedMs, contended_);
+  owner_ = nullptr;
+  return {elapsedMs, waitMs};
+}
+
+void AdmissionControl::initAndStart(const Json::Value &config) {
+  budgetMs_ = config.get("latency_budget_ms", 200.0).asDouble();
+  connections_ = std::max(1, config.get("connections", 1).asInt());
+  for (const auto &path : config["high_priority"]) {
+    highPriority_.insert(path.asString());
+  }
+  for (const auto &prefix : config["sheddable"]) {
+    sheddable_.push_back(prefix.asString());
+  }
+
+  app().registerSyncAdvice([this](const HttpRequestPtr &req) -> HttpResponsePtr {
+    auto priority = classify(req);
+    if (priority == Priority::High) {
+      return nullptr;
+    }
+    double waitMs = estimatedWaitMs();
+    double limit = priority == Priority::Sheddable
+                       ? budgetMs_
+                       : budgetMs_ * kNormalShedFactor;
+    if (waitMs <= limit) {
+      return nullptr;
+    }
+
+    Json::Value response;
+    response["error"] = "服务繁忙，请稍后重试";
+    auto resp = HttpResponse::newHttpJsonResponse(response);
+    resp->setStatusCode(k503ServiceUnavailable);
+    // 按预计等待给出重试间隔，至少 1 秒
+    auto retryAfter = std::max(1.0, std::ceil(waitMs / 1000.0));
+    resp->addHeader("Retry-After",
+                    std::to_string(static_cast<int>(retryAfter)));
+    return resp;
+  });
+}
+
+void AdmissionControl::shutdown() {}
+
+AdmissionControl::Priority
+AdmissionControl::classify(const HttpRequestPtr &req) const {
+  const auto &path = req->path();
+  if (highPriority_.count(path) > 0) {
+    return Priority::High;
+  }
+  if (common::wantsStream(req)) {
+    return Priority::Sheddable;
+  }
+  for (const auto &prefix : sheddable_) {
+    if (path.compare(0, prefix.size(), prefix) == 0) {
+      return Priority::Sheddable;
+    }
+  }
+  return Priority::Normal;
+}
+
+double AdmissionControl::estimatedWaitMs() const {
+  int inflight = inflight_.load(std::memory_order_relaxed);
+  double queued = static_cast<double>(inflight) *
+                  serviceMs_.load(std::memory_order_relaxed) / connections_;
+  // 连接池未占满时没有排队，历史等待不再计入
+  double observed =
+      inflight >= connections_ ? waitMs_.load(std::memory_order_relaxed) : 0.0;
+  return std::max(queued, observed);
+}
+
+double AdmissionControl::finished(double elapsedMs, bool contended) {
+  std::lock_guard<std::mutex> lock(statsMutex_);
+  double service = serviceMs_.load(std::memory_order_relaxed);
+  if (!contended) {
+    serviceMs_.store(service == 0.0 ? elapsedMs
+                                    : service + kAlpha * (elapsedMs - service),
+                     std::memory_order_relaxed);
+    return 0.0;
+  }
+  double wait = std::max(0.0, elapsedMs - service);
+  double average = waitMs_.load(std::memory_order_relaxed);
+  waitMs_.store(average + kAlpha * (wait - average),
+                std::memory_order_relaxed);
+  return wait;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <drogon/HttpRequest.h>
+#include <drogon/plugins/Plugin.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// 准入控制与降级。
+// dao::exec 在每条查询前后调用 probe()，统计：
+//   - 查询耗时：连接池有空闲连接时发出的查询，耗时即服务时间；
+//   - 排队等待：连接池占满后发出的查询，耗时减去服务时间即等待时间。
+// 两者取指数滑动平均。新请求预计要等待的时间取
+// max(在途查询数 × 服务时间 / 连接数, 连接池占满时的平均等待)。
+// 预计等待超过 latency_budget_ms 时，列表、导出类请求直接返回 503；
+// 超过两倍时普通请求也返回 503；签到、登录等高优先级请求始终放行。
+// 拒绝在路由之前完成，不占用数据库。
+//
+// 配置：
+//   "latency_budget_ms": 毫秒，默认 200
+//   "connections":       所有 db_clients 的连接数之和，默认 1
+//   "high_priority":     始终放行的路径（精确匹配）
+//   "sheddable":         可降级的路径前缀；带 stream=1 的导出请求同样可降级
+class AdmissionControl : public drogon::Plugin<AdmissionControl> {
+public:
+  enum class Priority { High, Normal, Sheddable };
+
+  struct Timing {
+    double elapsedMs; // 从发出到返回
+    double waitMs;    // 其中估计的排队等待，连接池未占满时为 0
+  };
+
+  // 一条查询的计时，finish() 或析构时计入统计
+  class QueryProbe {
+  public:
+    explicit QueryProbe(AdmissionControl *owner);
+    QueryProbe(QueryProbe &&other) noexcept;
+    QueryProbe(const QueryProbe &) = delete;
+    QueryProbe &operator=(const QueryProbe &) = delete;
+    QueryProbe &operator=(QueryProbe &&) = delete;
+    ~QueryProbe();
+
+    // 结束计时，只有第一次调用生效
+    Timing finish();
+
+  private:
+    AdmissionControl *owner_;
+    std::chrono::steady_clock::time_point start_;
+    bool contended_; // 发出时连接池已占满
+  };
+
+  AdmissionControl() = default;
+  void initAndStart(const Json::Value &config) override;
+  void shutdown() override;
+
+  QueryProbe probe() { return QueryProbe(this); }
+
+  Priority classify(const drogon::HttpRequestPtr &req) const;
+
+  // 新请求预计的数据库排队等待，毫秒
+  double estimatedWaitMs() const;
+
+private:
+  // 计入统计，返回估计的排队等待
+  double finished(double elapsedMs, bool contended);
+
+  double budgetMs_ = 200.0;
+  int connections_ = 1;
+  std::unordered_set<std::string> highPriority_;
+  std::vector<std::string> sheddable_;
+
+  std::atomic<int> inflight_{0};
+  std::mutex statsMutex_;
+  std::atomic<double> serviceMs_{0.0}; // 服务时间的滑动平均
+  std::atomic<double> waitMs_{0.0};    // 排队等待的滑动平均
+};
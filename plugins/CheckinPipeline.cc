@@ -0,0 +1,270 @@
+#include "CheckinPipeline.h"
+#include "dao/Db.h"
+#include "plugins/AdmissionControl.h"
+#include "plugins/QueryMetrics.h"
+#include <drogon/HttpAppFramework.h>
+#include <drogon/orm/DbClient.h>
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace {
+
+// 批量写入直接用 SqlBinder 而不经过 dao::exec，由它在回调中记录指标；
+// 成功与失败回调共享同一个计时
+class InsertTimer {
+public:
+  explicit InsertTimer(const dao::Statement &stmt)
+      : stmt_(stmt),
+        probe_(drogon::app().getPlugin<AdmissionControl>()->probe()) {}
+
+  void succeeded(size_t rows) {
+    auto timing = probe_.finish();
+    drogon::app().getPlugin<QueryMetrics>()->record(stmt_, timing.elapsedMs,
+                                                    timing.waitMs, rows);
+  }
+
+  void failed() {
+    auto timing = probe_.finish();
+    drogon::app().getPlugin<QueryMetrics>()->recordError(
+        stmt_, timing.elapsedMs, timing.waitMs);
+  }
+
+private:
+  const dao::Statement &stmt_;
+  AdmissionControl::QueryProbe probe_;
+};
+
+} // namespace
+
+bool CheckinRoster::loaded(int activityId) const {
+  auto it = activities_.find(activityId);
+  return it != activities_.end() && it->second.loaded;
+}
+
+void CheckinRoster::load(int activityId, const std::vector<int> &registered,
+                         const std::vector<int> &checkedIn) {
+  auto &state = activities_[activityId];
+  state.registered.insert(registered.begin(), registered.end());
+  state.checkedIn.insert(checkedIn.begin(), checkedIn.end());
+  state.loaded = true;
+}
+
+bool CheckinRoster::registered(int activityId, int userId) const {
+  auto it = activities_.find(activityId);
+  return it != activities_.end() && it->second.registered.count(userId) > 0;
+}
+
+void CheckinRoster::addRegistered(int activityId, int userId) {
+  activities_[activityId].registered.insert(userId);
+}
+
+bool CheckinRoster::reserve(int activityId, int userId) {
+  return activities_[activityId].checkedIn.insert(userId).second;
+}
+
+void CheckinRoster::release(int activityId, int userId) {
+  auto it = activities_.find(activityId);
+  if (it != activities_.end()) {
+    it->second.checkedIn.erase(userId);
+  }
+}
+
+void CheckinRoster::forget(int activityId) { activities_.erase(activityId); }
+
+void CheckinRoster::clear() { activities_.clear(); }
+
+void CheckinPipeline::initAndStart(const Json::Value &config) {
+  batchSize_ = config.get("batch_size", 64).asUInt64();
+  if (batchSize_ == 0) {
+    batchSize_ = 1;
+  }
+  flushInterval_ = config.get("flush_interval", 0.02).asDouble();
+  loop_ = drogon::app().getLoop();
+}
+
+void CheckinPipeline::shutdown() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  roster_.clear();
+}
+
+drogon::Task<CheckinPipeline::Result>
+CheckinPipeline::checkin(int activityId, int userId,
+                         common::RequestTiming *timing) {
+  bool loaded = false;
+  bool registered = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    loaded = roster_.loaded(activityId);
+    registered = roster_.registered(activityId, userId);
+  }
+  if (!loaded) {
+    co_await load(activityId, timing);
+    std::lock_guard<std::mutex> lock(mutex_);
+    registered = roster_.registered(activityId, userId);
+  }
+
+  // 集合里没有的用户可能是加载之后才报名的，回到数据库确认
+  if (!registered) {
+    auto result = co_await dao::exec(timing, dao::sql::kRegistrationCount,
+                                     userId, activityId);
+    if (result[0]["count"].as<int>() == 0) {
+      co_return Result::NotRegistered;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    roster_.addRegistered(activityId, userId);
+  }
+
+  // 先占位再写入，并发的重复扫码在这里被拦下
+  bool reserved = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    reserved = roster_.reserve(activityId, userId);
+  }
+  if (!reserved) {
+    co_return Result::Duplicate;
+  }
+
+  // 等待所在批次写完，成功与否这段时间都记作一次 db.<批量写入语句名>
+  auto queuedAt = std::chrono::steady_clock::now();
+  auto recordWait = [timing, queuedAt]() {
+    dao::detail::recordPhase(timing, dao::sql::kCheckinInsertBatch,
+                             std::chrono::duration<double, std::milli>(
+                                 std::chrono::steady_clock::now() - queuedAt)
+                                 .count());
+  };
+  try {
+    co_await InsertAwaiter{this, activityId, userId, nullptr};
+  } catch (...) {
+    recordWait();
+    throw;
+  }
+  recordWait();
+  co_return Result::Accepted;
+}
+
+drogon::Task<> CheckinPipeline::load(int activityId,
+                                     common::RequestTiming *timing) {
+  auto registrations = co_await dao::exec(
+      timing, dao::sql::kRegistrationUsersByActivity, activityId);
+  // 没有人报名（或活动不存在）时不建立状态，避免为任意 activity_id 占用内存
+  if (registrations.empty()) {
+    co_return;
+  }
+  auto checkins = co_await dao::exec(
+      timing, dao::sql::kCheckinUsersByActivity, activityId);
+
+  std::vector<int> registered;
+  registered.reserve(registrations.size());
+  for (const auto &row : registrations) {
+    registered.push_back(row["user_id"].as<int>());
+  }
+  std::vector<int> checkedIn;
+  checkedIn.reserve(checkins.size());
+  for (const auto &row : checkins) {
+    checkedIn.push_back(row["user_id"].as<int>());
+  }
+
+  // 与加载期间已占位的签到合并，不覆盖
+  std::lock_guard<std::mutex> lock(mutex_);
+  roster_.load(activityId, registered, checkedIn);
+}
+
+void CheckinPipeline::forgetActivity(int activityId) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  roster_.forget(activityId);
+}
+
+void CheckinPipeline::InsertAwaiter::await_suspend(
+    std::coroutine_handle<> handle) {
+  // 挂起之后才入队，批量写入的回调可以在任意线程上安全地恢复协程
+  pipeline->enqueue(Pending{activityId, userId, handle, &error});
+}
+
+void CheckinPipeline::enqueue(Pending pending) {
+  queue_.enqueue(std::move(pending));
+  auto before = queued_.fetch_add(1, std::memory_order_acq_rel);
+  if (before == 0) {
+    loop_->runAfter(flushInterval_, [this]() { flush(); });
+  } else if (before + 1 == static_cast<int64_t>(batchSize_)) {
+    loop_->queueInLoop([this]() { flush(); });
+  }
+}
+
+// 只在 loop_ 上运行，是队列唯一的消费者
+void CheckinPipeline::flush() {
+  auto batch = std::make_shared<std::vector<Pending>>();
+  Pending pending;
+  while (queue_.dequeue(pending)) {
+    queued_.fetch_sub(1, std::memory_order_acq_rel);
+    batch->push_back(pending);
+    if (batch->size() == batchSize_) {
+      insertBatch(std::move(batch));
+      batch = std::make_shared<std::vector<Pending>>();
+    }
+  }
+  if (!batch->empty()) {
+    insertBatch(std::move(batch));
+  }
+}
+
+void CheckinPipeline::insertBatch(std::shared_ptr<std::vector<Pending>> batch) {
+  std::string sql = dao::sql::kCheckinInsertBatch.sql;
+  for (size_t i = 0; i < batch->size(); ++i) {
+    if (i > 0) {
+      sql += ',';
+    }
+    sql += dao::sql::kCheckinInsertBatchRow;
+  }
+
+  auto timer = std::make_shared<InsertTimer>(dao::sql::kCheckinInsertBatch);
+  auto binder = *drogon::app().getDbClient() << std::move(sql);
+  for (const auto &pending : *batch) {
+    binder << pending.userId << pending.activityId;
+  }
+  binder >> [batch, timer](const drogon::orm::Result &result) {
+    timer->succeeded(result.affectedRows());
+    for (const auto &pending : *batch) {
+      pending.waiter.resume();
+    }
+  };
+  binder >> [this, batch, timer](const std::exception_ptr &error) {
+    timer->failed();
+    if (batch->size() == 1) {
+      fail(batch->front(), error);
+      return;
+    }
+    // 整批回滚；逐条重写，只让真正出错的那几条失败
+    LOG_WARN << "批量签到写入失败，改为逐条写入，共 " << batch->size() << " 条";
+    for (const auto &pending : *batch) {
+      insertOne(pending);
+    }
+  };
+  binder.exec();
+}
+
+void CheckinPipeline::insertOne(const Pending &pending) {
+  auto timer = std::make_shared<InsertTimer>(dao::sql::kCheckinInsert);
+  auto binder = *drogon::app().getDbClient()
+                << std::string(dao::sql::kCheckinInsert.sql);
+  binder << pending.userId << pending.activityId;
+  binder >> [pending, timer](const drogon::orm::Result &result) {
+    timer->succeeded(result.affectedRows());
+    pending.waiter.resume();
+  };
+  binder >> [this, pending, timer](const std::exception_ptr &error) {
+    timer->failed();
+    fail(pending, error);
+  };
+  binder.exec();
+}
+
+void CheckinPipeline::fail(const Pending &pending,
+                           const std::exception_ptr &error) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    roster_.release(pending.activityId, pending.userId);
+  }
+  *pending.error = error;
+  pending.waiter.resume();
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "common/RequestTiming.h"
+#include <drogon/plugins/Plugin.h>
+#include <drogon/utils/coroutine.h>
+#include <trantor/net/EventLoop.h>
+#include <trantor/utils/LockFreeQueue.h>
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// 各活动的报名、签到集合本身，不加锁，由 CheckinPipeline 在互斥锁下使用
+class CheckinRoster {
+public:
+  // 活动的集合是否已从数据库加载
+  bool loaded(int activityId) const;
+  // 并入加载结果并标记为已加载；加载期间已占位的签到保留
+  void load(int activityId, const std::vector<int> &registered,
+            const std::vector<int> &checkedIn);
+
+  bool registered(int activityId, int userId) const;
+  // 加载之后才报名、经数据库确认的用户
+  void addRegistered(int activityId, int userId);
+
+  // 签到占位：用户尚未签到时记为已签到并返回 true，重复签到返回 false
+  bool reserve(int activityId, int userId);
+  // 写入失败时撤销占位，用户可以重新签到
+  void release(int activityId, int userId);
+
+  void forget(int activityId);
+  void clear();
+
+private:
+  struct ActivityState {
+    bool loaded = false;
+    std::unordered_set<int> checkedIn;
+    // 有过报名记录的用户，不论报名状态，与签到接口一直以来的校验一致；
+    // 报名记录不会删除，集合只增不减，不会因状态变化而过期
+    std::unordered_set<int> registered;
+  };
+
+  std::unordered_map<int, ActivityState> activities_;
+};
+
+// 签到写入管道。
+// 每个活动在内存中保存已签到用户与已报名用户两个集合，首次签到时从数据库加载；
+// 查重只是一次内存查找，重复扫码不访问数据库。
+// 通过查重的签到放入无锁队列，由主事件循环按条数或定时批量写入
+// activity_checkin（一条多行 INSERT），写入完成后签到协程才恢复，
+// 客户端拿到的“签到成功”对应已提交的记录。
+// activity_checkin 只经由本管道写入；多实例部署时查重集合不共享。
+// 配置：
+//   batch_size      每批最多写入的条数，默认 64
+//   flush_interval  队列未满时的最长等待秒数，默认 0.02
+class CheckinPipeline : public drogon::Plugin<CheckinPipeline> {
+public:
+  enum class Result {
+    Accepted,      // 已写入
+    Duplicate,     // 已签到过
+    NotRegistered, // 未报名该活动
+  };
+
+  CheckinPipeline() = default;
+  void initAndStart(const Json::Value &config) override;
+  void shutdown() override;
+
+  // 签到；数据库异常向调用方抛出，此时签到未记录，可以重试。
+  // 查询与等待批量写入的耗时记入 timing（可以为空）的 db 阶段
+  drogon::Task<Result> checkin(int activityId, int userId,
+                               common::RequestTiming *timing = nullptr);
+
+  // 活动删除后丢弃其内存状态
+  void forgetActivity(int activityId);
+
+private:
+  // 排队等待批量写入的签到，写入完成后恢复 waiter
+  struct Pending {
+    int activityId;
+    int userId;
+    std::coroutine_handle<> waiter;
+    std::exception_ptr *error;
+  };
+
+  struct InsertAwaiter {
+    CheckinPipeline *pipeline;
+    int activityId;
+    int userId;
+    std::exception_ptr error;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle);
+    void await_resume() const {
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    }
+  };
+
+  drogon::Task<> load(int activityId, common::RequestTiming *timing);
+  void enqueue(Pending pending);
+  void flush();
+  void insertBatch(std::shared_ptr<std::vector<Pending>> batch);
+  void insertOne(const Pending &pending);
+  // 写入失败：撤销查重记录，把异常交给等待的协程
+  void fail(const Pending &pending, const std::exception_ptr &error);
+
+  size_t batchSize_ = 64;
+  double flushInterval_ = 0.02;
+  trantor::EventLoop *loop_ = nullptr;
+
+  trantor::MpscQueue<Pending> queue_;
+  // 已入队未写入的条数：从 0 变 1 时定时刷新，达到 batch_size 时立即刷新
+  std::atomic<int64_t> queued_{0};
+
+  std::mutex mutex_;
+  CheckinRoster roster_;
+};
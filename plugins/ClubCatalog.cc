@@ -0,0 +1,103 @@
+#include "ClubCatalog.h"
+#include "common/RowJson.h"
+#include "dao/Db.h"
+#include <drogon/HttpAppFramework.h>
+#include <drogon/orm/Exception.h>
+#include <algorithm>
+
+namespace {
+// 加载失败后的重试间隔，秒
+constexpr double kMinRetryDelay = 1.0;
+constexpr double kMaxRetryDelay = 60.0;
+} // namespace
+
+const ClubEntry *ClubSnapshot::find(int clubId) const {
+  auto it = after(clubId - 1);
+  if (it == clubs.end() || it->club_id != clubId) {
+    return nullptr;
+  }
+  return &*it;
+}
+
+std::vector<ClubEntry>::const_iterator ClubSnapshot::after(int afterId) const {
+  return std::upper_bound(
+      clubs.begin(), clubs.end(), afterId,
+      [](int id, const ClubEntry &entry) { return id < entry.club_id; });
+}
+
+void ClubCatalog::initAndStart(const Json::Value &config) {
+  // 立即发起加载，连接未就绪时查询在客户端排队；加载完成前读者回退到查库。
+  // 查询经 dao::exec 计量，config.json 中须依赖 AdmissionControl、
+  // QueryMetrics、SlowQueryLog 与 DbRouter，保证它们先完成初始化
+  drogon::async_run([this]() -> drogon::Task<> { co_await rebuild(); });
+}
+
+void ClubCatalog::shutdown() {
+  {
+    std::lock_guard<std::mutex> lock(publishMutex_);
+    drogon::app().getLoop()->invalidateTimer(retryTimer_);
+  }
+  snapshot_.store(nullptr, std::memory_order_release);
+}
+
+drogon::Task<> ClubCatalog::rebuild(common::RequestTiming *timing) {
+  auto generation = ++nextGeneration_;
+  std::shared_ptr<ClubSnapshot> next;
+  try {
+    auto result = co_await dao::exec(timing, dao::sql::kClubCatalog);
+    next = std::make_shared<ClubSnapshot>();
+    next->clubs.reserve(result.size());
+    common::RowSerializer<common::ClubRow> writeListItem(result);
+    common::RowSerializer<common::ClubDetailRow> writeDetail(result);
+    for (const auto &row : result) {
+      ClubEntry entry{row["club_id"].as<int>(),
+                      row["club_name"].as<std::string>(),
+                      row["club_introduction"].as<std::string>(),
+                      row["contact_info"].as<std::string>(),
+                      row["activity_venue"].as<std::string>(),
+                      row["founder_id"].as<int>()};
+      writeListItem(row, entry.listJson);
+      writeDetail(row, entry.detailJson);
+      next->clubs.push_back(std::move(entry));
+    }
+  } catch (const drogon::orm::DrogonDbException &e) {
+    LOG_ERROR << "社团目录加载失败: " << e.base().what();
+  }
+
+  std::lock_guard<std::mutex> lock(publishMutex_);
+  // 失败时读者继续使用当前快照，重试成功后补上这次写入
+  if (!next) {
+    failedGeneration_ = std::max(failedGeneration_, generation);
+    stale_.store(true, std::memory_order_release);
+    scheduleRetry();
+    co_return;
+  }
+  retryDelay_ = kMinRetryDelay;
+  // 查询开始得更早的重建不能覆盖更新的快照
+  if (generation > publishedGeneration_) {
+    publishedGeneration_ = generation;
+    snapshot_.store(std::move(next), std::memory_order_release);
+  }
+  // 比失败那次更晚开始的重建成功后，快照才包含那次写入
+  if (generation > failedGeneration_) {
+    stale_.store(false, std::memory_order_release);
+  }
+}
+
+void ClubCatalog::scheduleRetry() {
+  // 已有待执行的重试时不再叠加
+  if (retryPending_) {
+    return;
+  }
+  retryPending_ = true;
+  double delay = retryDelay_;
+  retryDelay_ = std::min(retryDelay_ * 2, kMaxRetryDelay);
+  LOG_WARN << "社团目录将在 " << delay << " 秒后重新加载";
+  retryTimer_ = drogon::app().getLoop()->runAfter(delay, [this]() {
+    {
+      std::lock_guard<std::mutex> lock(publishMutex_);
+      retryPending_ = false;
+    }
+    drogon::async_run([this]() -> drogon::Task<> { co_await rebuild(); });
+  });
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "common/RequestTiming.h"
+#include <drogon/plugins/Plugin.h>
+#include <drogon/utils/coroutine.h>
+#include <trantor/net/EventLoop.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 社团目录的内存快照。
+// club 表只会经由 ClubController::create 与 ClubApprovalController::approveClub
+// 写入，这两处写成功后调用 rebuild() 重新加载整张表并发布新快照。
+// 加载失败时保留当前快照，按 1、2、4 … 60 秒的间隔退避重试，直到成功。
+// 快照发布后不再修改，读者只做一次 atomic<shared_ptr> 加载，不访问数据库；
+// 旧快照在最后一个读者释放后自动回收。
+// libstdc++ 的 atomic<shared_ptr> 不是无锁的，加载与发布都要短暂持有
+// 一个内部自旋锁，只覆盖引用计数的增减，持锁时间与快照大小无关。
+
+struct ClubEntry {
+  int club_id;
+  std::string club_name;
+  std::string club_introduction;
+  std::string contact_info;
+  std::string activity_venue;
+  int founder_id;
+  // 发布前预先序列化好的 JSON，列表与详情接口直接拼接输出
+  std::string listJson;   // 列表项：club_id、club_name、club_introduction
+  std::string detailJson; // 详情：全部字段
+};
+
+struct ClubSnapshot {
+  std::vector<ClubEntry> clubs; // 按 club_id 升序
+
+  // 按 club_id 查找，不存在返回 nullptr
+  const ClubEntry *find(int clubId) const;
+  // 第一个 club_id > afterId 的位置
+  std::vector<ClubEntry>::const_iterator after(int afterId) const;
+};
+
+class ClubCatalog : public drogon::Plugin<ClubCatalog> {
+public:
+  ClubCatalog() = default;
+  void initAndStart(const Json::Value &config) override;
+  void shutdown() override;
+
+  // 当前快照；启动后首次加载完成前返回 nullptr，调用方应回退到查库
+  std::shared_ptr<const ClubSnapshot> snapshot() const {
+    return snapshot_.load(std::memory_order_acquire);
+  }
+
+  // 最近一次重建失败、尚未重试成功时为 true，
+  // 此时快照可能缺少刚写入的社团，按 id 查不到时应回退到查库
+  bool stale() const { return stale_.load(std::memory_order_acquire); }
+
+  // 重新加载 club 表并发布新快照，查询耗时记入 timing（可以为空）。
+  // 加载失败时当前快照不变，并安排一次重试
+  drogon::Task<> rebuild(common::RequestTiming *timing = nullptr);
+
+private:
+  // 持有 publishMutex_ 时调用
+  void scheduleRetry();
+
+  std::atomic<std::shared_ptr<const ClubSnapshot>> snapshot_;
+  // 并发重建时，只允许比已发布快照更晚开始的那次覆盖
+  std::atomic<uint64_t> nextGeneration_{0};
+  uint64_t publishedGeneration_{0};
+  uint64_t failedGeneration_{0};
+  std::atomic<bool> stale_{false};
+  std::mutex publishMutex_;
+
+  // 以下由 publishMutex_ 保护
+  double retryDelay_ = 1.0; // 下一次重试前等待的秒数
+  bool retryPending_ = false;
+  trantor::TimerId retryTimer_{0};
+};
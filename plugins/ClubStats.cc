@@ -0,0 +1,194 @@
+#include "ClubStats.h"
+#include "common/JsonStream.h"
+#include "dao/Db.h"
+#include <cstdio>
+
+namespace {
+
+void appendCount(std::string &out, std::string_view key, int64_t value) {
+  common::appendJsonKey(out, key);
+  out += std::to_string(value);
+}
+
+} // namespace
+
+void ClubStats::initAndStart(const Json::Value &config) {
+  ttl_ = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(config.get("ttl", 30.0).asDouble()));
+}
+
+void ClubStats::shutdown() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  activityClubs_.clear();
+  generations_.clear();
+}
+
+drogon::Task<std::shared_ptr<const std::string>>
+ClubStats::stats(int clubId, common::RequestTiming *timing) {
+  uint64_t generation = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(clubId);
+    if (it != entries_.end() && it->second.expires > Clock::now()) {
+      co_return it->second.json;
+    }
+    generation = generations_[clubId];
+  }
+
+  std::vector<int> activityIds;
+  auto json = std::make_shared<const std::string>(
+      co_await compute(clubId, activityIds, timing));
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (generations_[clubId] != generation) {
+    // 统计期间有写入，结果照常返回但不缓存
+    co_return json;
+  }
+  eraseLocked(clubId);
+  for (int activityId : activityIds) {
+    activityClubs_[activityId] = clubId;
+  }
+  entries_[clubId] =
+      Entry{json, Clock::now() + ttl_, std::move(activityIds)};
+  co_return json;
+}
+
+void ClubStats::invalidateClub(int clubId) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++generations_[clubId];
+  eraseLocked(clubId);
+}
+
+void ClubStats::invalidateActivity(int activityId) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = activityClubs_.find(activityId);
+  if (it == activityClubs_.end()) {
+    return;
+  }
+  int clubId = it->second;
+  ++generations_[clubId];
+  eraseLocked(clubId);
+}
+
+void ClubStats::eraseLocked(int clubId) {
+  auto it = entries_.find(clubId);
+  if (it == entries_.end()) {
+    return;
+  }
+  for (int activityId : it->second.activityIds) {
+    activityClubs_.erase(activityId);
+  }
+  entries_.erase(it);
+}
+
+drogon::Task<std::string> ClubStats::compute(int clubId,
+                                             std::vector<int> &activityIds,
+                                             common::RequestTiming *timing) {
+  auto funnel =
+      co_await dao::exec(timing, dao::sql::kRegistrationFunnelByClub, clubId);
+  auto checkins =
+      co_await dao::exec(timing, dao::sql::kCheckinCountsByClub, clubId);
+  auto growth =
+      co_await dao::exec(timing, dao::sql::kMemberGrowthByClub, clubId);
+
+  std::unordered_map<int, int64_t> checkedIn;
+  for (const auto &row : checkins) {
+    checkedIn.emplace(row["activity_id"].as<int>(),
+                      row["checked_in"].as<int64_t>());
+  }
+
+  int64_t pending = 0;
+  int64_t accepted = 0;
+  int64_t rejected = 0;
+  int64_t cancel = 0;
+  int64_t waitlist = 0;
+  int64_t paid = 0;
+  std::string activities;
+  activityIds.reserve(funnel.size());
+  for (const auto &row : funnel) {
+    int activityId = row["activity_id"].as<int>();
+    activityIds.push_back(activityId);
+    auto rowAccepted = row["accepted"].as<int64_t>();
+    pending += row["pending"].as<int64_t>();
+    accepted += rowAccepted;
+    rejected += row["rejected"].as<int64_t>();
+    cancel += row["cancel"].as<int64_t>();
+    waitlist += row["waitlist"].as<int64_t>();
+    paid += row["paid"].as<int64_t>();
+
+    auto found = checkedIn.find(activityId);
+    int64_t rowCheckedIn = found == checkedIn.end() ? 0 : found->second;
+
+    if (!activities.empty()) {
+      activities += ',';
+    }
+    activities += "{\"activity_id\":" + std::to_string(activityId);
+    activities += ",\"activity_title\":";
+    common::appendJsonString(activities,
+                             row["activity_title"].as<std::string>());
+    activities += ",\"activity_time\":";
+    if (row["activity_time"].isNull()) {
+      activities += "null";
+    } else {
+      common::appendJsonString(activities,
+                               row["activity_time"].as<std::string>());
+    }
+    activities += ',';
+    appendCount(activities, "accepted", rowAccepted);
+    activities += ',';
+    appendCount(activities, "checked_in", rowCheckedIn);
+    // 出勤率 = 签到人数 / 已通过报名数，没有已通过报名时为 null
+    activities += ",\"attendance_rate\":";
+    if (rowAccepted > 0) {
+      char rate[32];
+      std::snprintf(rate, sizeof(rate), "%.4f",
+                    static_cast<double>(rowCheckedIn) /
+                        static_cast<double>(rowAccepted));
+      activities += rate;
+    } else {
+      activities += "null";
+    }
+    activities += '}';
+  }
+
+  std::string out = "{\"club_id\":" + std::to_string(clubId);
+  out += ",\"registrations\":{";
+  appendCount(out, "pending", pending);
+  out += ',';
+  appendCount(out, "accepted", accepted);
+  out += ',';
+  appendCount(out, "rejected", rejected);
+  out += ',';
+  appendCount(out, "cancel", cancel);
+  out += ',';
+  appendCount(out, "waitlist", waitlist);
+  // 缴费只统计已通过的报名
+  out += "},\"payments\":{";
+  appendCount(out, "paid", paid);
+  out += ',';
+  appendCount(out, "unpaid", accepted - paid);
+  out += "},\"activities\":[";
+  out += activities;
+
+  // 按月入社人数及当月末的累计人数
+  out += "],\"member_growth\":[";
+  int64_t total = 0;
+  for (size_t i = 0; i < growth.size(); ++i) {
+    const auto &row = growth[i];
+    auto joined = row["joined"].as<int64_t>();
+    total += joined;
+    if (i > 0) {
+      out += ',';
+    }
+    out += "{\"month\":";
+    common::appendJsonString(out, row["month"].as<std::string>());
+    out += ',';
+    appendCount(out, "joined", joined);
+    out += ',';
+    appendCount(out, "total", total);
+    out += '}';
+  }
+  out += "]}";
+  co_return out;
+}
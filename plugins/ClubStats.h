@@ -0,0 +1,56 @@
+#pragma once
+
+#include "common/RequestTiming.h"
+#include <drogon/plugins/Plugin.h>
+#include <drogon/utils/coroutine.h>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 社团看板统计：报名漏斗、缴费情况、各活动出勤率与按月成员增长。
+// 三条按社团过滤的 GROUP BY 查询算出结果，序列化后按社团缓存 ttl 秒；
+// 成员、活动、报名、缴费、签到的写入路径调用 invalidate*，下一次请求重新统计。
+// 统计期间发生的失效会作废这次结果，不会把旧数据写回缓存。
+// invalidateActivity 只能找到已缓存社团中的活动，其余情形由 ttl 兜底。
+// 统计查询发往主库，失效之后读不到只读库的旧数据。
+// 配置：
+//   ttl  缓存秒数，默认 30
+class ClubStats : public drogon::Plugin<ClubStats> {
+public:
+  ClubStats() = default;
+  void initAndStart(const Json::Value &config) override;
+  void shutdown() override;
+
+  // 社团统计的 JSON；数据库异常向调用方抛出，统计查询的耗时记入 timing
+  drogon::Task<std::shared_ptr<const std::string>>
+  stats(int clubId, common::RequestTiming *timing = nullptr);
+
+  void invalidateClub(int clubId);
+  void invalidateActivity(int activityId);
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Entry {
+    std::shared_ptr<const std::string> json;
+    Clock::time_point expires;
+    std::vector<int> activityIds;
+  };
+
+  drogon::Task<std::string> compute(int clubId, std::vector<int> &activityIds,
+                                    common::RequestTiming *timing);
+  // 需持有 mutex_
+  void eraseLocked(int clubId);
+
+  Clock::duration ttl_ = std::chrono::seconds(30);
+
+  std::mutex mutex_;
+  std::unordered_map<int, Entry> entries_;
+  std::unordered_map<int, int> activityClubs_; // 已缓存的 activity_id -> club_id
+  // 每个社团的失效次数，统计开始与结束时不一致则丢弃结果
+  std::unordered_map<int, uint64_t> generations_;
+};
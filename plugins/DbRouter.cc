@@ -0,0 +1,83 @@
+#include "DbRouter.h"
+#include "common/RequestTiming.h"
+#include "plugins/SessionManager.h"
+#include <drogon/HttpAppFramework.h>
+#include <trantor/utils/Date.h>
+#include <mutex>
+
+namespace {
+constexpr double kPurgeInterval = 60.0; // 秒
+
+int64_t nowMicros() { return trantor::Date::now().microSecondsSinceEpoch(); }
+} // namespace
+
+void DbRouter::initAndStart(const Json::Value &config) {
+  readClient_ = config.get("read_client", "").asString();
+  windowMicros_ = static_cast<int64_t>(
+      config.get("read_your_writes_window", 2.0).asDouble() * 1000000);
+
+  purgeTimer_ = drogon::app().getLoop()->runEvery(kPurgeInterval,
+                                                  [this]() { purge(); });
+}
+
+void DbRouter::shutdown() {
+  drogon::app().getLoop()->invalidateTimer(purgeTimer_);
+}
+
+int DbRouter::userOf(const drogon::HttpRequestPtr &req) {
+  int userId = common::currentSession(req).userId;
+  if (userId != 0) {
+    return userId;
+  }
+  const auto &token = req->getCookie("session_token");
+  common::SessionClaims claims;
+  common::PhaseTimer timer(*req, "auth");
+  if (!token.empty() &&
+      drogon::app().getPlugin<SessionManager>()->verify(token, claims)) {
+    return claims.userId;
+  }
+  return 0;
+}
+
+drogon::orm::DbClientPtr
+DbRouter::reader(const drogon::HttpRequestPtr &req) const {
+  if (readClient_.empty()) {
+    return drogon::app().getDbClient();
+  }
+
+  int userId = userOf(req);
+  if (userId != 0) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = lastWrites_.find(userId);
+    if (it != lastWrites_.end() && nowMicros() - it->second < windowMicros_) {
+      return drogon::app().getDbClient();
+    }
+  }
+  return drogon::app().getDbClient(readClient_);
+}
+
+drogon::orm::DbClientPtr DbRouter::readClient() const {
+  if (readClient_.empty()) {
+    return nullptr;
+  }
+  return drogon::app().getDbClient(readClient_);
+}
+
+void DbRouter::recordWrite(const drogon::HttpRequestPtr &req) {
+  if (readClient_.empty()) {
+    return;
+  }
+  int userId = userOf(req);
+  if (userId == 0) {
+    return;
+  }
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  lastWrites_[userId] = nowMicros();
+}
+
+void DbRouter::purge() {
+  auto oldest = nowMicros() - windowMicros_;
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  std::erase_if(lastWrites_,
+                [oldest](const auto &entry) { return entry.second < oldest; });
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <drogon/HttpRequest.h>
+#include <drogon/orm/DbClient.h>
+#include <drogon/plugins/Plugin.h>
+#include <trantor/net/EventLoop.h>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+// 读写分离。
+// 写语句一律发往主库（db_clients 中未命名的默认客户端）；
+// GET 请求中的只读查询发往 read_client 指定的只读客户端，
+// 列表类查询不再与签到、报名的写入排在同一个连接池里。
+// 路由本身在 dao::exec(req, ...) 中完成。
+// 读己之写：用户的写入提交后 read_your_writes_window 秒内，
+// 该用户的读取仍走主库，避免从只读库读到尚未同步的旧数据。
+// 写入时刻只在进程内存中，定时清理过期记录。
+//
+// 配置：
+//   "read_client":            只读客户端名，需在 db_clients 中定义；为空时不分离
+//   "read_your_writes_window": 秒，默认 2.0，应大于只读库的复制延迟
+class DbRouter : public drogon::Plugin<DbRouter> {
+public:
+  DbRouter() = default;
+  void initAndStart(const Json::Value &config) override;
+  void shutdown() override;
+
+  // 发出该请求的用户应当使用的读客户端
+  drogon::orm::DbClientPtr reader(const drogon::HttpRequestPtr &req) const;
+
+  // 记录该请求的用户刚刚写入
+  void recordWrite(const drogon::HttpRequestPtr &req);
+
+  // 只读客户端，未配置读写分离时返回 nullptr
+  drogon::orm::DbClientPtr readClient() const;
+
+private:
+  // 请求的用户；SessionFilter 未运行时从 Cookie 中的令牌解出，匿名为 0
+  static int userOf(const drogon::HttpRequestPtr &req);
+  void purge();
+
+  std::string readClient_;
+  int64_t windowMicros_ = 2000000;
+
+  mutable std::shared_mutex mutex_;
+  // user_id -> 最近一次写入的时刻，微秒
+  std::unordered_map<int, int64_t> lastWrites_;
+  trantor::TimerId purgeTimer_{0};
+};
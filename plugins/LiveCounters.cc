@@ -0,0 +1,211 @@
+#include "LiveCounters.h"
+#include "dao/Db.h"
+#include <drogon/HttpAppFramework.h>
+#include <drogon/orm/Exception.h>
+#include <algorithm>
+#include <mutex>
+#include <optional>
+
+namespace {
+// 首次加载失败后的重试间隔上限，秒
+constexpr double kMaxRetryDelay = 60.0;
+} // namespace
+
+std::atomic<int> *LiveCounters::ActivityCells::status(std::string_view name) {
+  if (name == "pending") {
+    return &pending;
+  }
+  if (name == "accepted") {
+    return &accepted;
+  }
+  if (name == "waitlist") {
+    return &waitlist;
+  }
+  return nullptr;
+}
+
+void LiveCounters::initAndStart(const Json::Value &config) {
+  double interval = config.get("reconcile_interval", 300.0).asDouble();
+
+  // 立即发起加载，连接未就绪时查询在客户端排队；加载完成前计数接口返回 503。
+  // 所依赖的计量插件在 config.json 中声明，先于本插件初始化
+  drogon::async_run([this]() -> drogon::Task<> { co_await reconcile(); });
+  if (interval > 0) {
+    reconcileTimer_ =
+        drogon::app().getLoop()->runEvery(interval, [this]() {
+          drogon::async_run(
+              [this]() -> drogon::Task<> { co_await reconcile(); });
+        });
+  }
+}
+
+void LiveCounters::shutdown() {
+  drogon::app().getLoop()->invalidateTimer(reconcileTimer_);
+  drogon::app().getLoop()->invalidateTimer(retryTimer_);
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  clubs_.clear();
+  activities_.clear();
+}
+
+LiveCounters::ClubCounts LiveCounters::club(int clubId) const {
+  ClubCounts counts;
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto it = clubs_.find(clubId);
+  if (it != clubs_.end()) {
+    counts.members = it->second->members.load(std::memory_order_relaxed);
+  }
+  return counts;
+}
+
+LiveCounters::ActivityCounts LiveCounters::activity(int activityId) const {
+  ActivityCounts counts;
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto it = activities_.find(activityId);
+  if (it != activities_.end()) {
+    const auto &cells = *it->second;
+    counts.pending = cells.pending.load(std::memory_order_relaxed);
+    counts.accepted = cells.accepted.load(std::memory_order_relaxed);
+    counts.waitlist = cells.waitlist.load(std::memory_order_relaxed);
+    counts.checkedIn = cells.checkedIn.load(std::memory_order_relaxed);
+  }
+  return counts;
+}
+
+void LiveCounters::memberJoined(int clubId, int count) {
+  clubCells(clubId)->members.fetch_add(count, std::memory_order_relaxed);
+}
+
+void LiveCounters::memberLeft(int clubId, int count) {
+  clubCells(clubId)->members.fetch_sub(count, std::memory_order_relaxed);
+}
+
+void LiveCounters::registrationMoved(int activityId, std::string_view from,
+                                     std::string_view to, int count) {
+  auto cells = activityCells(activityId);
+  if (auto *counter = cells->status(from)) {
+    counter->fetch_sub(count, std::memory_order_relaxed);
+  }
+  if (auto *counter = cells->status(to)) {
+    counter->fetch_add(count, std::memory_order_relaxed);
+  }
+}
+
+void LiveCounters::checkedIn(int activityId) {
+  activityCells(activityId)->checkedIn.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LiveCounters::forgetActivity(int activityId) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  activities_.erase(activityId);
+}
+
+std::shared_ptr<LiveCounters::ClubCells> LiveCounters::clubCells(int clubId) {
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = clubs_.find(clubId);
+    if (it != clubs_.end()) {
+      return it->second;
+    }
+  }
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  auto &cells = clubs_[clubId];
+  if (!cells) {
+    cells = std::make_shared<ClubCells>();
+  }
+  return cells;
+}
+
+std::shared_ptr<LiveCounters::ActivityCells>
+LiveCounters::activityCells(int activityId) {
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = activities_.find(activityId);
+    if (it != activities_.end()) {
+      return it->second;
+    }
+  }
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  auto &cells = activities_[activityId];
+  if (!cells) {
+    cells = std::make_shared<ActivityCells>();
+  }
+  return cells;
+}
+
+drogon::Task<> LiveCounters::reconcile() {
+  // 上一次校正还没结束时跳过本轮
+  if (reconciling_.exchange(true)) {
+    co_return;
+  }
+
+  std::optional<drogon::orm::Result> members;
+  std::optional<drogon::orm::Result> registrations;
+  std::optional<drogon::orm::Result> checkins;
+  try {
+    members = co_await dao::exec(dao::sql::kMemberCountsByClub);
+    registrations = co_await dao::exec(dao::sql::kRegistrationCountsByActivity);
+    checkins = co_await dao::exec(dao::sql::kCheckinCountsByActivity);
+  } catch (const drogon::orm::DrogonDbException &e) {
+    LOG_ERROR << "计数校正失败: " << e.base().what();
+    // 已加载过时留给下一轮定时校正；首次加载不能等一个完整的间隔
+    if (!loaded_.load(std::memory_order_acquire)) {
+      scheduleRetry();
+    }
+    reconciling_.store(false);
+    co_return;
+  }
+
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    // 结果中没有的社团、活动归零而不删除，正在使用这些计数的写入不会丢失对象
+    for (auto &[id, cells] : clubs_) {
+      cells->members.store(0, std::memory_order_relaxed);
+    }
+    for (auto &[id, cells] : activities_) {
+      cells->pending.store(0, std::memory_order_relaxed);
+      cells->accepted.store(0, std::memory_order_relaxed);
+      cells->waitlist.store(0, std::memory_order_relaxed);
+      cells->checkedIn.store(0, std::memory_order_relaxed);
+    }
+
+    for (const auto &row : *members) {
+      auto &cells = clubs_[row["club_id"].as<int>()];
+      if (!cells) {
+        cells = std::make_shared<ClubCells>();
+      }
+      cells->members.store(row["members"].as<int>(), std::memory_order_relaxed);
+    }
+    auto cellsOf = [this](int activityId) -> ActivityCells & {
+      auto &cells = activities_[activityId];
+      if (!cells) {
+        cells = std::make_shared<ActivityCells>();
+      }
+      return *cells;
+    };
+    for (const auto &row : *registrations) {
+      auto &cells = cellsOf(row["activity_id"].as<int>());
+      cells.pending.store(row["pending"].as<int>(), std::memory_order_relaxed);
+      cells.accepted.store(row["accepted"].as<int>(),
+                           std::memory_order_relaxed);
+      cells.waitlist.store(row["waitlist"].as<int>(),
+                           std::memory_order_relaxed);
+    }
+    for (const auto &row : *checkins) {
+      cellsOf(row["activity_id"].as<int>())
+          .checkedIn.store(row["checked_in"].as<int>(),
+                           std::memory_order_relaxed);
+    }
+  }
+
+  loaded_.store(true, std::memory_order_release);
+  reconciling_.store(false);
+}
+
+void LiveCounters::scheduleRetry() {
+  double delay = retryDelay_;
+  retryDelay_ = std::min(retryDelay_ * 2, kMaxRetryDelay);
+  LOG_WARN << "计数将在 " << delay << " 秒后重新加载";
+  retryTimer_ = drogon::app().getLoop()->runAfter(delay, [this]() {
+    drogon::async_run([this]() -> drogon::Task<> { co_await reconcile(); });
+  });
+}
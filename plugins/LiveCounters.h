@@ -0,0 +1,92 @@
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <drogon/utils/coroutine.h>
+#include <trantor/net/EventLoop.h>
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+
+// 社团成员数、活动报名数与签到数的内存计数。
+// 启动时用三条 GROUP BY 查询加载，之后由写入路径在数据库写入成功后增减：
+//   成员      ClubMemberController::approve / remove、社团审批通过
+//   报名      registerActivity / cancelRegistration / reviewRegistration、
+//             SeatLedger::promote 的候补递补
+//   签到      ActivityCheckinController::checkin
+// 读取在读锁下做几次原子加载，不访问数据库；增减只在首次遇到某个社团、活动时取写锁。
+// 后台按 reconcile_interval 秒重新统计一次并覆盖内存值，校正多实例部署、
+// 直接改库或统计与写入交错造成的偏差；交错期间的增减可能丢失或重复，
+// 偏差留到下一次校正。
+// 首次加载失败时按 1、2、4 … 60 秒的间隔退避重试，直到成功；此前计数接口返回 503。
+// 配置：
+//   reconcile_interval  校正间隔秒数，默认 300；0 表示只在启动时加载
+class LiveCounters : public drogon::Plugin<LiveCounters> {
+public:
+  struct ClubCounts {
+    int members = 0;
+  };
+
+  struct ActivityCounts {
+    int pending = 0;
+    int accepted = 0;
+    int waitlist = 0;
+    int checkedIn = 0;
+  };
+
+  LiveCounters() = default;
+  void initAndStart(const Json::Value &config) override;
+  void shutdown() override;
+
+  // 首次加载是否完成
+  bool ready() const { return loaded_.load(std::memory_order_acquire); }
+
+  // 没有记录的社团、活动计数为 0
+  ClubCounts club(int clubId) const;
+  ActivityCounts activity(int activityId) const;
+
+  void memberJoined(int clubId, int count = 1);
+  void memberLeft(int clubId, int count = 1);
+
+  // 报名状态从 from 变为 to，from 为空表示新报名；
+  // 只统计 pending、accepted、waitlist，其余状态视为不计数
+  void registrationMoved(int activityId, std::string_view from,
+                         std::string_view to, int count = 1);
+  void checkedIn(int activityId);
+
+  // 活动删除后丢弃其计数
+  void forgetActivity(int activityId);
+
+private:
+  struct ClubCells {
+    std::atomic<int> members{0};
+  };
+
+  struct ActivityCells {
+    std::atomic<int> pending{0};
+    std::atomic<int> accepted{0};
+    std::atomic<int> waitlist{0};
+    std::atomic<int> checkedIn{0};
+
+    // 报名状态对应的计数，不计数的状态返回 nullptr
+    std::atomic<int> *status(std::string_view name);
+  };
+
+  std::shared_ptr<ClubCells> clubCells(int clubId);
+  std::shared_ptr<ActivityCells> activityCells(int activityId);
+
+  drogon::Task<> reconcile();
+  // 首次加载失败后在事件循环上安排下一次 reconcile()
+  void scheduleRetry();
+
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<int, std::shared_ptr<ClubCells>> clubs_;
+  std::unordered_map<int, std::shared_ptr<ActivityCells>> activities_;
+
+  std::atomic<bool> loaded_{false};
+  std::atomic<bool> reconciling_{false};
+  trantor::TimerId reconcileTimer_{0};
+  double retryDelay_ = 1.0; // 下一次重试前等待的秒数，只在持有 reconciling_ 时读写
+  trantor::TimerId retryTimer_{0};
+};
@@ -0,0 +1,74 @@
+#include "PermissionIndex.h"
+#include "dao/Db.h"
+#include <mutex>
+
+void PermissionIndex::initAndStart(const Json::Value &config) {}
+
+void PermissionIndex::shutdown() {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  clubFounders_.clear();
+  activityClubs_.clear();
+}
+
+std::optional<int>
+PermissionIndex::cached(const std::unordered_map<int, int> &map,
+                        int key) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto it = map.find(key);
+  if (it == map.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+drogon::Task<std::optional<int>>
+PermissionIndex::clubFounder(int clubId, common::RequestTiming *timing) {
+  if (auto founder = cached(clubFounders_, clubId)) {
+    co_return founder;
+  }
+
+  auto result =
+      co_await dao::exec(timing, dao::sql::kClubFounderById, clubId);
+  if (result.empty()) {
+    co_return std::nullopt;
+  }
+  int founder = result[0]["founder_id"].as<int>();
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    clubFounders_[clubId] = founder;
+  }
+  co_return founder;
+}
+
+drogon::Task<std::optional<int>>
+PermissionIndex::activityFounder(int activityId,
+                                 common::RequestTiming *timing) {
+  if (auto clubId = cached(activityClubs_, activityId)) {
+    co_return co_await clubFounder(*clubId, timing);
+  }
+
+  // 一次查询同时填充两张表
+  auto result =
+      co_await dao::exec(timing, dao::sql::kClubFounderByActivity, activityId);
+  if (result.empty()) {
+    co_return std::nullopt;
+  }
+  int clubId = result[0]["club_id"].as<int>();
+  int founder = result[0]["founder_id"].as<int>();
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    activityClubs_[activityId] = clubId;
+    clubFounders_[clubId] = founder;
+  }
+  co_return founder;
+}
+
+void PermissionIndex::invalidateClub(int clubId) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  clubFounders_.erase(clubId);
+}
+
+void PermissionIndex::invalidateActivity(int activityId) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  activityClubs_.erase(activityId);
+}
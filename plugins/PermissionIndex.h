@@ -0,0 +1,40 @@
+#pragma once
+
+#include "common/RequestTiming.h"
+#include <drogon/plugins/Plugin.h>
+#include <drogon/utils/coroutine.h>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+
+// 写操作权限校验用的归属索引：club_id -> 创始人，activity_id -> club_id。
+// 按需从数据库加载，命中后权限校验只是一次内存查找。
+// 不缓存“不存在”的结果，新建的社团、活动无需预先登记；
+// 创建、审批通过、删除路径仍会调用 invalidate*，
+// 保证归属变化后不会读到旧值。
+// 数据库异常向调用方抛出；查询耗时记入 timing（可以为空）。
+class PermissionIndex : public drogon::Plugin<PermissionIndex> {
+public:
+  PermissionIndex() = default;
+  void initAndStart(const Json::Value &config) override;
+  void shutdown() override;
+
+  // 社团创始人，社团不存在时返回 nullopt
+  drogon::Task<std::optional<int>>
+  clubFounder(int clubId, common::RequestTiming *timing = nullptr);
+
+  // 活动所属社团的创始人，活动不存在时返回 nullopt
+  drogon::Task<std::optional<int>>
+  activityFounder(int activityId, common::RequestTiming *timing = nullptr);
+
+  void invalidateClub(int clubId);
+  void invalidateActivity(int activityId);
+
+private:
+  std::optional<int> cached(const std::unordered_map<int, int> &map,
+                            int key) const;
+
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<int, int> clubFounders_;  // club_id -> founder_id
+  std::unordered_map<int, int> activityClubs_; // activity_id -> club_id
+};
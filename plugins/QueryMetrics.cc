@@ -0,0 +1,88 @@
+#include "QueryMetrics.h"
+#include <drogon/HttpAppFramework.h>
+#include <drogon/plugins/PromExporter.h>
+#include <string>
+#include <vector>
+
+using namespace drogon;
+
+namespace {
+
+// 秒；覆盖从索引命中到全表扫描的范围
+const std::vector<double> kSecondsBuckets{0.0005, 0.001, 0.0025, 0.005,
+                                          0.01,   0.025, 0.05,   0.1,
+                                          0.25,   0.5,   1.0,    2.5};
+const std::vector<double> kRowsBuckets{0, 1, 5, 10, 50, 100, 500, 1000, 5000};
+
+} // namespace
+
+void QueryMetrics::initAndStart(const Json::Value &) {
+  using monitoring::Collector;
+  using monitoring::Counter;
+  using monitoring::Histogram;
+
+  const std::vector<std::string> labels{"statement"};
+  duration_ = std::make_shared<Collector<Histogram>>(
+      "db_query_duration_seconds", "数据库查询耗时，含连接池排队", labels);
+  poolWait_ = std::make_shared<Collector<Histogram>>(
+      "db_query_pool_wait_seconds", "估计的连接池排队等待", labels);
+  rows_ = std::make_shared<Collector<Histogram>>(
+      "db_query_rows", "查询返回或影响的行数", labels);
+  errors_ = std::make_shared<Collector<Counter>>("db_query_errors_total",
+                                                 "查询出错次数", labels);
+
+  auto exporter = app().getPlugin<plugin::PromExporter>();
+  exporter->registerCollector(duration_);
+  exporter->registerCollector(poolWait_);
+  exporter->registerCollector(rows_);
+  exporter->registerCollector(errors_);
+
+  for (const dao::Statement *stmt : dao::sql::kAll) {
+    add(*stmt);
+  }
+  for (const dao::Statement *stmt : dao::sql::kPrefixes) {
+    add(*stmt);
+  }
+}
+
+void QueryMetrics::shutdown() {}
+
+void QueryMetrics::add(const dao::Statement &stmt) {
+  const std::vector<std::string> values{stmt.name};
+  series_.emplace(&stmt, Series{duration_->metric(values, kSecondsBuckets),
+                                poolWait_->metric(values, kSecondsBuckets),
+                                rows_->metric(values, kRowsBuckets),
+                                errors_->metric(values)});
+}
+
+const QueryMetrics::Series *
+QueryMetrics::find(const dao::Statement &stmt) const {
+  auto it = series_.find(&stmt);
+  return it == series_.end() ? nullptr : &it->second;
+}
+
+void QueryMetrics::observeTiming(const Series &series, double elapsedMs,
+                                 double waitMs) {
+  series.duration->observe(elapsedMs / 1000.0);
+  series.poolWait->observe(waitMs / 1000.0);
+}
+
+void QueryMetrics::record(const dao::Statement &stmt, double elapsedMs,
+                          double waitMs, size_t rows) {
+  const Series *series = find(stmt);
+  if (series == nullptr) {
+    return;
+  }
+  observeTiming(*series, elapsedMs, waitMs);
+  series->rows->observe(static_cast<double>(rows));
+}
+
+void QueryMetrics::recordError(const dao::Statement &stmt, double elapsedMs,
+                               double waitMs) {
+  const Series *series = find(stmt);
+  if (series == nullptr) {
+    return;
+  }
+  observeTiming(*series, elapsedMs, waitMs);
+  series->errors->increment();
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "dao/Statements.h"
+#include <drogon/plugins/Plugin.h>
+#include <drogon/utils/monitoring/Collector.h>
+#include <drogon/utils/monitoring/Counter.h>
+#include <drogon/utils/monitoring/Histogram.h>
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+
+// 按语句统计的数据库指标，经 PromExporter 在 /metrics 上导出：
+//   db_query_duration_seconds  查询耗时直方图（含排队）
+//   db_query_pool_wait_seconds 估计的连接池排队等待直方图
+//   db_query_rows              返回行数直方图，写语句为影响行数
+//   db_query_errors_total      出错次数
+// 标签 statement 取 dao::Statement::name。
+// dao::exec 与 CheckinPipeline 的批量写入在每条查询结束后调用 record()。
+// 各语句的指标在 initAndStart 中一次建好，之后只读，记录时不加锁；
+// 因此在 initAndStart 中就发起查询的插件须在 config.json 中依赖本插件，
+// 保证查询结束调用 record() 时表已建完。
+class QueryMetrics : public drogon::Plugin<QueryMetrics> {
+public:
+  QueryMetrics() = default;
+  void initAndStart(const Json::Value &config) override;
+  void shutdown() override;
+
+  // 成功的查询
+  void record(const dao::Statement &stmt, double elapsedMs, double waitMs,
+              size_t rows);
+  // 失败的查询
+  void recordError(const dao::Statement &stmt, double elapsedMs,
+                   double waitMs);
+
+private:
+  struct Series {
+    std::shared_ptr<drogon::monitoring::Histogram> duration;
+    std::shared_ptr<drogon::monitoring::Histogram> poolWait;
+    std::shared_ptr<drogon::monitoring::Histogram> rows;
+    std::shared_ptr<drogon::monitoring::Counter> errors;
+  };
+
+  void add(const dao::Statement &stmt);
+  const Series *find(const dao::Statement &stmt) const;
+  void observeTiming(const Series &series, double elapsedMs, double waitMs);
+
+  std::shared_ptr<drogon::monitoring::Collector<drogon::monitoring::Histogram>>
+      duration_;
+  std::shared_ptr<drogon::monitoring::Collector<drogon::monitoring::Histogram>>
+      poolWait_;
+  std::shared_ptr<drogon::monitoring::Collector<drogon::monitoring::Histogram>>
+      rows_;
+  std::shared_ptr<drogon::monitoring::Collector<drogon::monitoring::Counter>>
+      errors_;
+  // 以语句地址为键；语句都是 dao::sql 中的常量
+  std::unordered_map<const dao::Statement *, Series> series_;
+};
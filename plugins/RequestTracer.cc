@@ -0,0 +1,61 @@
+#include "RequestTracer.h"
+#include "common/RequestTiming.h"
+#include <drogon/HttpAppFramework.h>
+#include <algorithm>
+#include <random>
+
+using namespace drogon;
+
+void RequestTracer::initAndStart(const Json::Value &config) {
+  serverTiming_ = config.get("server_timing", true).asBool();
+  sampleRate_ =
+      std::clamp(config.get("trace_sample_rate", 0.0).asDouble(), 0.0, 1.0);
+  if (!serverTiming_ && sampleRate_ == 0.0) {
+    return;
+  }
+
+  // 路由之后、过滤器之前挂上计时，SessionFilter 的耗时计入 auth
+  app().registerPostRoutingAdvice(
+      [](const HttpRequestPtr &req) { common::attachRequestTiming(req); });
+
+  app().registerPreHandlingAdvice([](const HttpRequestPtr &req) {
+    if (auto *timing = common::requestTiming(*req)) {
+      timing->markHandler();
+    }
+  });
+
+  app().registerPostHandlingAdvice(
+      [this](const HttpRequestPtr &req, const HttpResponsePtr &resp) {
+        auto *timing = common::requestTiming(*req);
+        if (timing == nullptr) {
+          return;
+        }
+        double render = timing->sinceHandler() - timing->total("db") -
+                        timing->total("parse");
+        timing->add("render", std::max(0.0, render));
+        timing->add("total", timing->sinceStart());
+
+        auto header = timing->serverTiming();
+        if (serverTiming_) {
+          resp->addHeader("Server-Timing", header);
+        }
+        if (sampled()) {
+          LOG_INFO << "trace " << req->methodString() << ' ' << req->path()
+                   << ' ' << static_cast<int>(resp->statusCode()) << ' '
+                   << header;
+        }
+      });
+}
+
+void RequestTracer::shutdown() {}
+
+bool RequestTracer::sampled() const {
+  if (sampleRate_ <= 0.0) {
+    return false;
+  }
+  if (sampleRate_ >= 1.0) {
+    return true;
+  }
+  thread_local std::minstd_rand rng{std::random_device{}()};
+  return std::uniform_real_distribution<double>(0.0, 1.0)(rng) < sampleRate_;
+}
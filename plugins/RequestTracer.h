@@ -0,0 +1,30 @@
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+
+// 请求分阶段计时。
+// 路由后为请求挂上 common::RequestTiming，各阶段的记录点：
+//   auth    SessionFilter 与 DbRouter 校验会话令牌
+//   parse   parseRequest 解析请求体
+//   db      dao::exec 中的每条语句，另按语句名记为 db.<语句名>；
+//           插件代请求执行的查询与签到管道的批量写入等待同样计入
+//   render  处理函数中除 parse、db 之外的时间，即构造与序列化 JSON
+//   total   从路由完成到处理函数返回响应
+// 响应带上 Server-Timing 头，浏览器开发者工具中可直接查看；
+// 按 trace_sample_rate 抽样写一行追踪日志。
+//
+// 配置：
+//   "server_timing":     是否输出 Server-Timing 头，默认 true
+//   "trace_sample_rate": 追踪日志的抽样比例，0 到 1，默认 0
+class RequestTracer : public drogon::Plugin<RequestTracer> {
+public:
+  RequestTracer() = default;
+  void initAndStart(const Json::Value &config) override;
+  void shutdown() override;
+
+private:
+  bool sampled() const;
+
+  bool serverTiming_ = true;
+  double sampleRate_ = 0.0;
+};
@@ -0,0 +1,301 @@
+#include "SearchIndex.h"
+#include "common/JsonStream.h"
+#include "dao/Db.h"
+#include <drogon/HttpAppFramework.h>
+#include <drogon/orm/Exception.h>
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+namespace {
+
+// 标题、名称命中比简介、描述命中更相关
+constexpr float kTitleWeight = 3.0f;
+constexpr float kBodyWeight = 1.0f;
+
+// 重建失败后的重试间隔，秒
+constexpr double kMinRetryDelay = 1.0;
+constexpr double kMaxRetryDelay = 60.0;
+
+// 解出 pos 处的一个 UTF-8 码点并前移 pos；非法字节返回 0 并跳过一个字节
+char32_t nextCodePoint(std::string_view text, size_t &pos) {
+  auto lead = static_cast<unsigned char>(text[pos]);
+  size_t length = lead < 0x80           ? 1
+                  : (lead >> 5) == 0x6  ? 2
+                  : (lead >> 4) == 0xE  ? 3
+                  : (lead >> 3) == 0x1E ? 4
+                                        : 0;
+  if (length == 0 || pos + length > text.size()) {
+    ++pos;
+    return 0;
+  }
+  char32_t cp = length == 1 ? lead : lead & (0x7F >> length);
+  for (size_t i = 1; i < length; ++i) {
+    auto next = static_cast<unsigned char>(text[pos + i]);
+    if ((next & 0xC0) != 0x80) {
+      ++pos;
+      return 0;
+    }
+    cp = (cp << 6) | (next & 0x3F);
+  }
+  pos += length;
+  return cp;
+}
+
+bool isCjk(char32_t cp) {
+  return (cp >= 0x3040 && cp <= 0x30FF) ||   // 平假名、片假名
+         (cp >= 0x3400 && cp <= 0x4DBF) ||   // 扩展 A
+         (cp >= 0x4E00 && cp <= 0x9FFF) ||   // 基本汉字
+         (cp >= 0xAC00 && cp <= 0xD7AF) ||   // 谚文音节
+         (cp >= 0xF900 && cp <= 0xFAFF) ||   // 兼容汉字
+         (cp >= 0x20000 && cp <= 0x2FFFF);   // 扩展 B 及以后
+}
+
+bool isAsciiWord(char32_t cp) {
+  return (cp >= '0' && cp <= '9') || (cp >= 'a' && cp <= 'z') ||
+         (cp >= 'A' && cp <= 'Z');
+}
+
+// 切分文本，每个词项调用一次 emit。
+// forQuery 为 true 时，两字及以上的汉字串只产生二元组
+template <typename Emit>
+void tokenize(std::string_view text, bool forQuery, Emit &&emit) {
+  std::string word;
+  // 当前汉字串：各字在 text 中的起止位置
+  std::vector<std::pair<size_t, size_t>> run;
+
+  auto flushWord = [&]() {
+    if (!word.empty()) {
+      emit(std::string_view(word));
+      word.clear();
+    }
+  };
+  auto flushRun = [&]() {
+    for (size_t i = 0; i < run.size(); ++i) {
+      if (!forQuery || run.size() == 1) {
+        emit(text.substr(run[i].first, run[i].second - run[i].first));
+      }
+      if (i + 1 < run.size()) {
+        emit(text.substr(run[i].first, run[i + 1].second - run[i].first));
+      }
+    }
+    run.clear();
+  };
+
+  size_t pos = 0;
+  while (pos < text.size()) {
+    size_t start = pos;
+    char32_t cp = nextCodePoint(text, pos);
+    if (isCjk(cp)) {
+      flushWord();
+      run.emplace_back(start, pos);
+    } else if (isAsciiWord(cp)) {
+      flushRun();
+      // 大写转小写
+      word += static_cast<char>(cp <= 'Z' && cp >= 'A' ? cp | 0x20 : cp);
+    } else {
+      flushWord();
+      flushRun();
+    }
+  }
+  flushWord();
+  flushRun();
+}
+
+// 构建时收集一篇文档的词项权重
+using TermWeights = std::unordered_map<std::string, float>;
+
+void addField(TermWeights &terms, std::string_view text, float weight) {
+  tokenize(text, false,
+           [&](std::string_view term) { terms[std::string(term)] += weight; });
+}
+
+} // namespace
+
+void SearchSnapshot::add(SearchDoc doc, std::string_view title,
+                         std::string_view body) {
+  TermWeights terms;
+  addField(terms, title, kTitleWeight);
+  addField(terms, body, kBodyWeight);
+  auto index = static_cast<uint32_t>(docs.size());
+  for (const auto &[term, weight] : terms) {
+    postings[term].push_back({index, weight});
+  }
+  docs.push_back(std::move(doc));
+}
+
+std::vector<SearchHit> SearchSnapshot::search(std::string_view query,
+                                              const SearchDoc::Type *type,
+                                              size_t limit,
+                                              size_t &total) const {
+  total = 0;
+  std::vector<const std::vector<Posting> *> lists;
+  std::unordered_set<std::string> seen;
+  bool missing = false;
+  tokenize(query, true, [&](std::string_view term) {
+    std::string key(term);
+    if (missing || !seen.insert(key).second) {
+      return;
+    }
+    auto it = postings.find(key);
+    if (it == postings.end()) {
+      missing = true;
+      return;
+    }
+    lists.push_back(&it->second);
+  });
+  if (missing || lists.empty()) {
+    return {};
+  }
+
+  // 从最短的倒排表出发，在其余表中二分查找同一文档
+  std::sort(lists.begin(), lists.end(),
+            [](const auto *a, const auto *b) { return a->size() < b->size(); });
+  const double docCount = static_cast<double>(docs.size());
+  std::vector<double> idf;
+  idf.reserve(lists.size());
+  for (const auto *list : lists) {
+    idf.push_back(
+        std::log(1.0 + docCount / static_cast<double>(list->size())));
+  }
+
+  std::vector<SearchHit> hits;
+  for (const auto &first : *lists.front()) {
+    const SearchDoc &doc = docs[first.doc];
+    if (type != nullptr && doc.type != *type) {
+      continue;
+    }
+    double score = first.weight * idf[0];
+    bool matched = true;
+    for (size_t i = 1; i < lists.size() && matched; ++i) {
+      const auto &list = *lists[i];
+      auto it = std::lower_bound(
+          list.begin(), list.end(), first.doc,
+          [](const Posting &p, uint32_t doc) { return p.doc < doc; });
+      if (it == list.end() || it->doc != first.doc) {
+        matched = false;
+      } else {
+        score += it->weight * idf[i];
+      }
+    }
+    if (matched) {
+      hits.push_back({&doc, score});
+    }
+  }
+
+  total = hits.size();
+  auto byScore = [](const SearchHit &a, const SearchHit &b) {
+    if (a.score != b.score) {
+      return a.score > b.score;
+    }
+    return a.doc < b.doc; // 同分时社团在前，再按 id
+  };
+  if (hits.size() > limit) {
+    std::partial_sort(hits.begin(), hits.begin() + limit, hits.end(), byScore);
+    hits.resize(limit);
+  } else {
+    std::sort(hits.begin(), hits.end(), byScore);
+  }
+  return hits;
+}
+
+void SearchIndex::initAndStart(const Json::Value &config) {
+  // 立即发起加载，连接未就绪时查询在客户端排队；
+  // 所依赖的计量插件在 config.json 中声明，先于本插件初始化
+  refresh();
+}
+
+void SearchIndex::shutdown() {
+  drogon::app().getLoop()->invalidateTimer(retryTimer_);
+  snapshot_.store(nullptr, std::memory_order_release);
+}
+
+void SearchIndex::refresh() {
+  dirty_.store(true, std::memory_order_release);
+  if (!rebuilding_.exchange(true)) {
+    drogon::async_run([this]() -> drogon::Task<> { co_await rebuildLoop(); });
+  }
+}
+
+drogon::Task<> SearchIndex::rebuildLoop() {
+  for (;;) {
+    dirty_.store(false, std::memory_order_release);
+    if (co_await rebuild()) {
+      retryDelay_ = kMinRetryDelay;
+    } else {
+      scheduleRetry();
+    }
+    if (dirty_.load(std::memory_order_acquire)) {
+      continue;
+    }
+    rebuilding_.store(false);
+    // 放下标记后才到的 refresh() 会自己启动重建；
+    // 放下之前到的由这里接着重建
+    if (!dirty_.load(std::memory_order_acquire) || rebuilding_.exchange(true)) {
+      co_return;
+    }
+  }
+}
+
+void SearchIndex::scheduleRetry() {
+  // 已有待执行的重试时不再叠加
+  if (retryPending_.exchange(true)) {
+    return;
+  }
+  double delay = retryDelay_;
+  retryDelay_ = std::min(retryDelay_ * 2, kMaxRetryDelay);
+  LOG_WARN << "搜索索引将在 " << delay << " 秒后重建";
+  retryTimer_ = drogon::app().getLoop()->runAfter(delay, [this]() {
+    retryPending_.store(false);
+    refresh();
+  });
+}
+
+drogon::Task<bool> SearchIndex::rebuild() {
+  auto next = std::make_shared<SearchSnapshot>();
+  try {
+    auto clubs = co_await dao::exec(dao::sql::kClubCatalog);
+    auto activities = co_await dao::exec(dao::sql::kActivitySearchSource);
+    next->docs.reserve(clubs.size() + activities.size());
+
+    for (const auto &row : clubs) {
+      SearchDoc doc{SearchDoc::Type::Club, row["club_id"].as<int>(),
+                    row["club_id"].as<int>(), {}};
+      auto name = row["club_name"].as<std::string>();
+      auto introduction = row["club_introduction"].as<std::string>();
+      doc.json = "{\"type\":\"club\",\"club_id\":" + std::to_string(doc.id);
+      doc.json += ",\"club_name\":";
+      common::appendJsonString(doc.json, name);
+      doc.json += ",\"club_introduction\":";
+      common::appendJsonString(doc.json, introduction);
+      doc.json += '}';
+
+      next->add(std::move(doc), name, introduction);
+    }
+
+    for (const auto &row : activities) {
+      SearchDoc doc{SearchDoc::Type::Activity, row["activity_id"].as<int>(),
+                    row["club_id"].as<int>(), {}};
+      auto title = row["activity_title"].as<std::string>();
+      doc.json =
+          "{\"type\":\"activity\",\"activity_id\":" + std::to_string(doc.id);
+      doc.json += ",\"club_id\":" + std::to_string(doc.clubId);
+      doc.json += ",\"activity_title\":";
+      common::appendJsonString(doc.json, title);
+      doc.json += ",\"activity_time\":";
+      common::appendJsonString(doc.json,
+                               row["activity_time"].as<std::string>());
+      doc.json += '}';
+
+      next->add(std::move(doc), title,
+                row["activity_description"].as<std::string>());
+    }
+  } catch (const drogon::orm::DrogonDbException &e) {
+    // 保留旧快照继续服务，由 rebuildLoop 安排重试
+    LOG_ERROR << "搜索索引加载失败: " << e.base().what();
+    co_return false;
+  }
+
+  snapshot_.store(std::move(next), std::memory_order_release);
+  co_return true;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <drogon/utils/coroutine.h>
+#include <trantor/net/EventLoop.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// 社团与活动的全文搜索。
+// 覆盖 club.club_name、club_introduction 与
+// club_activity.activity_title、activity_description，建成内存倒排索引。
+// 分词：连续的汉字（含假名、谚文）切成二元组，同时保留单字以支持单字查询；
+// ASCII 字母数字按词切分并转小写；其余字符视为分隔符。
+// 查询按同样规则切分（连续两字及以上只取二元组），要求命中全部词项，
+// 按 字段权重 × 出现次数 × idf 打分排序。
+//
+// 与 ClubCatalog 一样以不可变快照发布：读者一次 atomic<shared_ptr> 加载，
+// 不查库，只短暂持有其内部锁（见 ClubCatalog.h）。
+// club、club_activity 的写入路径调用 refresh()，后台重建整个索引；
+// 重建期间的多次 refresh() 合并为重建结束后的一次。
+// 重建失败时保留旧快照，按 1、2、4 … 60 秒的间隔退避重试，直到成功。
+
+struct SearchDoc {
+  enum class Type : uint8_t { Club, Activity };
+  Type type;
+  int id;     // club_id 或 activity_id
+  int clubId; // 所属社团
+  // 预先序列化好的结果项，搜索接口直接拼接输出
+  std::string json;
+};
+
+struct SearchHit {
+  const SearchDoc *doc;
+  double score;
+};
+
+struct SearchSnapshot {
+  struct Posting {
+    uint32_t doc; // docs 下标，同一词项内升序
+    float weight; // 字段权重 × 出现次数
+  };
+
+  std::vector<SearchDoc> docs; // 先社团后活动，各自按 id 升序
+  std::unordered_map<std::string, std::vector<Posting>> postings;
+
+  // 追加一篇文档，title 与 body 按各自的字段权重切分后计入倒排表。
+  // 文档按下标顺序追加，各倒排表因此按 doc 升序
+  void add(SearchDoc doc, std::string_view title, std::string_view body);
+
+  // 按相关度降序返回前 limit 条；type 为空时不限类型。total 为命中总数
+  std::vector<SearchHit> search(std::string_view query,
+                                const SearchDoc::Type *type, size_t limit,
+                                size_t &total) const;
+};
+
+class SearchIndex : public drogon::Plugin<SearchIndex> {
+public:
+  SearchIndex() = default;
+  void initAndStart(const Json::Value &config) override;
+  void shutdown() override;
+
+  // 当前快照；首次加载完成前或加载失败时返回 nullptr
+  std::shared_ptr<const SearchSnapshot> snapshot() const {
+    return snapshot_.load(std::memory_order_acquire);
+  }
+
+  // 数据有变化，在后台重建索引，不等待完成
+  void refresh();
+
+private:
+  drogon::Task<> rebuildLoop();
+  // 成功时发布新快照并返回 true
+  drogon::Task<bool> rebuild();
+  // 只在 rebuildLoop 中调用
+  void scheduleRetry();
+
+  std::atomic<std::shared_ptr<const SearchSnapshot>> snapshot_;
+  std::atomic<bool> rebuilding_{false};
+  std::atomic<bool> dirty_{false};
+
+  double retryDelay_ = 1.0; // 下一次重试前等待的秒数
+  std::atomic<bool> retryPending_{false};
+  trantor::TimerId retryTimer_{0};
+};
@@ -0,0 +1,156 @@
+#include "SeatLedger.h"
+#include "dao/Db.h"
+#include "plugins/LiveCounters.h"
+#include <drogon/HttpAppFramework.h>
+#include <mutex>
+
+namespace {
+// 计数小于 limit 时加一；limit <= 0 表示不限
+bool tryIncrement(std::atomic<int> &counter, int limit) {
+  if (limit <= 0) {
+    counter.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+  int current = counter.load(std::memory_order_relaxed);
+  while (current < limit) {
+    if (counter.compare_exchange_weak(current, current + 1,
+                                      std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+} // namespace
+
+SeatLedger::Placement SeatLedger::Counters::place() {
+  if (tryIncrement(seats_, capacity_)) {
+    return Placement::Seat;
+  }
+  // 候补上限为 0 时不设候补
+  if (waitlistCapacity_ > 0 && tryIncrement(waiting_, waitlistCapacity_)) {
+    return Placement::Waitlist;
+  }
+  return Placement::Full;
+}
+
+bool SeatLedger::Counters::takeSeat() {
+  return tryIncrement(seats_, capacity_);
+}
+
+void SeatLedger::Counters::releaseSeat(int count) {
+  seats_.fetch_sub(count, std::memory_order_relaxed);
+}
+
+void SeatLedger::Counters::leaveWaitlist(int count) {
+  waiting_.fetch_sub(count, std::memory_order_relaxed);
+}
+
+std::optional<std::string> SeatLedger::Counters::claim(int userId) {
+  std::lock_guard<std::mutex> lock(statusMutex_);
+  auto [it, inserted] = statuses_.try_emplace(userId, "pending");
+  if (inserted) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+void SeatLedger::Counters::unclaim(int userId) {
+  std::lock_guard<std::mutex> lock(statusMutex_);
+  statuses_.erase(userId);
+}
+
+void SeatLedger::Counters::setStatus(int userId, std::string status) {
+  std::lock_guard<std::mutex> lock(statusMutex_);
+  if (status == "cancel") {
+    statuses_.erase(userId);
+  } else {
+    statuses_[userId] = std::move(status);
+  }
+}
+
+void SeatLedger::initAndStart(const Json::Value &config) {}
+
+void SeatLedger::shutdown() {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  activities_.clear();
+}
+
+drogon::Task<std::shared_ptr<SeatLedger::Counters>>
+SeatLedger::counters(int activityId, common::RequestTiming *timing) {
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = activities_.find(activityId);
+    if (it != activities_.end()) {
+      co_return it->second;
+    }
+  }
+
+  auto result =
+      co_await dao::exec(timing, dao::sql::kActivitySeatCounts, activityId);
+  if (result.empty()) {
+    co_return nullptr;
+  }
+  const auto &row = result[0];
+  auto loaded = std::make_shared<Counters>(
+      row["capacity"].isNull() ? 0 : row["capacity"].as<int>(),
+      row["waitlist_capacity"].as<int>(), row["seats"].as<int>(),
+      row["waiting"].as<int>());
+  // 按报名先后读取，后面的记录覆盖前面的，留下每个用户最近一次的状态
+  auto registrations = co_await dao::exec(
+      timing, dao::sql::kRegistrationStatusesByActivity, activityId);
+  for (const auto &registration : registrations) {
+    loaded->setStatus(registration["user_id"].as<int>(),
+                      registration["registration_status"].as<std::string>());
+  }
+
+  // 并发的首次加载只保留先发布的一份，所有请求共用同一组计数
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  co_return activities_.try_emplace(activityId, std::move(loaded))
+      .first->second;
+}
+
+drogon::Task<std::vector<int>>
+SeatLedger::promote(int activityId, common::RequestTiming *timing) {
+  std::vector<int> promoted;
+  auto seats = co_await counters(activityId, timing);
+  if (!seats) {
+    co_return promoted;
+  }
+
+  while (seats->takeSeat()) {
+    bool moved = false;
+    try {
+      auto next = co_await dao::exec(
+          timing, dao::sql::kRegistrationFirstWaitlisted, activityId);
+      if (next.empty()) {
+        seats->releaseSeat();
+        break;
+      }
+      // 条件更新，并发递补或候补者同时取消时只有一方成功
+      auto update = co_await dao::exec(timing, dao::sql::kRegistrationPromote,
+                                       next[0]["registration_id"].as<int>());
+      if (update.affectedRows() > 0) {
+        moved = true;
+        promoted.push_back(next[0]["user_id"].as<int>());
+        seats->setStatus(promoted.back(), "pending");
+        drogon::app().getPlugin<LiveCounters>()->registrationMoved(
+            activityId, "waitlist", "pending");
+      }
+    } catch (...) {
+      seats->releaseSeat();
+      throw;
+    }
+
+    if (moved) {
+      seats->leaveWaitlist();
+    } else {
+      seats->releaseSeat();
+    }
+  }
+  co_return promoted;
+}
+
+void SeatLedger::invalidate(int activityId) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  activities_.erase(activityId);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "common/RequestTiming.h"
+#include <drogon/plugins/Plugin.h>
+#include <drogon/utils/coroutine.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 活动报名名额的内存计数。
+// 每个活动首次报名时从数据库读取名额上限和已占用数，之后占位、释放都是
+// 对原子计数的比较交换，名额与候补均已满的报名不访问数据库即被拒绝。
+// pending、accepted 占用名额，waitlist 占用候补；计数随报名状态的每次变化增减，
+// 调用方在数据库写入失败时负责归还已占的位置。
+// 每个活动同时记录各用户最近一次的报名状态，重复报名在内存中拦下，
+// 同一用户的并发报名只有一个能占位。
+// 修改名额上限后调用 invalidate()，下次访问重新读取；
+// 重新读取与并发报名交错时计数可能短暂偏差几位，下一次 invalidate 即校正。
+class SeatLedger : public drogon::Plugin<SeatLedger> {
+public:
+  enum class Placement { Seat, Waitlist, Full };
+
+  class Counters {
+  public:
+    Counters(int capacity, int waitlistCapacity, int seats, int waiting)
+        : capacity_(capacity), waitlistCapacity_(waitlistCapacity),
+          seats_(seats), waiting_(waiting) {}
+
+    // 先占名额，名额满时占候补
+    Placement place();
+    // 只占名额，不进候补
+    bool takeSeat();
+    void releaseSeat(int count = 1);
+    void leaveWaitlist(int count = 1);
+
+    // 用户已有有效报名时返回其状态；否则为其占位并返回空，
+    // 占位期间同一用户的其他报名请求看到 pending
+    std::optional<std::string> claim(int userId);
+    // 撤销 claim 的占位
+    void unclaim(int userId);
+    // 记录用户最近一次的报名状态
+    void setStatus(int userId, std::string status);
+
+    int capacity() const { return capacity_; }
+    int seats() const { return seats_.load(std::memory_order_relaxed); }
+    int waiting() const { return waiting_.load(std::memory_order_relaxed); }
+
+  private:
+    const int capacity_; // <= 0 表示不限
+    const int waitlistCapacity_;
+    std::atomic<int> seats_;
+    std::atomic<int> waiting_;
+
+    std::mutex statusMutex_;
+    std::unordered_map<int, std::string> statuses_; // 不含已取消的报名
+  };
+
+  SeatLedger() = default;
+  void initAndStart(const Json::Value &config) override;
+  void shutdown() override;
+
+  // 活动的名额计数，活动不存在时返回 nullptr；数据库异常向调用方抛出。
+  // 本插件的查询耗时记入 timing（可以为空），下同
+  drogon::Task<std::shared_ptr<Counters>>
+  counters(int activityId, common::RequestTiming *timing = nullptr);
+
+  // 用空出的名额按报名先后递补候补名单，返回被递补的用户
+  drogon::Task<std::vector<int>>
+  promote(int activityId, common::RequestTiming *timing = nullptr);
+
+  void invalidate(int activityId);
+
+private:
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<int, std::shared_ptr<Counters>> activities_;
+};
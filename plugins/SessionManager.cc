@@ -0,0 +1,83 @@
+#include "SessionManager.h"
+#include <drogon/HttpAppFramework.h>
+#include <openssl/rand.h>
+#include <trantor/utils/Date.h>
+#include <mutex>
+
+namespace {
+constexpr double kPurgeInterval = 60.0; // 秒
+constexpr int64_t kMicrosPerSecond = 1000000;
+
+int64_t nowMicros() { return trantor::Date::now().microSecondsSinceEpoch(); }
+} // namespace
+
+void SessionManager::initAndStart(const Json::Value &config) {
+  ttl_ = config.get("token_ttl", 86400).asInt64();
+  secret_ = config.get("secret", "").asString();
+  if (secret_.empty()) {
+    unsigned char key[32];
+    RAND_bytes(key, sizeof(key));
+    secret_.assign(reinterpret_cast<const char *>(key), sizeof(key));
+    LOG_WARN << "SessionManager 未配置 secret，使用随机密钥，重启后需重新登录";
+  }
+
+  // 令牌编号从随机值开始，避免与重启前签发的令牌重号
+  uint64_t base = 0;
+  RAND_bytes(reinterpret_cast<unsigned char *>(&base), sizeof(base));
+  nextTokenId_ = base >> 1;
+
+  purgeTimer_ = drogon::app().getLoop()->runEvery(kPurgeInterval,
+                                                  [this]() { purge(); });
+}
+
+void SessionManager::shutdown() {
+  drogon::app().getLoop()->invalidateTimer(purgeTimer_);
+}
+
+std::string SessionManager::issue(int userId, const std::string &userType) {
+  common::SessionClaims claims;
+  claims.userId = userId;
+  claims.userType = userType;
+  claims.issuedAt = nowMicros();
+  claims.expiresAt = claims.issuedAt + ttl_ * kMicrosPerSecond;
+  claims.tokenId = nextTokenId_++;
+  return common::signSessionToken(claims, secret_);
+}
+
+bool SessionManager::verify(std::string_view token,
+                            common::SessionClaims &claims) const {
+  if (!common::verifySessionToken(token, secret_, claims) ||
+      claims.expiresAt <= nowMicros()) {
+    return false;
+  }
+
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  if (revokedTokens_.count(claims.tokenId) > 0) {
+    return false;
+  }
+  auto it = revokedUsers_.find(claims.userId);
+  return it == revokedUsers_.end() || claims.issuedAt > it->second;
+}
+
+void SessionManager::revoke(const common::SessionClaims &claims) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  revokedTokens_[claims.tokenId] = claims.expiresAt;
+}
+
+void SessionManager::revokeUser(int userId) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  revokedUsers_[userId] = nowMicros();
+}
+
+void SessionManager::purge() {
+  auto now = nowMicros();
+  // 撤销时刻早于一个有效期之前的记录，它覆盖的令牌都已过期
+  auto oldestIssued = now - ttl_ * kMicrosPerSecond;
+
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  std::erase_if(revokedTokens_,
+                [now](const auto &entry) { return entry.second <= now; });
+  std::erase_if(revokedUsers_, [oldestIssued](const auto &entry) {
+    return entry.second < oldestIssued;
+  });
+}
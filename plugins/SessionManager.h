@@ -0,0 +1,57 @@
+#pragma once
+
+#include "common/SessionToken.h"
+#include <drogon/plugins/Plugin.h>
+#include <trantor/net/EventLoop.h>
+#include <atomic>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// 会话令牌的签发、校验与撤销。
+// 令牌本身无状态，只有撤销需要记录：登出撤销单个令牌，
+// 注销账号或角色变更撤销该用户此前签发的全部令牌。
+// 撤销记录只保留到对应令牌过期为止，定时清理，因此名单很小。
+// 撤销名单只在进程内存中，重启后丢失。
+//
+// 配置：
+//   "secret":    HMAC 密钥，为空时启动时随机生成（重启后旧令牌全部失效）
+//   "token_ttl": 令牌有效期，秒，默认 86400
+class SessionManager : public drogon::Plugin<SessionManager> {
+public:
+  SessionManager() = default;
+  void initAndStart(const Json::Value &config) override;
+  void shutdown() override;
+
+  // 为登录成功的用户签发令牌
+  std::string issue(int userId, const std::string &userType);
+
+  // 令牌有效期，秒，用作 Cookie 的 Max-Age
+  int tokenTtl() const { return static_cast<int>(ttl_); }
+
+  // 校验签名、有效期与撤销名单
+  bool verify(std::string_view token, common::SessionClaims &claims) const;
+
+  // 撤销单个令牌（登出）
+  void revoke(const common::SessionClaims &claims);
+
+  // 撤销该用户此刻之前签发的全部令牌（注销、角色变更）
+  void revokeUser(int userId);
+
+private:
+  // 清理已过期的撤销记录
+  void purge();
+
+  std::string secret_;
+  int64_t ttl_ = 86400;
+  std::atomic<uint64_t> nextTokenId_{0};
+
+  mutable std::shared_mutex mutex_;
+  // token_id -> 该令牌的过期时间
+  std::unordered_map<uint64_t, int64_t> revokedTokens_;
+  // user_id -> 撤销时刻，此时刻及之前签发的令牌无效
+  std::unordered_map<int, int64_t> revokedUsers_;
+  trantor::TimerId purgeTimer_{0};
+};
@@ -0,0 +1,90 @@
+#include "SlowQueryLog.h"
+#include <trantor/utils/Date.h>
+#include <trantor/utils/Logger.h>
+
+void SlowQueryLog::initAndStart(const Json::Value &config) {
+  thresholdMs_ = config.get("threshold_ms", 100.0).asDouble();
+  explainInterval_ =
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(
+              config.get("explain_interval", 60.0).asDouble()));
+  if (thresholdMs_ <= 0) {
+    return;
+  }
+
+  logger_ = std::make_unique<trantor::AsyncFileLogger>();
+  logger_->setFileName(config.get("file_name", "slow_query").asString(), ".log",
+                       config.get("log_path", "./").asString());
+  logger_->setFileSizeLimit(
+      config.get("size_limit", 100 * 1024 * 1024).asUInt64());
+  logger_->setMaxFiles(config.get("max_files", 10).asUInt());
+  logger_->startLogging();
+  LOG_INFO << "慢查询日志已开启，阈值 " << thresholdMs_ << " ms";
+}
+
+void SlowQueryLog::shutdown() {
+  if (logger_) {
+    logger_->flush();
+  }
+}
+
+bool SlowQueryLog::claimExplain(const dao::Statement &stmt) {
+  auto now = std::chrono::steady_clock::now();
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto [it, inserted] = lastExplained_.try_emplace(&stmt, now);
+  if (inserted) {
+    return true;
+  }
+  if (now - it->second < explainInterval_) {
+    return false;
+  }
+  it->second = now;
+  return true;
+}
+
+void SlowQueryLog::write(const dao::Statement &stmt, double elapsedMs,
+                         const std::string &params, const std::string &error,
+                         const drogon::orm::Result *explain,
+                         const std::string &explainError) {
+  if (!logger_) {
+    return;
+  }
+
+  std::string line = trantor::Date::now().toFormattedString(true);
+  line += " statement=";
+  line += stmt.name;
+  line += " elapsed_ms=";
+  line += std::to_string(elapsedMs);
+  line += " params=";
+  line += params;
+  if (!error.empty()) {
+    line += " error=";
+    line += error;
+  }
+  line += "\n  sql: ";
+  line += stmt.sql;
+  line += '\n';
+
+  // EXPLAIN 每行一条，按列名输出，NULL 列省略
+  if (explain != nullptr) {
+    for (const auto &row : *explain) {
+      line += "  explain:";
+      for (drogon::orm::Row::SizeType i = 0; i < row.size(); ++i) {
+        if (row[i].isNull()) {
+          continue;
+        }
+        line += ' ';
+        line += row[i].name();
+        line += '=';
+        line += row[i].as<std::string>();
+      }
+      line += '\n';
+    }
+  } else if (!explainError.empty()) {
+    line += "  explain failed: ";
+    line += explainError;
+    line += '\n';
+  }
+
+  logger_->output(line.data(), line.size());
+}
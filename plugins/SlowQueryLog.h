@@ -0,0 +1,54 @@
+#pragma once
+
+#include "dao/Statements.h"
+#include <drogon/orm/Result.h>
+#include <drogon/plugins/Plugin.h>
+#include <trantor/utils/AsyncFileLogger.h>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// 慢查询日志。
+// dao::exec 中耗时达到 threshold_ms 的查询，连同参数、耗时写入单独的日志文件；
+// 同时在执行它的客户端上以相同参数异步执行一次 EXPLAIN，结果附在记录后面。
+// 同一条语句在 explain_interval 秒内只 EXPLAIN 一次，避免慢查询集中时再加压。
+// 日志由 trantor::AsyncFileLogger 在后台线程写入，按大小滚动。
+//
+// 配置：
+//   "threshold_ms":     毫秒，默认 100；不大于 0 时关闭
+//   "log_path":         日志目录，默认 "./"
+//   "file_name":        文件名（不含扩展名），默认 "slow_query"
+//   "size_limit":       单个文件字节数上限，默认 100MB
+//   "max_files":        保留的历史文件数，默认 10
+//   "explain_interval": 秒，默认 60
+class SlowQueryLog : public drogon::Plugin<SlowQueryLog> {
+public:
+  SlowQueryLog() = default;
+  void initAndStart(const Json::Value &config) override;
+  void shutdown() override;
+
+  bool isSlow(double elapsedMs) const {
+    return thresholdMs_ > 0 && elapsedMs >= thresholdMs_;
+  }
+
+  // 该语句是否需要附带 EXPLAIN；返回 true 时同时记下本次时间
+  bool claimExplain(const dao::Statement &stmt);
+
+  // 写入一条慢查询记录；error 为空表示查询成功，explain 为空表示未附带
+  void write(const dao::Statement &stmt, double elapsedMs,
+             const std::string &params, const std::string &error,
+             const drogon::orm::Result *explain,
+             const std::string &explainError = {});
+
+private:
+  double thresholdMs_ = 100.0;
+  std::chrono::steady_clock::duration explainInterval_{};
+  std::unique_ptr<trantor::AsyncFileLogger> logger_;
+
+  std::mutex mutex_;
+  std::unordered_map<const dao::Statement *,
+                     std::chrono::steady_clock::time_point>
+      lastExplained_;
+};
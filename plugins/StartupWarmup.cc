@@ -0,0 +1,166 @@
+#include "StartupWarmup.h"
+#include "dao/Statements.h"
+#include "plugins/DbRouter.h"
+#include <drogon/HttpAppFramework.h>
+#include <drogon/HttpResponse.h>
+#include <drogon/orm/DbClient.h>
+#include <drogon/orm/Exception.h>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <utility>
+
+using namespace drogon;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 与 club_management_system.sql 保持一致
+constexpr const char *kTables[] = {
+    "activity_checkin", "activity_registration", "club",
+    "club_activity",    "club_approval",         "club_member",
+    "club_member_apply", "user",
+};
+
+// 标记就绪后第一个请求的开始时间
+constexpr const char *kFirstRequestKey = "warmup.first_request";
+
+Clock::time_point processStart{};
+
+double millisSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+// 并发预热时各回调共享的进度
+struct Progress {
+  std::mutex mutex;
+  size_t remaining;
+  std::vector<std::string> problems;
+};
+
+} // namespace
+
+void StartupWarmup::markProcessStart() { processStart = Clock::now(); }
+
+void StartupWarmup::initAndStart(const Json::Value &config) {
+  failFast_ = config.get("fail_fast", true).asBool();
+  initializedAt_ = Clock::now();
+  if (processStart == Clock::time_point{}) {
+    processStart = initializedAt_;
+  }
+
+  app().registerSyncAdvice([this](const HttpRequestPtr &req) -> HttpResponsePtr {
+    if (ready()) {
+      if (!firstRequestSeen_.load(std::memory_order_relaxed) &&
+          !firstRequestSeen_.exchange(true)) {
+        req->attributes()->insert(kFirstRequestKey, Clock::now());
+      }
+      return nullptr;
+    }
+
+    Json::Value response;
+    response["error"] = "服务正在启动，请稍后重试";
+    auto resp = HttpResponse::newHttpJsonResponse(response);
+    resp->setStatusCode(k503ServiceUnavailable);
+    resp->addHeader("Retry-After", "1");
+    return resp;
+  });
+
+  app().registerPostHandlingAdvice(
+      [](const HttpRequestPtr &req, const HttpResponsePtr &) {
+        auto attributes = req->attributes();
+        if (attributes->find(kFirstRequestKey)) {
+          LOG_INFO << "就绪后首个请求 " << req->methodString() << ' '
+                   << req->path() << " 耗时 "
+                   << millisSince(attributes->get<Clock::time_point>(
+                          kFirstRequestKey))
+                   << " ms";
+        }
+      });
+
+  // 事件循环启动、数据库客户端创建之后再开始
+  app().getLoop()->queueInLoop([this]() { explainAll(); });
+}
+
+void StartupWarmup::shutdown() {}
+
+void StartupWarmup::explainAll() {
+  // 主库预热全部语句，只读库只预热会路由过去的只读查询
+  std::vector<std::pair<orm::DbClientPtr, const dao::Statement *>> work;
+  auto primary = app().getDbClient();
+  auto reader = app().getPlugin<DbRouter>()->readClient();
+  for (const dao::Statement *stmt : dao::sql::kAll) {
+    work.emplace_back(primary, stmt);
+    if (reader && stmt->readOnly()) {
+      work.emplace_back(reader, stmt);
+    }
+  }
+
+  auto progress = std::make_shared<Progress>();
+  progress->remaining = work.size();
+
+  // 全部语句同时发出，连接池中每个连接都会被用到；
+  // 连接尚未建立时语句在客户端排队，连接就绪后执行
+  for (const auto &[db, stmt] : work) {
+    auto done = [this, progress](std::string problem) {
+      std::lock_guard<std::mutex> lock(progress->mutex);
+      if (!problem.empty()) {
+        progress->problems.push_back(std::move(problem));
+      }
+      if (--progress->remaining == 0) {
+        if (!progress->problems.empty()) {
+          finish(progress->problems);
+        } else {
+          verifyTables();
+        }
+      }
+    };
+    db->execSqlAsync(
+        dao::explainSql(stmt->sql),
+        [done](const orm::Result &) { done({}); },
+        [done, stmt](const orm::DrogonDbException &e) {
+          done(std::string("语句 ") + stmt->name + ": " + e.base().what());
+        });
+  }
+}
+
+void StartupWarmup::verifyTables() {
+  app().getDbClient()->execSqlAsync(
+      dao::sql::kSchemaTables.sql,
+      [this](const orm::Result &result) {
+        std::unordered_set<std::string> present;
+        for (const auto &row : result) {
+          present.insert(row["name"].as<std::string>());
+        }
+        std::vector<std::string> problems;
+        for (const char *table : kTables) {
+          if (present.count(table) == 0) {
+            problems.push_back(std::string("缺少表 ") + table);
+          }
+        }
+        finish(problems);
+      },
+      [this](const orm::DrogonDbException &e) {
+        finish({std::string("无法读取表结构: ") + e.base().what()});
+      });
+}
+
+void StartupWarmup::finish(const std::vector<std::string> &problems) {
+  for (const auto &problem : problems) {
+    LOG_ERROR << "启动预热: " << problem;
+  }
+  if (!problems.empty() && failFast_) {
+    LOG_FATAL << "启动预热失败，共 " << problems.size() << " 个问题，退出";
+    app().quit();
+    return;
+  }
+
+  ready_.store(true, std::memory_order_release);
+  LOG_INFO << "启动预热完成：" << std::size(dao::sql::kAll) << " 条语句，"
+           << std::size(kTables) << " 张表；预热耗时 "
+           << millisSince(initializedAt_) << " ms，冷启动耗时 "
+           << millisSince(processStart) << " ms";
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <drogon/plugins/Plugin.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// 启动预热。
+// 事件循环启动后并发地对 dao::sql::kAll 中的每条语句执行 EXPLAIN，
+// 让连接池中的连接全部建立并被使用一次，同时让服务端完成语句解析；
+// 配置了只读库时，只读查询在只读库上同样预热一遍；
+// 随后核对 club_management_system.sql 中的表是否都存在。
+// 预热完成前所有请求返回 503 和 Retry-After，完成后记录冷启动耗时，
+// 并记录就绪后第一个请求的处理耗时。
+// 配置：
+//   fail_fast  预热发现语句或表有问题时退出进程，默认 true；
+//              为 false 时只记录错误并照常就绪
+class StartupWarmup : public drogon::Plugin<StartupWarmup> {
+public:
+  StartupWarmup() = default;
+  void initAndStart(const Json::Value &config) override;
+  void shutdown() override;
+
+  // 在 main() 开头调用，冷启动耗时从这里算起；未调用时从插件初始化算起
+  static void markProcessStart();
+
+  bool ready() const { return ready_.load(std::memory_order_acquire); }
+
+private:
+  void explainAll();
+  void verifyTables();
+  void finish(const std::vector<std::string> &problems);
+
+  bool failFast_ = true;
+  std::atomic<bool> ready_{false};
+  std::atomic<bool> firstRequestSeen_{false};
+  std::chrono::steady_clock::time_point initializedAt_;
+};
@@ -0,0 +1,133 @@
+#include "plugins/ActivityCalendar.h"
+#include <drogon/drogon_test.h>
+
+namespace {
+
+struct Page {
+  std::string json;
+  size_t count;
+  bool more;
+};
+
+Page write(const CalendarDays &days, const std::string &from,
+           const std::string &to, size_t limit = 10,
+           const std::vector<int> &clubIds = {}) {
+  Page page;
+  page.count = days.write(from, to, clubIds, limit, page.json, page.more);
+  return page;
+}
+
+} // namespace
+
+DROGON_TEST(CalendarDayNumber) {
+  CHECK(ActivityCalendar::dayNumber("1970-01-01") == 0);
+  CHECK(ActivityCalendar::dayNumber("1970-01-02 08:00:00") == 1);
+  CHECK(ActivityCalendar::dayNumber("1969-12-31 23:59:59") == -1);
+  CHECK(ActivityCalendar::dayNumber("2000-01-01") == 10957);
+  // 闰年的二月有 29 天
+  CHECK(*ActivityCalendar::dayNumber("2024-03-01") -
+            *ActivityCalendar::dayNumber("2024-02-28") ==
+        2);
+  CHECK(*ActivityCalendar::dayNumber("2023-03-01") -
+            *ActivityCalendar::dayNumber("2023-02-28") ==
+        1);
+
+  CHECK(!ActivityCalendar::dayNumber(""));
+  CHECK(!ActivityCalendar::dayNumber("2025-05"));
+  CHECK(!ActivityCalendar::dayNumber("2025-5-01"));
+  CHECK(!ActivityCalendar::dayNumber("2025/05/01"));
+  CHECK(!ActivityCalendar::dayNumber("2025-13-01"));
+  CHECK(!ActivityCalendar::dayNumber("2025-00-10"));
+  CHECK(!ActivityCalendar::dayNumber("2025-05-32"));
+  CHECK(!ActivityCalendar::dayNumber("2025-05-00"));
+}
+
+DROGON_TEST(CalendarWriteRange) {
+  // 故意打乱顺序，构造时逐桶按时间排序
+  CalendarDays days({{"2025-05-04 00:00:00", 4, 1, "4"},
+                     {"2025-05-01 18:00:00", 2, 1, "2"},
+                     {"2025-05-02 10:00:00", 3, 1, "3"},
+                     {"2025-05-01 09:00:00", 1, 1, "1"},
+                     {"2025-04-30 23:59:59", 5, 1, "5"}});
+  auto page = write(days, "2025-05-01 00:00:00", "2025-05-03 00:00:00");
+  CHECK(page.json == "1,2,3");
+  CHECK(page.count == 3);
+  CHECK(!page.more);
+
+  // from 含、to 不含，按时间而不只是按天截断
+  page = write(days, "2025-05-01 18:00:00", "2025-05-04 00:00:00");
+  CHECK(page.json == "2,3");
+
+  page = write(days, "2025-04-01 00:00:00", "2025-06-01 00:00:00");
+  CHECK(page.json == "5,1,2,3,4");
+
+  page = write(days, "2025-06-01 00:00:00", "2025-07-01 00:00:00");
+  CHECK(page.json.empty());
+  CHECK(page.count == 0);
+
+  // 格式错误的边界不输出
+  page = write(days, "bad", "2025-07-01 00:00:00");
+  CHECK(page.count == 0);
+  CHECK(!page.more);
+}
+
+DROGON_TEST(CalendarWriteLimit) {
+  // 两天各两场
+  CalendarDays days({{"2025-05-01 09:00:00", 1, 1, "1"},
+                     {"2025-05-01 18:00:00", 2, 1, "2"},
+                     {"2025-05-02 09:00:00", 3, 1, "3"},
+                     {"2025-05-02 18:00:00", 4, 1, "4"}});
+  auto page = write(days, "2025-05-01 00:00:00", "2025-05-03 00:00:00", 3);
+  CHECK(page.json == "1,2,3");
+  CHECK(page.count == 3);
+  CHECK(page.more);
+
+  // 恰好取完时没有更多
+  page = write(days, "2025-05-01 00:00:00", "2025-05-03 00:00:00", 4);
+  CHECK(page.count == 4);
+  CHECK(!page.more);
+
+  // 范围外的下一条不算更多
+  page = write(days, "2025-05-01 00:00:00", "2025-05-02 00:00:00", 2);
+  CHECK(page.json == "1,2");
+  CHECK(!page.more);
+}
+
+DROGON_TEST(CalendarWriteClubs) {
+  // 社团 1 与社团 2 的活动交错
+  CalendarDays days({{"2025-05-01 09:00:00", 1, 1, "1"},
+                     {"2025-05-01 10:00:00", 2, 2, "2"},
+                     {"2025-05-01 11:00:00", 3, 1, "3"},
+                     {"2025-05-01 12:00:00", 4, 3, "4"},
+                     {"2025-05-02 09:00:00", 5, 1, "5"}});
+  auto page =
+      write(days, "2025-05-01 00:00:00", "2025-05-03 00:00:00", 10, {1, 3});
+  CHECK(page.json == "1,3,4,5");
+
+  // 被过滤掉的活动不计入 limit
+  page = write(days, "2025-05-01 00:00:00", "2025-05-03 00:00:00", 2, {1});
+  CHECK(page.json == "1,3");
+  CHECK(page.more);
+}
+
+DROGON_TEST(CalendarPlaceErase) {
+  CalendarDays days({{"2025-05-01 09:00:00", 1, 1, "1"},
+                     {"2025-05-01 18:00:00", 2, 1, "2"}});
+  days.erase(2);
+  days.erase(42); // 不在日历中
+  CHECK(write(days, "2025-05-01 00:00:00", "2025-05-03 00:00:00").json == "1");
+
+  // 改期：先移出再放入新的桶，同一桶内按时间插入
+  days.erase(1);
+  days.place({"2025-05-02 10:00:00", 1, 1, "1"});
+  days.place({"2025-05-02 08:00:00", 6, 1, "6"});
+  CHECK(write(days, "2025-05-01 00:00:00", "2025-05-02 00:00:00").json.empty());
+  CHECK(write(days, "2025-05-01 00:00:00", "2025-05-03 00:00:00").json ==
+        "6,1");
+
+  // 空日历
+  CalendarDays empty;
+  auto page = write(empty, "2025-05-01 00:00:00", "2025-05-03 00:00:00");
+  CHECK(page.count == 0);
+  CHECK(!page.more);
+}
@@ -0,0 +1,68 @@
+#include "plugins/CheckinPipeline.h"
+#include <drogon/drogon_test.h>
+
+DROGON_TEST(CheckinRosterReserveDedupes) {
+  CheckinRoster roster;
+  CHECK(roster.reserve(1, 7));
+  // 同一用户再次扫码不再占位
+  CHECK(!roster.reserve(1, 7));
+  // 查重按活动区分
+  CHECK(roster.reserve(2, 7));
+  CHECK(roster.reserve(1, 8));
+}
+
+DROGON_TEST(CheckinRosterReleaseAllowsRetry) {
+  CheckinRoster roster;
+  REQUIRE(roster.reserve(1, 7));
+  // 写入失败撤销占位，下一次签到重新占位
+  roster.release(1, 7);
+  CHECK(roster.reserve(1, 7));
+  CHECK(!roster.reserve(1, 7));
+
+  // 撤销不存在的占位不影响其他活动
+  roster.release(3, 7);
+  CHECK(!roster.loaded(3));
+}
+
+DROGON_TEST(CheckinRosterLoadKeepsReservations) {
+  CheckinRoster roster;
+  CHECK(!roster.loaded(1));
+
+  // 加载期间另一个请求已占位
+  REQUIRE(roster.reserve(1, 9));
+  roster.load(1, {7, 8, 9}, {7});
+  CHECK(roster.loaded(1));
+  CHECK(!roster.reserve(1, 9));
+  // 数据库中已签到的用户同样视为重复
+  CHECK(!roster.reserve(1, 7));
+  CHECK(roster.reserve(1, 8));
+}
+
+DROGON_TEST(CheckinRosterRegistered) {
+  CheckinRoster roster;
+  roster.load(1, {7}, {});
+  CHECK(roster.registered(1, 7));
+  CHECK(!roster.registered(1, 8));
+  CHECK(!roster.registered(2, 7));
+
+  // 加载之后才报名的用户经数据库确认后补入
+  roster.addRegistered(1, 8);
+  CHECK(roster.registered(1, 8));
+  CHECK(roster.loaded(1));
+}
+
+DROGON_TEST(CheckinRosterForget) {
+  CheckinRoster roster;
+  roster.load(1, {7}, {7});
+  roster.load(2, {7}, {});
+
+  // 活动被删除后丢弃其集合，下次签到重新加载
+  roster.forget(1);
+  CHECK(!roster.loaded(1));
+  CHECK(!roster.registered(1, 7));
+  CHECK(roster.reserve(1, 7));
+  CHECK(roster.loaded(2));
+
+  roster.clear();
+  CHECK(!roster.loaded(2));
+}
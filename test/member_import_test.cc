@@ -0,0 +1,103 @@
+#include "common/MemberImport.h"
+#include <drogon/drogon_test.h>
+
+DROGON_TEST(MemberImportCsv) {
+  std::vector<common::ImportRow> rows;
+  REQUIRE(common::parseCsv("User_ID,username\r\n"
+                           "17,\r\n"
+                           ",alice\r\n"
+                           "\r\n"
+                           "18,bob\r\n",
+                           rows));
+  REQUIRE(rows.size() == 3);
+
+  CHECK(rows[0].line == 2);
+  CHECK(rows[0].userId == 17);
+  CHECK(rows[0].status.empty());
+
+  CHECK(rows[1].line == 3);
+  CHECK(!rows[1].userId);
+  CHECK(rows[1].username == "alice");
+
+  // 空行跳过但计入行号；两列都有值时以 user_id 为准
+  CHECK(rows[2].line == 5);
+  CHECK(rows[2].userId == 18);
+  CHECK(rows[2].username.empty());
+}
+
+DROGON_TEST(MemberImportCsvQuoted) {
+  std::vector<common::ImportRow> rows;
+  REQUIRE(common::parseCsv("note,username\n"
+                           "\"a, b\",\" \"\"Ann\"\" \"\n",
+                           rows));
+  REQUIRE(rows.size() == 1);
+  // 引号内的逗号不切分，"" 转义为一个引号，字段首尾空白去掉
+  CHECK(rows[0].username == "\"Ann\"");
+}
+
+DROGON_TEST(MemberImportCsvInvalidRows) {
+  std::vector<common::ImportRow> rows;
+  REQUIRE(common::parseCsv("user_id\n0\nabc\n12x\n-3\n,\n", rows));
+  REQUIRE(rows.size() == 5);
+  for (size_t i = 0; i < 4; ++i) {
+    CHECK(rows[i].status == "invalid");
+    CHECK(rows[i].error == "user_id 不是有效的正整数");
+  }
+  CHECK(rows[4].status == "invalid");
+  CHECK(rows[4].error == "缺少 user_id 或 username");
+}
+
+DROGON_TEST(MemberImportCsvHeader) {
+  // 表头缺少 user_id 与 username 列
+  std::vector<common::ImportRow> rows;
+  CHECK(!common::parseCsv("id,name\n1,alice\n", rows));
+
+  // 只有表头时没有数据行
+  rows.clear();
+  CHECK(common::parseCsv("username\n", rows));
+  CHECK(rows.empty());
+}
+
+DROGON_TEST(MemberImportNdjson) {
+  std::vector<common::ImportRow> rows;
+  common::parseNdjson("{\"user_id\": 17}\n"
+                      "{\"username\": \"alice\", \"note\": [1, {\"x\": 2}]}\n"
+                      "\n"
+                      "{\"user_id\": 0}\n"
+                      "{\"user_id\": \"17\"}\n"
+                      "{\"user_id\": 17\n"
+                      "[17]\n",
+                      rows);
+  REQUIRE(rows.size() == 6);
+
+  CHECK(rows[0].line == 1);
+  CHECK(rows[0].userId == 17);
+
+  // 未知字段跳过
+  CHECK(rows[1].username == "alice");
+  CHECK(rows[1].status.empty());
+
+  CHECK(rows[2].line == 4);
+  CHECK(rows[2].error == "user_id 不是有效的正整数");
+
+  // 类型不对的字段同样跳过，于是缺少 user_id
+  CHECK(rows[3].error == "缺少 user_id 或 username");
+
+  CHECK(rows[4].error == "不是有效的 JSON 对象");
+  CHECK(rows[5].error == "不是有效的 JSON 对象");
+  for (size_t i = 2; i < rows.size(); ++i) {
+    CHECK(rows[i].status == "invalid");
+  }
+}
+
+DROGON_TEST(MemberImportFormat) {
+  // Content-Type 优先
+  CHECK(!common::isNdjson("text/csv", "{\"user_id\": 1}"));
+  CHECK(common::isNdjson("application/x-ndjson", "user_id\n1"));
+  CHECK(common::isNdjson("application/jsonl", ""));
+
+  // 否则看首个非空白字符
+  CHECK(common::isNdjson("", "  \n{\"user_id\": 1}"));
+  CHECK(!common::isNdjson("text/plain", "user_id\n1"));
+  CHECK(!common::isNdjson("", " \n "));
+}
@@ -0,0 +1,75 @@
+#include "dao/Pagination.h"
+#include <drogon/HttpRequest.h>
+#include <drogon/drogon_test.h>
+
+namespace {
+
+drogon::HttpRequestPtr pageRequest(
+    std::initializer_list<std::pair<std::string, std::string>> params) {
+  auto req = drogon::HttpRequest::newHttpRequest();
+  for (const auto &[key, value] : params) {
+    req->setParameter(key, value);
+  }
+  return req;
+}
+
+} // namespace
+
+DROGON_TEST(IdPageDefaults) {
+  dao::IdPage page{};
+  REQUIRE(dao::parseIdPage(pageRequest({}), page));
+  CHECK(page.afterId == 0);
+  CHECK(page.limit == 50);
+}
+
+DROGON_TEST(IdPageLimit) {
+  dao::IdPage page{};
+  REQUIRE(dao::parseIdPage(pageRequest({{"limit", "20"}}), page));
+  CHECK(page.limit == 20);
+
+  // 超过上限时截到 200
+  REQUIRE(dao::parseIdPage(pageRequest({{"limit", "5000"}}), page));
+  CHECK(page.limit == 200);
+
+  CHECK(!dao::parseIdPage(pageRequest({{"limit", "0"}}), page));
+  CHECK(!dao::parseIdPage(pageRequest({{"limit", "-3"}}), page));
+  CHECK(!dao::parseIdPage(pageRequest({{"limit", "10x"}}), page));
+}
+
+DROGON_TEST(IdPageAfterId) {
+  dao::IdPage page{};
+  REQUIRE(dao::parseIdPage(pageRequest({{"after_id", "42"}}), page));
+  CHECK(page.afterId == 42);
+
+  CHECK(!dao::parseIdPage(pageRequest({{"after_id", "-1"}}), page));
+  CHECK(!dao::parseIdPage(pageRequest({{"after_id", "abc"}}), page));
+  CHECK(!dao::parseIdPage(pageRequest({{"after_id", "7 "}}), page));
+}
+
+DROGON_TEST(IdPageCursor) {
+  dao::IdPage page{};
+  auto cursor = dao::encodeIdCursor(1234);
+  REQUIRE(dao::parseIdPage(pageRequest({{"cursor", cursor}}), page));
+  CHECK(page.afterId == 1234);
+
+  // cursor 优先于 after_id
+  REQUIRE(dao::parseIdPage(
+      pageRequest({{"cursor", cursor}, {"after_id", "5"}}), page));
+  CHECK(page.afterId == 1234);
+
+  CHECK(!dao::parseIdPage(pageRequest({{"cursor", "not-a-cursor"}}), page));
+}
+
+DROGON_TEST(IdPageNextCursorRow) {
+  dao::IdPage page{0, 10};
+  CHECK(dao::pageSize(0, page) == 0);
+  CHECK(dao::pageSize(10, page) == 10);
+  CHECK(dao::pageSize(11, page) == 10);
+
+  // 按 limit + 1 取数，多出的一行说明还有下一页
+  CHECK(!dao::nextCursorRow(0, page));
+  CHECK(!dao::nextCursorRow(10, page));
+  auto row = dao::nextCursorRow(11, page);
+  REQUIRE(row.has_value());
+  CHECK(*row == 9);
+}
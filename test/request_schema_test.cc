@@ -0,0 +1,127 @@
+#include "common/JsonScanner.h"
+#include "common/RequestSchema.h"
+#include <drogon/drogon_test.h>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+struct Signup {
+  std::string name;
+  int age = 0;
+  std::string role;
+  std::string note;
+};
+
+constexpr const char *kRoles[] = {"member", "leader"};
+
+// 解析失败时返回错误信息，成功时返回空串
+template <typename T> std::string parseError(std::string_view body) {
+  try {
+    common::parseRequest<T>(body);
+  } catch (const std::runtime_error &e) {
+    return e.what();
+  }
+  return {};
+}
+
+} // namespace
+
+template <> struct common::RequestSchema<Signup> {
+  static constexpr common::RequestField<Signup> fields[] = {
+      {.key = "name",
+       .text = &Signup::name,
+       .missing = "缺少必备字段: name",
+       .minLength = 2,
+       .tooShort = "名字过短"},
+      {.key = "age", .number = &Signup::age, .missing = "缺少必备字段: age"},
+      {.key = "role",
+       .text = &Signup::role,
+       .defaultText = "member",
+       .allowed = kRoles,
+       .notAllowed = "角色无效"},
+      {.key = "note", .text = &Signup::note},
+  };
+};
+
+DROGON_TEST(RequestSchemaParsesFields) {
+  auto signup = common::parseRequest<Signup>(
+      R"({"name":"张三","age":20,"role":"leader","note":"a\"b\\n中"})");
+  CHECK(signup.name == "张三");
+  CHECK(signup.age == 20);
+  CHECK(signup.role == "leader");
+  CHECK(signup.note == "a\"b\\n中");
+}
+
+DROGON_TEST(RequestSchemaUnknownFields) {
+  // 未知字段连同嵌套的对象、数组一起跳过
+  auto signup = common::parseRequest<Signup>(
+      R"({"extra":{"a":[1,{"b":null}],"c":"}"},"name":"ab","tags":[],"age":1})");
+  CHECK(signup.name == "ab");
+  CHECK(signup.age == 1);
+}
+
+DROGON_TEST(RequestSchemaMissingFields) {
+  CHECK(parseError<Signup>(R"({"age":1})") == "缺少必备字段: name");
+  CHECK(parseError<Signup>(R"({"name":"ab"})") == "缺少必备字段: age");
+  // 按字段表顺序报告第一个缺失的字段
+  CHECK(parseError<Signup>("{}") == "缺少必备字段: name");
+
+  // 可选字段缺失时取默认值
+  auto signup = common::parseRequest<Signup>(R"({"name":"ab","age":1})");
+  CHECK(signup.role == "member");
+  CHECK(signup.note.empty());
+}
+
+DROGON_TEST(RequestSchemaWrongTypes) {
+  CHECK(parseError<Signup>(R"({"name":["ab"],"age":1})") ==
+        "字段类型错误: name");
+  CHECK(parseError<Signup>(R"({"name":"ab","age":"1"})") ==
+        "字段类型错误: age");
+  CHECK(parseError<Signup>(R"({"name":"ab","age":{}})") ==
+        "字段类型错误: age");
+  CHECK(parseError<Signup>(R"({"name":"ab","age":3000000000})") ==
+        "字段超出范围: age");
+
+  // 与 jsoncpp 的 asString() / asInt() 一致的宽松转换
+  auto signup = common::parseRequest<Signup>(
+      R"({"name":12,"age":2.9,"note":null})");
+  CHECK(signup.name == "12");
+  CHECK(signup.age == 2);
+  CHECK(signup.note.empty());
+  signup = common::parseRequest<Signup>(R"({"name":true,"age":true})");
+  CHECK(signup.name == "true");
+  CHECK(signup.age == 1);
+}
+
+DROGON_TEST(RequestSchemaValidation) {
+  CHECK(parseError<Signup>(R"({"name":"a","age":1})") == "名字过短");
+  CHECK(parseError<Signup>(R"({"name":"ab","age":1,"role":"admin"})") ==
+        "角色无效");
+  // 重复的键以最后一次为准
+  auto signup =
+      common::parseRequest<Signup>(R"({"name":"a","name":"abc","age":1})");
+  CHECK(signup.name == "abc");
+}
+
+DROGON_TEST(RequestSchemaMalformed) {
+  const std::string kMalformed = "请求体格式错误，请使用 JSON";
+  CHECK(parseError<Signup>("") == kMalformed);
+  CHECK(parseError<Signup>("[]") == kMalformed);
+  CHECK(parseError<Signup>(R"({"name":"ab","age":1)") == kMalformed);
+  CHECK(parseError<Signup>(R"({"name":"ab","age":1,})") == kMalformed);
+  CHECK(parseError<Signup>(R"({"name":"ab","age":1} x)") == kMalformed);
+  CHECK(parseError<Signup>(R"({"name":"a\x","age":1})") == kMalformed);
+  CHECK(parseError<Signup>(R"({"name":"\ud800","age":1})") == kMalformed);
+}
+
+DROGON_TEST(JsonScannerSkipsNestedValues) {
+  common::JsonScanner scanner(R"( [ {"a": [1, -2.5e3, "x"]}, true, null ] )");
+  CHECK(scanner.peek() == common::JsonScanner::Type::Array);
+  scanner.skipValue();
+  scanner.finish();
+
+  common::JsonScanner trailing("1 2");
+  CHECK(trailing.readNumber() == "1");
+  CHECK_THROWS_AS(trailing.finish(), std::runtime_error);
+}
@@ -0,0 +1,107 @@
+#include "plugins/SearchIndex.h"
+#include <drogon/drogon_test.h>
+
+namespace {
+
+constexpr auto kClub = SearchDoc::Type::Club;
+constexpr auto kActivity = SearchDoc::Type::Activity;
+
+// 命中文档的 id，按结果顺序
+std::vector<int> search(const SearchSnapshot &snapshot, std::string_view query,
+                        const SearchDoc::Type *type = nullptr) {
+  size_t total = 0;
+  auto hits = snapshot.search(query, type, 10, total);
+  CHECK(total == hits.size());
+  std::vector<int> ids;
+  for (const auto &hit : hits) {
+    ids.push_back(hit.doc->id);
+  }
+  return ids;
+}
+
+} // namespace
+
+DROGON_TEST(SearchIndexBigrams) {
+  SearchSnapshot snapshot;
+  snapshot.add({kClub, 1, 1, "{}"}, "摄影社", "");
+  snapshot.add({kClub, 2, 2, "{}"}, "读书会", "偶尔也组织摄影展");
+
+  // 汉字串按二元组建索引，标题命中排在正文命中之前
+  CHECK(search(snapshot, "摄影") == (std::vector<int>{1, 2}));
+
+  // 查询中连续两字及以上只取二元组：相邻才算命中
+  CHECK(search(snapshot, "影社") == std::vector<int>{1});
+  CHECK(search(snapshot, "摄社").empty());
+  CHECK(search(snapshot, "摄影展") == std::vector<int>{2});
+}
+
+DROGON_TEST(SearchIndexUnigrams) {
+  SearchSnapshot snapshot;
+  snapshot.add({kClub, 2, 2, "{}"}, "读书会", "");
+  snapshot.add({kActivity, 10, 1, "{}"}, "讲座", "");
+
+  // 单字查询走单字词项
+  CHECK(search(snapshot, "书") == std::vector<int>{2});
+  CHECK(search(snapshot, "座") == std::vector<int>{10});
+  // 被分隔符隔开的单字各自成为词项
+  CHECK(search(snapshot, "书 座").empty());
+  CHECK(search(snapshot, "读 书") == std::vector<int>{2});
+}
+
+DROGON_TEST(SearchIndexAscii) {
+  SearchSnapshot snapshot;
+  snapshot.add({kClub, 1, 1, "{}"}, "Photo Walk", "");
+  snapshot.add({kActivity, 10, 1, "{}"}, "讲座", "讲解camera基础");
+
+  // ASCII 按词切分并转小写
+  CHECK(search(snapshot, "photo") == std::vector<int>{1});
+  CHECK(search(snapshot, "PHOTO") == std::vector<int>{1});
+  CHECK(search(snapshot, "Camera!") == std::vector<int>{10});
+  // 词要完整匹配
+  CHECK(search(snapshot, "cam").empty());
+  // 字母与汉字相接时在边界处切开
+  CHECK(search(snapshot, "讲解camera") == std::vector<int>{10});
+  // 只有分隔符的查询不匹配任何文档
+  CHECK(search(snapshot, " ,.!").empty());
+  CHECK(search(snapshot, "").empty());
+}
+
+DROGON_TEST(SearchIndexMatchesAllTerms) {
+  SearchSnapshot snapshot;
+  snapshot.add({kClub, 1, 1, "{}"}, "摄影社", "photo walk");
+  snapshot.add({kActivity, 10, 1, "{}"}, "摄影讲座", "camera basics");
+
+  CHECK(search(snapshot, "摄影 camera") == std::vector<int>{10});
+  CHECK(search(snapshot, "photo camera").empty());
+  // 任一词项不在索引中即无结果
+  CHECK(search(snapshot, "摄影 足球").empty());
+  // 重复的词项只算一次
+  CHECK(search(snapshot, "photo photo") == std::vector<int>{1});
+}
+
+DROGON_TEST(SearchIndexTypeAndLimit) {
+  SearchSnapshot snapshot;
+  snapshot.add({kClub, 1, 1, "{}"}, "摄影社", "");
+  snapshot.add({kActivity, 10, 1, "{}"}, "摄影讲座", "");
+  snapshot.add({kActivity, 11, 1, "{}"}, "摄影外拍", "");
+
+  auto activity = kActivity;
+  CHECK(search(snapshot, "摄影", &activity) == (std::vector<int>{10, 11}));
+
+  // total 是全部命中数，返回的条数受 limit 限制
+  size_t total = 0;
+  auto hits = snapshot.search("摄影", nullptr, 1, total);
+  CHECK(total == 3);
+  CHECK(hits.size() == 1);
+}
+
+DROGON_TEST(SearchIndexKeepsDocJson) {
+  // 结果项直接引用快照中预先序列化好的 json
+  SearchSnapshot snapshot;
+  snapshot.add({kClub, 7, 7, "{\"club_id\":7}"}, "围棋社", "");
+  size_t total = 0;
+  auto hits = snapshot.search("围棋", nullptr, 10, total);
+  REQUIRE(hits.size() == 1);
+  CHECK(hits[0].doc->type == kClub);
+  CHECK(hits[0].doc->json == "{\"club_id\":7}");
+}
@@ -0,0 +1,129 @@
+#include "plugins/SeatLedger.h"
+#include <drogon/drogon_test.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using Placement = SeatLedger::Placement;
+
+DROGON_TEST(SeatLedgerSeatsThenWaitlist) {
+  SeatLedger::Counters seats(2, 1, 0, 0);
+  CHECK(seats.place() == Placement::Seat);
+  CHECK(seats.place() == Placement::Seat);
+  CHECK(seats.place() == Placement::Waitlist);
+  CHECK(seats.place() == Placement::Full);
+  CHECK(seats.seats() == 2);
+  CHECK(seats.waiting() == 1);
+
+  // 空出的名额可以再占，候补位同理
+  seats.releaseSeat();
+  CHECK(seats.place() == Placement::Seat);
+  seats.leaveWaitlist();
+  CHECK(seats.place() == Placement::Waitlist);
+  CHECK(seats.place() == Placement::Full);
+}
+
+DROGON_TEST(SeatLedgerStartsFromLoadedCounts) {
+  // 已占满名额、没有候补
+  SeatLedger::Counters seats(3, 0, 3, 0);
+  CHECK(seats.place() == Placement::Full);
+  CHECK(!seats.takeSeat());
+  seats.releaseSeat(2);
+  CHECK(seats.seats() == 1);
+  CHECK(seats.takeSeat());
+  CHECK(seats.seats() == 2);
+}
+
+DROGON_TEST(SeatLedgerUnlimited) {
+  SeatLedger::Counters seats(0, 0, 500, 0);
+  for (int i = 0; i < 100; ++i) {
+    CHECK(seats.place() == Placement::Seat);
+  }
+  CHECK(seats.seats() == 600);
+  CHECK(seats.waiting() == 0);
+}
+
+DROGON_TEST(SeatLedgerTakeSeatSkipsWaitlist) {
+  SeatLedger::Counters seats(1, 5, 1, 0);
+  CHECK(!seats.takeSeat());
+  CHECK(seats.waiting() == 0);
+}
+
+DROGON_TEST(SeatLedgerConcurrentPlace) {
+  SeatLedger::Counters seats(50, 20, 0, 0);
+  std::atomic<int> seated{0};
+  std::atomic<int> waitlisted{0};
+  std::atomic<int> full{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < 25; ++i) {
+        switch (seats.place()) {
+        case Placement::Seat:
+          ++seated;
+          break;
+        case Placement::Waitlist:
+          ++waitlisted;
+          break;
+        case Placement::Full:
+          ++full;
+          break;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  CHECK(seated == 50);
+  CHECK(waitlisted == 20);
+  CHECK(full == 130);
+  CHECK(seats.seats() == 50);
+  CHECK(seats.waiting() == 20);
+}
+
+DROGON_TEST(SeatLedgerClaim) {
+  SeatLedger::Counters seats(10, 0, 0, 0);
+
+  // 首次报名占位，占位期间的重复报名看到 pending
+  CHECK(!seats.claim(7));
+  auto again = seats.claim(7);
+  REQUIRE(again);
+  CHECK(*again == "pending");
+
+  seats.setStatus(7, "waitlist");
+  again = seats.claim(7);
+  REQUIRE(again);
+  CHECK(*again == "waitlist");
+
+  // 取消后可以重新报名
+  seats.setStatus(7, "cancel");
+  CHECK(!seats.claim(7));
+
+  // 写入失败撤销占位，下一次报名重新占位
+  seats.unclaim(7);
+  CHECK(!seats.claim(7));
+
+  // 被拒绝的用户一直被拦下
+  seats.setStatus(8, "rejected");
+  again = seats.claim(8);
+  REQUIRE(again);
+  CHECK(*again == "rejected");
+}
+
+DROGON_TEST(SeatLedgerConcurrentClaim) {
+  SeatLedger::Counters seats(10, 0, 0, 0);
+  std::atomic<int> claimed{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&]() {
+      if (!seats.claim(42)) {
+        ++claimed;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  CHECK(claimed == 1);
+}
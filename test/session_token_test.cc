@@ -0,0 +1,79 @@
+#include "common/SessionToken.h"
+#include <drogon/drogon_test.h>
+
+namespace {
+
+const std::string kSecret = "test-secret";
+
+// 把 pos 处的 base64url 字符换成另一个合法字符
+std::string flipAt(std::string token, size_t pos) {
+  token[pos] = token[pos] == 'A' ? 'B' : 'A';
+  return token;
+}
+
+} // namespace
+
+DROGON_TEST(SessionTokenRoundTrip) {
+  // 载荷中的每个字段都原样解出，包括多字节的角色名与 64 位的时间、id
+  common::SessionClaims issued{.userId = 17,
+                               .userType = "社长",
+                               .issuedAt = 1700000000000000,
+                               .expiresAt = 1700086400000000,
+                               .tokenId = 9876543210};
+  auto token = common::signSessionToken(issued, kSecret);
+
+  common::SessionClaims claims;
+  REQUIRE(common::verifySessionToken(token, kSecret, claims));
+  CHECK(claims.userId == 17);
+  CHECK(claims.userType == "社长");
+  CHECK(claims.issuedAt == 1700000000000000);
+  CHECK(claims.expiresAt == 1700086400000000);
+  CHECK(claims.tokenId == 9876543210u);
+}
+
+DROGON_TEST(SessionTokenWrongSecret) {
+  auto token = common::signSessionToken(
+      {.userId = 3, .userType = "社员", .expiresAt = 1, .tokenId = 1},
+      kSecret);
+  common::SessionClaims claims;
+  CHECK(!common::verifySessionToken(token, "other-secret", claims));
+  CHECK(common::verifySessionToken(token, kSecret, claims));
+}
+
+DROGON_TEST(SessionTokenTampered) {
+  auto token = common::signSessionToken(
+      {.userId = 17, .userType = "社员", .expiresAt = 1, .tokenId = 5},
+      kSecret);
+  auto dot = token.find('.');
+  REQUIRE(dot != std::string::npos);
+  common::SessionClaims claims;
+
+  // 改动载荷或签名中的任一字符都无法通过校验
+  CHECK(!common::verifySessionToken(flipAt(token, 0), kSecret, claims));
+  CHECK(!common::verifySessionToken(flipAt(token, dot - 1), kSecret, claims));
+  CHECK(!common::verifySessionToken(flipAt(token, dot + 1), kSecret, claims));
+
+  // 换上另一枚令牌的签名：只有 user_id 不同，把自己提升成别人
+  auto otherToken = common::signSessionToken(
+      {.userId = 18, .userType = "社员", .expiresAt = 1, .tokenId = 5},
+      kSecret);
+  auto spliced =
+      token.substr(0, dot) + otherToken.substr(otherToken.find('.'));
+  CHECK(!common::verifySessionToken(spliced, kSecret, claims));
+
+  // 截短签名
+  CHECK(!common::verifySessionToken(token.substr(0, token.size() - 2),
+                                    kSecret, claims));
+}
+
+DROGON_TEST(SessionTokenMalformed) {
+  common::SessionClaims claims;
+  CHECK(!common::verifySessionToken("", kSecret, claims));
+  CHECK(!common::verifySessionToken("no-dot", kSecret, claims));
+  CHECK(!common::verifySessionToken(".signature", kSecret, claims));
+
+  // 签名正确但载荷缺少角色时同样拒绝
+  auto token = common::signSessionToken(
+      {.userId = 17, .userType = {}, .expiresAt = 1, .tokenId = 5}, kSecret);
+  CHECK(!common::verifySessionToken(token, kSecret, claims));
+}